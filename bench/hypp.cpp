@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hypp.hpp>
+
+namespace {
+
+template <typename Function>
+double measure(const Function& function) {
+  const auto begin = std::chrono::steady_clock::now();
+  function();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count();
+}
+
+void report(const char* name, const double seconds, const size_t count) {
+  std::cout << name << ": " << seconds * 1000 << " ms ("
+            << count / seconds / 1e6 << " M/s)\n";
+}
+
+std::vector<hypp::Uri> make_uri_corpus(const size_t count) {
+  constexpr const char* hosts[] = {
+      "www.example.com", "WWW.Example.COM", "cdn.example.net:80",
+      "api.example.org:8080", "[2001:db8::7]",
+  };
+  constexpr const char* paths[] = {
+      "/", "/index.html", "/a/b/../c/./d", "/%7euser/profile",
+      "/search", "/static/js/app.min.js", "",
+  };
+
+  std::vector<hypp::Uri> uris;
+  uris.reserve(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    const auto text = std::string{i % 3 ? "http://" : "HTTP://"} +
+        hosts[i % 5] + paths[i % 7] + "?id=" + std::to_string(i) +
+        (i % 2 ? "&q=%7e" : "&q=%2F");
+    hypp::Parser parser{text};
+    if (const auto expected = hypp::ParseUri(parser)) {
+      uris.push_back(expected.value());
+    }
+  }
+
+  return uris;
+}
+
+void bench_uri_hashing() {
+  const auto uris = make_uri_corpus(1000000);
+  std::uint64_t checksum = 0;
+
+  const auto normalize_then_hash = measure([&] {
+    std::string normalized;
+    for (const auto& uri : uris) {
+      hypp::Normalize(uri, normalized);
+      checksum ^= hypp::detail::Hash(normalized);
+    }
+  });
+  const auto hash_normalized = measure([&] {
+    for (const auto& uri : uris) {
+      checksum ^= hypp::HashNormalized(uri);
+    }
+  });
+
+  report("Normalize + Hash", normalize_then_hash, uris.size());
+  report("HashNormalized", hash_normalized, uris.size());
+  // Both passes hash the same strings, so the checksum cancels out
+  std::cout << "Checksum: " << checksum << '\n';
+}
+
+void bench_trusted_parsing() {
+  constexpr auto request =
+      "GET /static/js/app.min.js?v=20200101 HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:78.0) Gecko/20100101\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+      "Accept-Language: en-US,en;q=0.5\r\n"
+      "Accept-Encoding: gzip, deflate, br\r\n"
+      "Connection: keep-alive\r\n"
+      "Cookie: session=0123456789abcdef0123456789abcdef\r\n"
+      "\r\n";
+  constexpr size_t kCount = 200000;
+  size_t fields = 0;
+
+  const auto parse = [&](const hypp::Validation validation) {
+    return measure([&] {
+      for (size_t i = 0; i < kCount; ++i) {
+        fields += hypp::ParseRequest(request, validation)
+                      .value().header_fields.size();
+      }
+    });
+  };
+
+  report("ParseRequest (strict)", parse(hypp::Validation::Strict), kCount);
+  report("ParseRequest (trusted)", parse(hypp::Validation::Trusted), kCount);
+  std::cout << "Fields: " << fields << '\n';
+}
+
+// Bytes on the heap, assuming 16 bytes of allocator overhead per block and a
+// small string buffer of 15 characters
+size_t heap_size(const std::string& str) {
+  return str.capacity() > 15 ? str.capacity() + 1 + 16 : 0;
+}
+
+size_t heap_size(const hypp::Response& response) {
+  size_t size = sizeof(hypp::Response) + 16 +
+                response.header_fields.capacity() * sizeof(hypp::HeaderField) +
+                16 + heap_size(response.body);
+  for (const auto& header_field : response.header_fields) {
+    size += heap_size(header_field.name) + heap_size(header_field.value);
+  }
+  return size;
+}
+
+void bench_compact_message() {
+  constexpr auto response =
+      "HTTP/1.1 200 OK\r\n"
+      "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+      "Server: Apache/2.4.41 (Ubuntu)\r\n"
+      "Last-Modified: Sat, 05 Nov 1994 12:00:00 GMT\r\n"
+      "ETag: \"5d8-5b5f0a3c2e1c0\"\r\n"
+      "Accept-Ranges: bytes\r\n"
+      "Content-Length: 0\r\n"
+      "Vary: Accept-Encoding\r\n"
+      "Cache-Control: public, max-age=3600\r\n"
+      "Content-Type: text/html; charset=UTF-8\r\n"
+      "X-Request-Id: 0123456789abcdef\r\n"
+      "\r\n";
+  constexpr size_t kCount = 100000;
+
+  const auto parsed = hypp::ParseResponse(response).value();
+  const auto compact = hypp::Compact(parsed).value();
+  std::cout << "Response: " << heap_size(parsed) << " bytes, compact: "
+            << compact.size() + sizeof(hypp::CompactMessage) + 16
+            << " bytes\n";
+
+  size_t size = 0;
+  report("Compact", measure([&] {
+    for (size_t i = 0; i < kCount; ++i) {
+      size += hypp::Compact(parsed).value().size();
+    }
+  }), kCount);
+  report("to_response", measure([&] {
+    for (size_t i = 0; i < kCount; ++i) {
+      size += hypp::to_response(compact.view()).header_fields.size();
+    }
+  }), kCount);
+  std::cout << "Size: " << size << '\n';
+}
+
+void bench_message_editor() {
+  const std::string request =
+      "GET http://www.example.com/index.html?page=1 HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Firefox/115.0\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+      "Accept-Language: en-US,en;q=0.5\r\n"
+      "Accept-Encoding: gzip, deflate, br\r\n"
+      "Connection: keep-alive\r\n"
+      "Keep-Alive: timeout=5\r\n"
+      "Cookie: session=0123456789abcdef0123456789abcdef\r\n"
+      "Upgrade-Insecure-Requests: 1\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n";
+  constexpr size_t kCount = 100000;
+
+  size_t size = 0;
+  report("Parse and serialize", measure([&] {
+    for (size_t i = 0; i < kCount; ++i) {
+      auto parsed = hypp::ParseRequest(request).value();
+      auto& fields = parsed.header_fields;
+      fields.erase(std::remove_if(fields.begin(), fields.end(),
+          [](const hypp::HeaderField& field) {
+            return field.id == hypp::header::kConnection ||
+                   field.id == hypp::header::kKeep_Alive;
+          }), fields.end());
+      fields.push_back({"Via", "1.1 hypp"});
+      size += hypp::to_string(parsed).size();
+    }
+  }), kCount);
+  report("MessageEditor", measure([&] {
+    for (size_t i = 0; i < kCount; ++i) {
+      hypp::MessageEditor editor{request};
+      editor.remove_hop_by_hop();
+      editor.add("Via", "1.1 hypp");
+      size += hypp::BufferSize(editor.buffers());
+    }
+  }), kCount);
+  std::cout << "Size: " << size << '\n';
+}
+
+void bench_buffer_chain() {
+  std::string request =
+      "GET /search?q=hypp&page=1 HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Firefox/115.0\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+      "Accept-Language: en-US,en;q=0.5\r\n"
+      "Cookie: session=0123456789abcdef0123456789abcdef\r\n"
+      "Content-Length: 4096\r\n"
+      "\r\n";
+  request.append(4096, 'x');
+  constexpr size_t kCount = 100000;
+  constexpr size_t kSlabSize = 256;
+
+  hypp::ConstBuffers slabs;
+  for (size_t i = 0; i < request.size(); i += kSlabSize) {
+    slabs.push_back({request.data() + i,
+                     std::min(kSlabSize, request.size() - i)});
+  }
+
+  size_t size = 0;
+  report("Linearize and parse", measure([&] {
+    for (size_t i = 0; i < kCount; ++i) {
+      const auto linear = hypp::to_string(slabs);
+      size += hypp::ParseRequest(linear).value().header_fields.size();
+    }
+  }), kCount);
+  report("Parse buffer chain", measure([&] {
+    for (size_t i = 0; i < kCount; ++i) {
+      size += hypp::ParseRequest(slabs).value().header_fields.size();
+    }
+  }), kCount);
+  std::cout << "Size: " << size << '\n';
+}
+
+void bench_input_buffer() {
+  const std::string request =
+      "GET /search?q=hypp&page=1 HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Firefox/115.0\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n";
+  constexpr size_t kCount = 100000;
+  constexpr size_t kReadSize = 4096;
+  std::string stream;
+  for (size_t i = 0; i < kCount; ++i) {
+    stream += request;
+  }
+
+  size_t size = 0;
+  report("Append, parse and compact", measure([&] {
+    std::string input;
+    for (size_t pos = 0; pos < stream.size(); pos += kReadSize) {
+      input.append(stream, pos, kReadSize);
+      size_t end;
+      while ((end = input.find("\r\n\r\n")) != input.npos) {
+        size += hypp::ParseRequest(std::string_view{input}.substr(0, end + 4))
+                    .value().header_fields.size();
+        input.erase(0, end + 4);
+      }
+    }
+  }), kCount);
+  report("InputBuffer", measure([&] {
+    hypp::InputBuffer input;
+    for (size_t pos = 0; pos < stream.size(); pos += kReadSize) {
+      const auto buffer = input.prepare();
+      const auto n = std::min({buffer.size, kReadSize, stream.size() - pos});
+      std::memcpy(buffer.data, stream.data() + pos, n);
+      input.commit(n);
+      pos -= kReadSize - n;
+      while (const auto lease = input.next<hypp::Request>()) {
+        const auto view = lease->contiguous();
+        const auto parsed = view ? hypp::ParseRequest(*view) :
+                                   hypp::ParseRequest(lease->buffers());
+        size += parsed.value().header_fields.size();
+      }
+    }
+  }), kCount);
+  std::cout << "Size: " << size << '\n';
+}
+
+#if defined(__cpp_impl_coroutine)
+// A source that suspends on every read, and is resumed from a run queue, like
+// a socket that is driven by an event loop
+class QueuedSource {
+public:
+  QueuedSource(std::deque<std::coroutine_handle<>>& queue,
+               const std::string_view data, const size_t read_size)
+      : queue_{queue}, data_{data}, read_size_{read_size} {}
+
+  auto read(const hypp::MutableBuffer buffer) {
+    struct Awaiter {
+      QueuedSource& source;
+      hypp::MutableBuffer buffer;
+
+      bool await_ready() const noexcept {
+        return false;
+      }
+      void await_suspend(const std::coroutine_handle<> handle) {
+        source.queue_.push_back(handle);
+      }
+      size_t await_resume() {
+        auto& data = source.data_;
+        const auto size = std::min({buffer.size, source.read_size_,
+                                    data.size()});
+        std::memcpy(buffer.data, data.data(), size);
+        data.remove_prefix(size);
+        return size;
+      }
+    };
+    return Awaiter{*this, buffer};
+  }
+
+private:
+  std::deque<std::coroutine_handle<>>& queue_;
+  std::string_view data_;
+  size_t read_size_;
+};
+
+void bench_async_read() {
+  const std::string response =
+      "HTTP/1.1 200 OK\r\n"
+      "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+      "Server: Apache/2.4.41 (Ubuntu)\r\n"
+      "Content-Type: text/html; charset=UTF-8\r\n"
+      "Content-Length: 1024\r\n"
+      "\r\n" + std::string(1024, 'x');
+  constexpr size_t kStreams = 10000;
+  constexpr size_t kReadSize = 256;
+
+  std::deque<std::coroutine_handle<>> queue;
+  std::vector<QueuedSource> sources;
+  std::vector<hypp::Task<hypp::Expected<hypp::Response>>> tasks;
+  sources.reserve(kStreams);
+  tasks.reserve(kStreams);
+
+  // All streams are in flight at once on the calling thread, so the result is
+  // per core
+  size_t size = 0;
+  const auto seconds = measure([&] {
+    for (size_t i = 0; i < kStreams; ++i) {
+      sources.emplace_back(queue, response, kReadSize);
+      tasks.push_back(hypp::AsyncReadResponse(sources.back()));
+      tasks.back().start();
+    }
+    while (!queue.empty()) {
+      const auto handle = queue.front();
+      queue.pop_front();
+      handle.resume();
+    }
+    for (auto& task : tasks) {
+      size += task.get().value().body.size();
+    }
+  });
+  std::cout << "Concurrent streams: " << seconds * 1000 << " ms ("
+            << kStreams << " streams per core, "
+            << kStreams / seconds << " streams/s per core)\n";
+  std::cout << "Size: " << size << '\n';
+}
+#endif
+
+void bench_chunked_encoder() {
+  constexpr size_t kCount = 1000000;
+  const std::string record = "{\"id\":12345,\"ok\":true}\n";
+
+  size_t size = 0;
+  report("Chunk per write", measure([&] {
+    hypp::ChunkedEncoder encoder;
+    for (size_t i = 0; i < kCount; ++i) {
+      encoder.write(record);
+      encoder.flush();
+      if (encoder.size() >= 64 * 1024) {
+        size += hypp::BufferSize(encoder.buffers());
+        encoder.clear();
+      }
+    }
+    encoder.finish();
+    size += hypp::BufferSize(encoder.buffers());
+  }), kCount);
+  report("Batched chunks", measure([&] {
+    hypp::ChunkedEncoder encoder;
+    for (size_t i = 0; i < kCount; ++i) {
+      encoder.write(record);
+      if (encoder.size() >= 64 * 1024) {
+        size += hypp::BufferSize(encoder.buffers());
+        encoder.clear();
+      }
+    }
+    encoder.finish();
+    size += hypp::BufferSize(encoder.buffers());
+  }), kCount);
+  std::cout << "Size: " << size << '\n';
+}
+
+void bench_message_batch() {
+  constexpr size_t kCount = 100;
+  constexpr size_t kRepeat = 10000;
+
+  std::vector<hypp::Request> requests;
+  for (size_t i = 0; i < kCount; ++i) {
+    const auto request = hypp::ParseRequest(
+        "GET /items/" + std::to_string(i) + " HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "User-Agent: hypp\r\n"
+        "Accept: application/json\r\n"
+        "Accept-Encoding: gzip, deflate\r\n"
+        "Authorization: Bearer 0123456789abcdef\r\n"
+        "\r\n");
+    requests.push_back(request.value());
+  }
+
+  size_t size = 0;
+  report("Concatenated to_string", measure([&] {
+    for (size_t n = 0; n < kRepeat; ++n) {
+      std::string output;
+      for (const auto& request : requests) {
+        output += hypp::to_string(request);
+      }
+      size += output.size();
+    }
+  }), kCount * kRepeat);
+  report("Message batch", measure([&] {
+    for (size_t n = 0; n < kRepeat; ++n) {
+      hypp::RequestBatch batch;
+      for (const auto& request : requests) {
+        batch.add(request);
+      }
+      size += batch.to_string().size();
+    }
+  }), kCount * kRepeat);
+  std::cout << "Size: " << size << '\n';
+}
+
+}  // namespace
+
+int main() {
+  bench_uri_hashing();
+  bench_trusted_parsing();
+  bench_compact_message();
+  bench_message_editor();
+  bench_buffer_chain();
+  bench_input_buffer();
+#if defined(__cpp_impl_coroutine)
+  bench_async_read();
+#endif
+  bench_chunked_encoder();
+  bench_message_batch();
+  return 0;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <hypp/generator/batch.hpp>
+#include <hypp/generator/chunked.hpp>
+#include <hypp/generator/editor.hpp>
 #include <hypp/generator/header.hpp>
 #include <hypp/generator/message.hpp>
 #include <hypp/generator/request.hpp>
@@ -8,20 +11,42 @@
 #include <hypp/generator/uri.hpp>
 #include <hypp/generator/version.hpp>
 
+#include <hypp/parser/batch.hpp>
+#include <hypp/parser/bulk.hpp>
+#include <hypp/parser/cache_control.hpp>
+#include <hypp/parser/chain.hpp>
+#include <hypp/parser/date.hpp>
+#include <hypp/parser/framing.hpp>
 #include <hypp/parser/header.hpp>
+#include <hypp/parser/list.hpp>
+#include <hypp/parser/media_type.hpp>
 #include <hypp/parser/message.hpp>
 #include <hypp/parser/method.hpp>
+#include <hypp/parser/negotiation.hpp>
+#include <hypp/parser/query.hpp>
 #include <hypp/parser/request.hpp>
 #include <hypp/parser/response.hpp>
 #include <hypp/parser/status.hpp>
+#include <hypp/parser/trusted.hpp>
 #include <hypp/parser/uri.hpp>
 #include <hypp/parser/version.hpp>
 
+#include <hypp/async.hpp>
+#include <hypp/batch.hpp>
+#include <hypp/body.hpp>
+#include <hypp/buffer.hpp>
+#include <hypp/cache.hpp>
+#include <hypp/compact.hpp>
 #include <hypp/header.hpp>
+#include <hypp/input.hpp>
+#include <hypp/media_type.hpp>
 #include <hypp/message.hpp>
 #include <hypp/method.hpp>
+#include <hypp/observer.hpp>
 #include <hypp/request.hpp>
 #include <hypp/response.hpp>
+#include <hypp/snapshot.hpp>
+#include <hypp/statistics.hpp>
 #include <hypp/status.hpp>
 #include <hypp/uri.hpp>
 #include <hypp/version.hpp>
@@ -0,0 +1,373 @@
+#pragma once
+
+// Coroutines require C++20. This header is empty otherwise.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <algorithm>
+#if defined(__cpp_concepts)
+#include <concepts>
+#endif
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <hypp/parser/chain.hpp>
+#include <hypp/error.hpp>
+#include <hypp/input.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+
+namespace hypp {
+
+// A coroutine that produces a value of type T. It starts when it is awaited
+// (or started with start()), and resumes the awaiting coroutine when it is
+// done, without going through a scheduler.
+template <typename T>
+class Task {
+public:
+  struct promise_type {
+    std::optional<T> value;
+    std::exception_ptr exception;
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    Task get_return_object() {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+    auto final_suspend() noexcept {
+      struct Awaiter {
+        bool await_ready() noexcept {
+          return false;
+        }
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<promise_type> handle) noexcept {
+          return handle.promise().continuation;
+        }
+        void await_resume() noexcept {}
+      };
+      return Awaiter{};
+    }
+
+    template <typename U>
+    void return_value(U&& value) {
+      this->value.emplace(std::forward<U>(value));
+    }
+    void unhandled_exception() {
+      exception = std::current_exception();
+    }
+  };
+
+  Task(Task&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Task() {
+    destroy();
+  }
+
+  bool done() const {
+    return !handle_ || handle_.done();
+  }
+
+  // Runs the coroutine until it first suspends, for callers that are not
+  // coroutines themselves.
+  void start() {
+    if (!done()) {
+      handle_.resume();
+    }
+  }
+
+  // Returns the result. The task must be done.
+  T get() {
+    auto& promise = handle_.promise();
+    if (promise.exception) {
+      std::rethrow_exception(promise.exception);
+    }
+    return std::move(*promise.value);
+  }
+
+  bool await_ready() const noexcept {
+    return done();
+  }
+  std::coroutine_handle<> await_suspend(
+      const std::coroutine_handle<> awaiter) noexcept {
+    handle_.promise().continuation = awaiter;
+    return handle_;
+  }
+  T await_resume() {
+    return get();
+  }
+
+private:
+  explicit Task(const std::coroutine_handle<promise_type> handle)
+      : handle_{handle} {}
+
+  void destroy() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = {};
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// A source of bytes, e.g. a socket, has a member function
+//
+//   Awaitable read(MutableBuffer buffer);
+//
+// that reads up to `buffer.size` bytes into `buffer`, and resumes with the
+// number of bytes that were read, or 0 at the end of the stream.
+//
+// The read functions below require it, where concepts are supported.
+#if defined(__cpp_concepts)
+template <typename Source>
+concept ByteSource = requires(Source& source, const MutableBuffer buffer) {
+  { source.read(buffer).await_resume() } -> std::convertible_to<size_t>;
+};
+#define HYPP_BYTE_SOURCE ByteSource
+#else
+#define HYPP_BYTE_SOURCE typename
+#endif
+
+// An awaitable that is always ready with a value.
+template <typename T>
+struct ReadyAwaitable {
+  T value;
+
+  bool await_ready() const noexcept {
+    return true;
+  }
+  void await_suspend(std::coroutine_handle<>) const noexcept {}
+  T await_resume() const noexcept {
+    return value;
+  }
+};
+
+// A source that reads from memory, at most `read_size` bytes at a time. It
+// never suspends, which makes it useful for tests.
+class MemorySource {
+public:
+  explicit MemorySource(const std::string_view data,
+                        const size_t read_size = std::string_view::npos)
+      : data_{data}, read_size_{std::max<size_t>(read_size, 1)} {}
+
+  ReadyAwaitable<size_t> read(const MutableBuffer buffer) {
+    const auto size = std::min({buffer.size, read_size_, data_.size()});
+    std::memcpy(buffer.data, data_.data(), size);
+    data_.remove_prefix(size);
+    return {size};
+  }
+
+  bool empty() const {
+    return data_.empty();
+  }
+
+private:
+  std::string_view data_;
+  size_t read_size_;
+};
+
+namespace detail {
+
+// Passes the first `size` bytes of `buffers` to `sink`.
+template <typename Sink>
+bool WriteBuffers(Sink& sink, const ConstBuffers& buffers, size_t size) {
+  for (const auto& buffer : buffers) {
+    if (!size) {
+      break;
+    }
+    const auto view = buffer.view().substr(0, size);
+    if (!sink.write(view)) {
+      return false;
+    }
+    size -= view.size();
+  }
+  return true;
+}
+
+// Keeps a request method from being taken for a sink.
+template <typename Sink>
+using enable_if_sink_t =
+    std::enable_if_t<!std::is_convertible_v<Sink&, std::string_view>>;
+
+}  // namespace detail
+
+// Reads the next message from `source` into `input`, and parses it once it is
+// complete. Data that follows the message stays in `input` for the next call,
+// so the same input buffer should be used for the lifetime of the connection.
+//
+// For a response, `request_method` is the method of the request that it
+// answers. Responses to HEAD, and 2xx responses to CONNECT, have no body even
+// if their header fields describe one. The method is not copied, and must stay
+// valid until the task is done.
+//
+// If the connection is closed before any byte of the message has arrived, the
+// error is Connection_Closed, which is how a peer normally ends a persistent
+// connection. A connection that is closed in the middle of a message is an
+// error of the message.
+template <typename MessageT, typename Limits = DefaultLimits,
+          HYPP_BYTE_SOURCE Source>
+Task<Expected<MessageT>> AsyncReadMessage(
+    Source& source, InputBuffer& input,
+    const std::string_view request_method = {}) {
+  constexpr auto kIncomplete = std::is_same_v<MessageT, Response> ?
+      Error::Bad_Response : Error::Bad_Request;
+
+  bool end_of_stream = false;
+  while (true) {
+    if (const auto lease = input.next<MessageT, Limits>(end_of_stream,
+                                                        request_method)) {
+      co_return ParseMessage<MessageT, Limits>(lease->buffers());
+    }
+    if (end_of_stream) {
+      co_return Unexpected{input.empty() ? Error::Connection_Closed :
+                                           kIncomplete};
+    }
+    const auto buffer = input.prepare();
+    const size_t size = co_await source.read(buffer);
+    input.commit(size);
+    end_of_stream = !size;
+  }
+}
+
+// Same as above, but passes the body to `sink` (see body.hpp) as it arrives,
+// instead of waiting for the whole message. Only the header section and the
+// current read are kept in `input`, so memory use does not depend on the size
+// of the body. Chunked bodies are decoded, so that the sink only receives the
+// chunk data; trailer fields are read but not passed on.
+template <typename MessageT, typename Limits = DefaultLimits,
+          HYPP_BYTE_SOURCE Source, typename Sink,
+          typename = detail::enable_if_sink_t<Sink>>
+Task<Expected<MessageT>> AsyncReadMessage(
+    Source& source, InputBuffer& input, Sink& sink,
+    const std::string_view request_method = {}) {
+  constexpr auto kIncomplete = std::is_same_v<MessageT, Response> ?
+      Error::Bad_Response : Error::Bad_Request;
+
+  // start-line *( header-field CRLF ) CRLF
+  std::optional<MessageFrame> frame;
+  while (!(frame = input.frame_head<MessageT, Limits>(request_method))) {
+    if (input.size() > Limits::kHeaderFields + Limits::kRequestLine) {
+      co_return Unexpected{Error::Request_Header_Fields_Too_Large};
+    }
+    const auto buffer = input.prepare();
+    const size_t size = co_await source.read(buffer);
+    if (!size) {
+      co_return Unexpected{input.empty() ? Error::Connection_Closed :
+                                           kIncomplete};
+    }
+    input.commit(size);
+  }
+  auto expected = [&] {
+    const auto head = input.consume(frame->head_size);
+    detail::ChainReader reader{head.buffers().data(), head.buffers().size()};
+    return detail::ParseMessageHead<MessageT, Limits>(reader);
+  }();
+  if (!expected) {
+    co_return expected;
+  }
+
+  // [ message-body ]
+  if (frame->body == MessageFrame::Body::Chunked) {
+    detail::ChunkedDecoder decoder{Limits::kHeaderFields};
+    const auto write = [&sink](const std::string_view data) {
+      return sink.write(data);
+    };
+    while (!decoder.done()) {
+      if (input.empty()) {
+        const auto buffer = input.prepare();
+        const size_t size = co_await source.read(buffer);
+        if (!size) {
+          co_return Unexpected{kIncomplete};
+        }
+        input.commit(size);
+      }
+      size_t used = 0;
+      for (const auto& buffer : input.data()) {
+        const auto size = decoder.decode(buffer.view(), write);
+        if (!size) {
+          co_return Unexpected{size.error()};
+        }
+        used += size.value();
+        if (decoder.done()) {
+          break;
+        }
+      }
+      input.discard(used);
+    }
+  } else {
+    const bool until_close = frame->body == MessageFrame::Body::Close;
+    std::uint64_t remaining =
+        frame->body == MessageFrame::Body::ContentLength ?
+            frame->content_length : 0;
+    while (remaining || until_close) {
+      if (input.empty()) {
+        const auto buffer = input.prepare();
+        const size_t size = co_await source.read(buffer);
+        if (!size) {
+          if (until_close) {
+            break;
+          }
+          co_return Unexpected{kIncomplete};
+        }
+        input.commit(size);
+      }
+
+      // Data is passed on as soon as it arrives
+      const auto size = until_close ? input.size() :
+          static_cast<size_t>(std::min<std::uint64_t>(remaining,
+                                                      input.size()));
+      if (!detail::WriteBuffers(sink, input.data(), size)) {
+        co_return Unexpected{Error::Payload_Too_Large};
+      }
+      input.discard(size);
+      remaining -= until_close ? 0 : size;
+    }
+  }
+  if (!sink.finish()) {
+    co_return Unexpected{Error::Payload_Too_Large};
+  }
+
+  co_return std::move(expected);
+}
+
+template <typename Limits = DefaultLimits, HYPP_BYTE_SOURCE Source>
+Task<Expected<Request>> AsyncReadRequest(Source& source, InputBuffer& input) {
+  return AsyncReadMessage<Request, Limits>(source, input);
+}
+
+template <typename Limits = DefaultLimits, HYPP_BYTE_SOURCE Source>
+Task<Expected<Response>> AsyncReadResponse(
+    Source& source, InputBuffer& input,
+    const std::string_view request_method = {}) {
+  return AsyncReadMessage<Response, Limits>(source, input, request_method);
+}
+
+// Same as above, for a connection that carries a single response. Anything
+// that follows the response is discarded.
+template <typename Limits = DefaultLimits, HYPP_BYTE_SOURCE Source>
+Task<Expected<Response>> AsyncReadResponse(
+    Source& source, const std::string_view request_method = {}) {
+  InputBuffer input;
+  co_return co_await AsyncReadMessage<Response, Limits>(source, input,
+                                                        request_method);
+}
+
+}  // namespace hypp
+
+#undef HYPP_BYTE_SOURCE
+
+#endif  // __cpp_impl_coroutine
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <hypp/error.hpp>
+
+namespace hypp {
+
+// URI components of a batch, stored as structure-of-arrays. Offsets point into
+// the contiguous input that the batch was parsed from.
+struct UriColumns {
+  enum Component : size_t {
+    kScheme,
+    kUserInfo,
+    kHost,
+    kPort,
+    kPath,
+    kQuery,
+    kFragment,
+    kComponentCount,
+  };
+
+  // Length of components that are not defined (e.g. a missing query), as
+  // opposed to components that are empty
+  static constexpr std::uint32_t kUndefined =
+      std::numeric_limits<std::uint32_t>::max();
+
+  struct Column {
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> lengths;
+  };
+
+  std::array<Column, kComponentCount> columns;
+  std::vector<std::uint8_t> errors;  // 0 on success, otherwise Error + 1
+
+  size_t size() const {
+    return errors.size();
+  }
+
+  void resize(const size_t size) {
+    for (auto& column : columns) {
+      column.offsets.assign(size, 0);
+      column.lengths.assign(size, kUndefined);
+    }
+    errors.assign(size, 0);
+  }
+
+  std::optional<Error> error(const size_t row) const {
+    if (!errors[row]) return std::nullopt;
+    return static_cast<Error>(errors[row] - 1);
+  }
+
+  std::optional<std::string_view> get(const std::string_view data,
+                                      const size_t row,
+                                      const Component component) const {
+    const auto& column = columns[component];
+    if (column.lengths[row] == kUndefined) return std::nullopt;
+    return data.substr(column.offsets[row], column.lengths[row]);
+  }
+};
+
+}  // namespace hypp
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <hypp/detail/file.hpp>
+#include <hypp/detail/limits.hpp>
+#include <hypp/detail/mmap.hpp>
+
+namespace hypp {
+
+// A body sink receives a message body in pieces, as it arrives, instead of
+// the parser collecting it in `Message::body`:
+//
+//   bool write(std::string_view data);  // returns false to stop parsing
+//   bool finish();                      // called once the body is complete
+//
+// Parse functions that take a sink leave `Message::body` empty, and are not
+// limited by `Limits::kBody`; the sink decides how much it accepts.
+
+// Keeps the body in memory, up to `limit` bytes.
+struct StringSink {
+  std::string body;
+  size_t limit = DefaultLimits::kBody;
+
+  bool write(const std::string_view data) {
+    if (data.size() > limit - body.size()) {
+      return false;
+    }
+    body.append(data);
+    return true;
+  }
+  bool finish() {
+    return true;
+  }
+};
+
+// Keeps bodies that are smaller than `threshold` in memory, and writes larger
+// ones into a temporary file as they arrive. Once the body is complete, the
+// file is memory-mapped, so that the body can be read as a view without
+// holding it in memory or copying it back. The file is removed when the sink
+// is destroyed or reset.
+class SpillSink {
+public:
+  static constexpr size_t kDefaultThreshold = 64 * 1024;
+
+  explicit SpillSink(const size_t threshold = kDefaultThreshold,
+                     std::string directory = {})
+      : threshold_{threshold}, directory_{std::move(directory)} {}
+
+  SpillSink(const SpillSink&) = delete;
+  SpillSink& operator=(const SpillSink&) = delete;
+
+  bool write(const std::string_view data) {
+    if (finished_) {
+      return false;
+    }
+    size_ += data.size();
+    if (!spilled()) {
+      if (memory_.size() + data.size() <= threshold_) {
+        memory_.append(data);
+        return true;
+      }
+      if (!file_.create(directory_) || !file_.write(memory_)) {
+        return false;
+      }
+      memory_.clear();
+      memory_.shrink_to_fit();
+    }
+    return file_.write(data);
+  }
+
+  bool finish() {
+    if (finished_) {
+      return true;
+    }
+    finished_ = true;
+    if (spilled()) {
+      file_.close();
+      return mapping_.open(file_.path());
+    }
+    return true;
+  }
+
+  // Returns true if the body was written to a file.
+  bool spilled() const {
+    return !file_.path().empty();
+  }
+  // Returns the path of the file, or an empty string if there is none.
+  const std::string& path() const {
+    return file_.path();
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  // Returns the body. It is only complete once finish() has been called.
+  std::string_view view() const {
+    return spilled() ? mapping_.view() : std::string_view{memory_};
+  }
+
+  // Discards the body, so that the sink can be used for another message.
+  void reset() {
+    mapping_.close();
+    file_.remove();
+    memory_.clear();
+    size_ = 0;
+    finished_ = false;
+  }
+
+private:
+  size_t threshold_;
+  std::string directory_;
+  std::string memory_;
+  detail::TempFile file_;
+  detail::MappedFile mapping_;
+  size_t size_ = 0;
+  bool finished_ = false;
+};
+
+}  // namespace hypp
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hypp {
+
+// A view of bytes to be written. The layout matches `struct iovec` on POSIX
+// and `WSABUF` (with the members swapped) on Windows, but is declared here so
+// that no system headers are needed.
+struct ConstBuffer {
+  const char* data = nullptr;
+  size_t size = 0;
+
+  std::string_view view() const {
+    return {data, size};
+  }
+};
+
+using ConstBuffers = std::vector<ConstBuffer>;
+
+// Appends `view` to `buffers`, and merges it into the last buffer if it
+// directly follows it in memory.
+inline void AppendBuffer(ConstBuffers& buffers, const std::string_view view) {
+  if (view.empty()) {
+    return;
+  }
+  if (!buffers.empty() &&
+      buffers.back().data + buffers.back().size == view.data()) {
+    buffers.back().size += view.size();
+    return;
+  }
+  buffers.push_back({view.data(), view.size()});
+}
+
+template <typename Buffers>
+size_t BufferSize(const Buffers& buffers) {
+  size_t size = 0;
+  for (const auto& buffer : buffers) {
+    size += buffer.size;
+  }
+  return size;
+}
+
+// Copies the buffers into a single string.
+inline std::string to_string(const ConstBuffers& buffers) {
+  std::string str;
+  str.reserve(BufferSize(buffers));
+  for (const auto& buffer : buffers) {
+    str.append(buffer.data, buffer.size);
+  }
+  return str;
+}
+
+}  // namespace hypp
@@ -0,0 +1,632 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <hypp/detail/hash.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/generator/uri.hpp>
+#include <hypp/parser/cache_control.hpp>
+#include <hypp/parser/date.hpp>
+#include <hypp/parser/list.hpp>
+#include <hypp/parser/uri.hpp>
+#include <hypp/header.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+#include <hypp/status.hpp>
+
+namespace hypp {
+
+// Freshness metadata of a stored response, computed once when it is stored.
+// Reference: https://tools.ietf.org/html/rfc7234#section-4.2
+struct Freshness {
+  seconds_t response_time = 0;
+  std::uint32_t corrected_initial_age = 0;
+  std::uint32_t lifetime = 0;
+  std::uint16_t directives = 0;  // CacheDirective flags of the response
+
+  // current_age = corrected_initial_age + resident_time
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.2.3
+  std::uint32_t age(const seconds_t now) const {
+    const seconds_t resident_time = std::max<seconds_t>(now - response_time, 0);
+    return static_cast<std::uint32_t>(std::min<seconds_t>(
+        corrected_initial_age + resident_time, UINT32_MAX));
+  }
+
+  // response_is_fresh = (freshness_lifetime > current_age)
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.2
+  bool fresh(const seconds_t now) const {
+    return lifetime > age(now);
+  }
+};
+
+namespace detail {
+
+template <typename HeaderFieldsT>
+const HeaderField* FindHeaderField(const HeaderFieldsT& header_fields,
+                                   const header::Id id) {
+  for (const auto& header_field : header_fields) {
+    if (IsHeaderField(header_field, id)) return &header_field;
+  }
+  return nullptr;
+}
+
+inline CacheControl GetCacheControl(const HeaderFields& header_fields) {
+  CacheControl cache_control;
+  for (const auto& header_field : header_fields) {
+    if (IsHeaderField(header_field, header::kCache_Control)) {
+      ParseCacheControl(header_field.value, cache_control);
+    }
+  }
+  return cache_control;
+}
+
+inline std::optional<seconds_t> GetDate(const HeaderFields& header_fields,
+                                        const header::Id id) {
+  const auto header_field = FindHeaderField(header_fields, id);
+  return header_field ? ParseHttpDate(header_field->value) : std::nullopt;
+}
+
+// > Responses with status codes that are defined as cacheable by default
+// (e.g., 200, 203, 204, 206, 300, 301, 404, 405, 410, 414, and 501 in this
+// specification) can be reused by a cache with heuristic expiration unless
+// otherwise indicated by the method definition or explicit cache controls
+// Reference: https://tools.ietf.org/html/rfc7231#section-6.1
+constexpr bool IsCacheableByDefault(const status::code_t code) {
+  switch (code) {
+    case 200: case 203: case 204: case 206: case 300: case 301: case 308:
+    case 404: case 405: case 410: case 414: case 501:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Values are compared as if all fields of the same name were combined, with
+// OWS around the commas removed.
+inline bool MatchesCombinedValue(const HeaderFields& header_fields,
+                                 const HeaderField& stored) {
+  ListElements::iterator stored_it{stored.value};
+  for (const auto& header_field : header_fields) {
+    const bool same_name = stored.id != header::kUnknown ?
+        IsHeaderField(header_field, stored.id) :
+        equals_ignore_case(header_field.name, stored.name);
+    if (!same_name) {
+      continue;
+    }
+    for (const auto element : ListElements{header_field.value}) {
+      if (stored_it == ListElements::iterator{} || *stored_it != element) {
+        return false;
+      }
+      ++stored_it;
+    }
+  }
+  return stored_it == ListElements::iterator{};
+}
+
+inline std::string CombinedValue(const HeaderFields& header_fields,
+                                 const std::string_view name) {
+  std::string value;
+  for (const auto& header_field : header_fields) {
+    if (equals_ignore_case(header_field.name, name)) {
+      for (const auto element : ListElements{header_field.value}) {
+        if (!value.empty()) value.append(", ");
+        value.append(element);
+      }
+    }
+  }
+  return value;
+}
+
+inline size_t EstimateSize(const HeaderFields& header_fields) {
+  size_t size = header_fields.capacity() * sizeof(HeaderField);
+  for (const auto& header_field : header_fields) {
+    size += header_field.name.size() + header_field.value.size();
+  }
+  return size;
+}
+
+}  // namespace detail
+
+// Computes the freshness of a response that was received at `response_time`
+// for a request that was sent at `request_time`. Shared cache directives are
+// ignored, as this is for private caches.
+inline Freshness ComputeFreshness(const Response& response,
+                                  const seconds_t request_time,
+                                  const seconds_t response_time) {
+  const auto& header_fields = response.header_fields;
+  const auto cache_control = detail::GetCacheControl(header_fields);
+  const auto date = detail::GetDate(header_fields, header::kDate);
+
+  Freshness freshness;
+  freshness.response_time = response_time;
+  freshness.directives = cache_control.directives;
+
+  // apparent_age = max(0, response_time - date_value);
+  // response_delay = response_time - request_time;
+  // corrected_age_value = age_value + response_delay;
+  // corrected_initial_age = max(apparent_age, corrected_age_value);
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.2.3
+  const seconds_t apparent_age =
+      date ? std::max<seconds_t>(response_time - *date, 0) : 0;
+  const seconds_t response_delay =
+      std::max<seconds_t>(response_time - request_time, 0);
+  std::uint32_t age_value = 0;
+  if (const auto age = detail::FindHeaderField(header_fields, header::kAge)) {
+    age_value = ParseDeltaSeconds(age->value).value_or(0);
+  }
+  freshness.corrected_initial_age = static_cast<std::uint32_t>(std::min<
+      seconds_t>(std::max(apparent_age, age_value + response_delay),
+                 UINT32_MAX));
+
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.2.1
+  if (cache_control.max_age) {
+    freshness.lifetime = *cache_control.max_age;
+  } else if (const auto expires =
+                 detail::FindHeaderField(header_fields, header::kExpires)) {
+    // > A cache recipient MUST interpret invalid date formats, especially the
+    // value "0", as representing a time in the past (i.e., "already
+    // expired").
+    // Reference: https://tools.ietf.org/html/rfc7234#section-5.3
+    const auto expires_date = ParseHttpDate(expires->value);
+    const seconds_t lifetime =
+        expires_date ? *expires_date - date.value_or(response_time) : 0;
+    freshness.lifetime = static_cast<std::uint32_t>(
+        std::clamp<seconds_t>(lifetime, 0, UINT32_MAX));
+  } else if (detail::IsCacheableByDefault(response.start_line.code)) {
+    // > If the response has a Last-Modified header field, caches are
+    // encouraged to use a heuristic expiration value that is no more than
+    // some fraction of the interval since that time. A typical setting of
+    // this fraction might be 10%.
+    // Reference: https://tools.ietf.org/html/rfc7234#section-4.2.2
+    const auto last_modified =
+        detail::GetDate(header_fields, header::kLast_Modified);
+    if (last_modified) {
+      const seconds_t interval = date.value_or(response_time) - *last_modified;
+      freshness.lifetime = static_cast<std::uint32_t>(
+          std::clamp<seconds_t>(interval / 10, 0, UINT32_MAX));
+    }
+  }
+
+  return freshness;
+}
+
+// Returns a copy of `request` with the validators of `stored` added, so that
+// the server can reply with 304 (Not Modified) if it is still valid.
+// Reference: https://tools.ietf.org/html/rfc7234#section-4.3.1
+inline Request MakeConditionalRequest(Request request,
+                                      const Response& stored) {
+  auto& header_fields = request.header_fields;
+  header_fields.erase(
+      std::remove_if(header_fields.begin(), header_fields.end(),
+                     [](const HeaderField& header_field) {
+                       return detail::IsHeaderField(header_field,
+                                                    header::kIf_None_Match) ||
+                              detail::IsHeaderField(header_field,
+                                                    header::kIf_Modified_Since);
+                     }),
+      header_fields.end());
+
+  const auto etag = detail::FindHeaderField(stored.header_fields,
+                                            header::kETag);
+  if (etag) {
+    header_fields.push_back(
+        {"If-None-Match", etag->value, header::kIf_None_Match});
+  }
+  const auto last_modified = detail::FindHeaderField(stored.header_fields,
+                                                     header::kLast_Modified);
+  if (last_modified) {
+    header_fields.push_back({"If-Modified-Since", last_modified->value,
+                             header::kIf_Modified_Since});
+  }
+  return request;
+}
+
+// Returns the key of a request in a cache, which is the normalized target URI.
+// The authority of origin-form requests is taken from the Host header field,
+// and their scheme is assumed to be "http", so requests to "https" targets
+// should be stored in absolute-form.
+// Reference: https://tools.ietf.org/html/rfc7230#section-5.5
+// Reference: https://tools.ietf.org/html/rfc7234#section-2
+inline std::string CacheKey(const Request& request) {
+  Uri uri = request.start_line.target.uri;
+  uri.fragment.reset();
+  if (!uri.scheme) {
+    uri.scheme = "http";
+  }
+  if (!uri.authority) {
+    if (const auto host = detail::FindHeaderField(request.header_fields,
+                                                  header::kHost)) {
+      // Host = uri-host [ ":" port ]
+      // Reference: https://tools.ietf.org/html/rfc7230#section-5.4
+      Parser parser{host->value};
+      auto authority = detail::ParseUriAuthority(parser);
+      if (authority && parser.empty()) {
+        uri.authority = std::move(authority.value());
+      } else {
+        // An invalid value is kept as is, so that it never matches a valid one
+        uri.authority.emplace();
+        uri.authority->host = host->value;
+      }
+    }
+  }
+  return Normalize(uri);
+}
+
+struct CacheLookup {
+  enum class Status {
+    Miss,
+    Fresh,  // can be used as is
+    Stale,  // must be revalidated with `revalidation` first
+  };
+
+  Status status = Status::Miss;
+  std::shared_ptr<const Response> response;
+  std::uint32_t age = 0;  // for the Age header field
+  std::optional<Request> revalidation;
+
+  explicit operator bool() const {
+    return status == Status::Fresh;
+  }
+};
+
+// An in-memory private cache for responses to GET requests. Entries are
+// evicted in least-recently-used order once `capacity` bytes are used.
+//
+// The cache is split into shards by the hash of the key, and each shard has
+// its own lock and its own share of the capacity, so that threads rarely
+// contend. Responses are shared, so they outlive their eviction while in use.
+//
+// Reference: https://tools.ietf.org/html/rfc7234
+class Cache {
+public:
+  explicit Cache(const size_t capacity, const size_t shard_count = 16)
+      : shard_count_{std::max<size_t>(shard_count, 1)},
+        shard_capacity_{capacity / shard_count_},
+        shards_{std::make_unique<Shard[]>(shard_count_)} {}
+
+  // Stores a response to a request, replacing any previous response that was
+  // selected by the same request. Returns false if it cannot be stored.
+  // Reference: https://tools.ietf.org/html/rfc7234#section-3
+  bool store(const Request& request, Response response,
+             const seconds_t request_time = detail::CurrentTime(),
+             const seconds_t response_time = detail::CurrentTime()) {
+    if (!is_storable(request, response)) {
+      return false;
+    }
+
+    Entry entry;
+    entry.key = CacheKey(request);
+    entry.hash = detail::Hash(entry.key);
+    entry.freshness = ComputeFreshness(response, request_time, response_time);
+
+    // > When a cache receives a request that can be satisfied by a stored
+    // response that has a Vary header field, it MUST NOT use that response
+    // unless all of the selecting header fields nominated by the Vary header
+    // field match in both the original request (i.e., that associated with
+    // the stored response), and the presented request.
+    // Reference: https://tools.ietf.org/html/rfc7234#section-4.1
+    for (const auto& header_field : response.header_fields) {
+      if (!detail::IsHeaderField(header_field, header::kVary)) continue;
+      for (const auto name : ListElements{header_field.value}) {
+        entry.vary.push_back(
+            {std::string{name},
+             detail::CombinedValue(request.header_fields, name),
+             header::to_id(name)});
+      }
+    }
+
+    entry.size = entry_size(entry, response);
+    if (entry.size > shard_capacity_) {
+      return false;
+    }
+    entry.response = std::make_shared<const Response>(std::move(response));
+
+    auto& shard = shard_for(entry.hash);
+    std::lock_guard lock{shard.mutex};
+    if (const auto it = shard.find(entry.hash, entry.key, request);
+        it != shard.entries.end()) {
+      shard.erase(it);
+    }
+    shard.bytes += entry.size;
+    shard.entries.push_front(std::move(entry));
+    shard.index.emplace(shard.entries.front().hash, shard.entries.begin());
+    shard.evict(shard_capacity_);
+    return true;
+  }
+
+  // Finds a stored response for a request.
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4
+  CacheLookup lookup(const Request& request,
+                     const seconds_t now = detail::CurrentTime()) {
+    CacheLookup result;
+    if (request.start_line.method != "GET") {
+      return result;
+    }
+
+    const auto key = CacheKey(request);
+    const auto hash = detail::Hash(key);
+    Freshness freshness;
+    {
+      auto& shard = shard_for(hash);
+      std::lock_guard lock{shard.mutex};
+      const auto it = shard.find(hash, key, request);
+      if (it == shard.entries.end()) {
+        return result;
+      }
+      shard.entries.splice(shard.entries.begin(), shard.entries, it);
+      result.response = it->response;
+      freshness = it->freshness;
+    }
+
+    result.age = freshness.age(now);
+    result.status = is_fresh(request, freshness, now) ?
+        CacheLookup::Status::Fresh : CacheLookup::Status::Stale;
+    if (result.status == CacheLookup::Status::Stale) {
+      result.revalidation = MakeConditionalRequest(request, *result.response);
+    }
+    return result;
+  }
+
+  // Updates the stored response after a successful revalidation, and returns
+  // it. Header fields of the 304 (Not Modified) response replace the stored
+  // ones of the same name.
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.3.4
+  std::shared_ptr<const Response> update(
+      const Request& request, const Response& not_modified,
+      const seconds_t request_time = detail::CurrentTime(),
+      const seconds_t response_time = detail::CurrentTime()) {
+    const auto key = CacheKey(request);
+    const auto hash = detail::Hash(key);
+    auto& shard = shard_for(hash);
+    std::lock_guard lock{shard.mutex};
+    const auto it = shard.find(hash, key, request);
+    if (it == shard.entries.end()) {
+      return nullptr;
+    }
+
+    auto response = std::make_shared<Response>(*it->response);
+    auto& header_fields = response->header_fields;
+    for (const auto& header_field : not_modified.header_fields) {
+      header_fields.erase(
+          std::remove_if(header_fields.begin(), header_fields.end(),
+                         [&header_field](const HeaderField& stored) {
+                           return detail::equals_ignore_case(
+                               stored.name, header_field.name);
+                         }),
+          header_fields.end());
+    }
+    header_fields.insert(header_fields.end(),
+                         not_modified.header_fields.begin(),
+                         not_modified.header_fields.end());
+
+    // The entry may be evicted along with others if the response grew
+    const auto size = entry_size(*it, *response);
+    shard.bytes = shard.bytes - it->size + size;
+    it->size = size;
+    it->freshness = ComputeFreshness(*response, request_time, response_time);
+    it->response = std::move(response);
+    shard.entries.splice(shard.entries.begin(), shard.entries, it);
+    auto updated = it->response;
+    shard.evict(shard_capacity_);
+    return updated;
+  }
+
+  // Removes all responses for the target URI of a request, e.g. after an
+  // unsafe request succeeded.
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.4
+  void invalidate(const Request& request) {
+    const auto key = CacheKey(request);
+    const auto hash = detail::Hash(key);
+    auto& shard = shard_for(hash);
+    std::lock_guard lock{shard.mutex};
+    auto [first, last] = shard.index.equal_range(hash);
+    while (first != last) {
+      const auto entry = first->second;
+      ++first;
+      if (entry->key == key) {
+        shard.erase(entry);
+      }
+    }
+  }
+
+  void clear() {
+    for (size_t i = 0; i < shard_count_; ++i) {
+      std::lock_guard lock{shards_[i].mutex};
+      shards_[i].entries.clear();
+      shards_[i].index.clear();
+      shards_[i].bytes = 0;
+    }
+  }
+
+  size_t size() const {
+    size_t size = 0;
+    for (size_t i = 0; i < shard_count_; ++i) {
+      std::lock_guard lock{shards_[i].mutex};
+      size += shards_[i].entries.size();
+    }
+    return size;
+  }
+
+  // Returns the estimated memory that is used by entries.
+  size_t bytes() const {
+    size_t bytes = 0;
+    for (size_t i = 0; i < shard_count_; ++i) {
+      std::lock_guard lock{shards_[i].mutex};
+      bytes += shards_[i].bytes;
+    }
+    return bytes;
+  }
+
+private:
+  struct Entry {
+    std::string key;
+    std::uint64_t hash = 0;
+    HeaderFields vary;  // selecting header fields of the original request
+    std::shared_ptr<const Response> response;
+    Freshness freshness;
+    size_t size = 0;
+  };
+
+  using Entries = std::list<Entry>;  // most recently used first
+
+  struct Shard {
+    mutable std::mutex mutex;
+    Entries entries;
+    std::unordered_multimap<std::uint64_t, Entries::iterator> index;
+    size_t bytes = 0;
+
+    Entries::iterator find(const std::uint64_t hash, const std::string& key,
+                           const Request& request) {
+      const auto [first, last] = index.equal_range(hash);
+      for (auto it = first; it != last; ++it) {
+        const auto& entry = *it->second;
+        if (entry.key == key &&
+            std::all_of(entry.vary.begin(), entry.vary.end(),
+                        [&request](const HeaderField& header_field) {
+                          return detail::MatchesCombinedValue(
+                              request.header_fields, header_field);
+                        })) {
+          return it->second;
+        }
+      }
+      return entries.end();
+    }
+
+    void erase(const Entries::iterator entry) {
+      const auto [first, last] = index.equal_range(entry->hash);
+      for (auto it = first; it != last; ++it) {
+        if (it->second == entry) {
+          index.erase(it);
+          break;
+        }
+      }
+      bytes -= entry->size;
+      entries.erase(entry);
+    }
+
+    void evict(const size_t capacity) {
+      while (bytes > capacity && !entries.empty()) {
+        erase(std::prev(entries.end()));
+      }
+    }
+  };
+
+  // Returns the estimated memory that is used by an entry.
+  static size_t entry_size(const Entry& entry, const Response& response) {
+    return sizeof(Entry) + sizeof(Response) + entry.key.size() +
+           detail::EstimateSize(entry.vary) +
+           detail::EstimateSize(response.header_fields) +
+           response.body.size();
+  }
+
+  static bool is_storable(const Request& request, const Response& response) {
+    // Only GET responses are stored, and partial content is not combined.
+    if (request.start_line.method != "GET" ||
+        response.start_line.code < 200 || response.start_line.code == 206) {
+      return false;
+    }
+
+    const auto request_cache_control =
+        detail::GetCacheControl(request.header_fields);
+    const auto cache_control = detail::GetCacheControl(response.header_fields);
+    if (request_cache_control.has(kCacheNoStore) ||
+        cache_control.has(kCacheNoStore)) {
+      return false;
+    }
+
+    // > A Vary field value of "*" signals that anything about the request
+    // might play a role in selecting the response representation, possibly
+    // including elements outside the message syntax (e.g., the client's
+    // network address). A recipient will not be able to determine whether
+    // this response is appropriate for a later request without forwarding
+    // the request to the origin server.
+    // Reference: https://tools.ietf.org/html/rfc7231#section-7.1.4
+    for (const auto& header_field : response.header_fields) {
+      if (!detail::IsHeaderField(header_field, header::kVary)) continue;
+      for (const auto name : ListElements{header_field.value}) {
+        if (name == "*") return false;
+      }
+    }
+
+    return cache_control.max_age ||
+           detail::FindHeaderField(response.header_fields, header::kExpires) ||
+           cache_control.has(kCachePublic) ||
+           cache_control.has(kCachePrivate) ||
+           detail::IsCacheableByDefault(response.start_line.code);
+  }
+
+  // Reference: https://tools.ietf.org/html/rfc7234#section-4.2.4
+  // Reference: https://tools.ietf.org/html/rfc7234#section-5.2.1
+  static bool is_fresh(const Request& request, const Freshness& freshness,
+                       const seconds_t now) {
+    if (freshness.directives & kCacheNoCache) {
+      return false;
+    }
+
+    auto cache_control = detail::GetCacheControl(request.header_fields);
+    // > When the Cache-Control header field is not present in a request,
+    // caches MUST consider the no-cache request pragma-directive as having
+    // the same effect as if "Cache-Control: no-cache" were present
+    // Reference: https://tools.ietf.org/html/rfc7234#section-5.4
+    if (!detail::FindHeaderField(request.header_fields,
+                                 header::kCache_Control)) {
+      if (const auto pragma = detail::FindHeaderField(request.header_fields,
+                                                      header::kPragma)) {
+        for (const auto directive : ListElements{pragma->value}) {
+          if (detail::equals_ignore_case(directive, "no-cache")) {
+            cache_control.directives |= kCacheNoCache;
+          }
+        }
+      }
+    }
+    if (cache_control.has(kCacheNoCache)) {
+      return false;
+    }
+
+    const auto age = freshness.age(now);
+    if (cache_control.max_age && age > *cache_control.max_age) {
+      return false;
+    }
+    if (cache_control.min_fresh &&
+        freshness.lifetime < std::uint64_t{age} + *cache_control.min_fresh) {
+      return false;
+    }
+    if (freshness.fresh(now)) {
+      return true;
+    }
+
+    // > The "must-revalidate" response directive indicates that once it has
+    // become stale, a cache MUST NOT use the response to satisfy subsequent
+    // requests without successful validation on the origin server.
+    // Reference: https://tools.ietf.org/html/rfc7234#section-5.2.2.1
+    if (freshness.directives & kCacheMustRevalidate) {
+      return false;
+    }
+    if (cache_control.any_stale) {
+      return true;
+    }
+    return cache_control.max_stale &&
+           age - freshness.lifetime <= *cache_control.max_stale;
+  }
+
+  Shard& shard_for(const std::uint64_t hash) const {
+    return shards_[hash % shard_count_];
+  }
+
+  const size_t shard_count_;
+  const size_t shard_capacity_;
+  const std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace hypp
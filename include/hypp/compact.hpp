@@ -0,0 +1,433 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <hypp/generator/uri.hpp>
+#include <hypp/batch.hpp>
+#include <hypp/error.hpp>
+#include <hypp/header.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+#include <hypp/status.hpp>
+#include <hypp/uri.hpp>
+#include <hypp/version.hpp>
+
+namespace hypp {
+
+// A string inside a compact message, as an offset from the start of the
+// message.
+struct CompactSpan {
+  // Length of strings that are not defined (e.g. a missing query), as opposed
+  // to strings that are empty
+  static constexpr std::uint32_t kUndefined =
+      std::numeric_limits<std::uint32_t>::max();
+
+  // Offset of header field names that are not stored, because they are spelled
+  // as registered (see header::to_name)
+  static constexpr std::uint32_t kRegistered =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::uint32_t offset = 0;
+  std::uint32_t length = kUndefined;
+};
+
+namespace compact {
+
+enum Kind : std::uint8_t {
+  kRequest = 1,
+  kResponse = 2,
+};
+
+// A compact message is laid out as:
+//
+//   Header
+//   Field[header_count]
+//   strings
+//
+// Nothing points outside of the message, so it can be moved or copied with
+// memcpy, and it is read with unaligned loads, so it can be at any address.
+struct Header {
+  std::uint32_t size = 0;  // of the whole message, in bytes
+  Kind kind = kRequest;
+  char version_major = '\0';
+  char version_minor = '\0';
+  std::uint8_t target_form = 0;  // RequestTarget::Form
+  std::uint16_t code = 0;
+  std::uint16_t header_count = 0;
+  CompactSpan method;
+  std::array<CompactSpan, UriColumns::kComponentCount> uri;
+  CompactSpan body;
+};
+
+struct Field {
+  CompactSpan name;
+  CompactSpan value;
+  std::uint32_t id = header::kUnknown;
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<Field>);
+static_assert(sizeof(Header) == 84);
+static_assert(sizeof(Field) == 20);
+
+}  // namespace compact
+
+struct HeaderFieldView {
+  std::string_view name;
+  std::string_view value;
+  header::Id id = header::kUnknown;
+};
+
+namespace detail {
+
+template <typename T>
+T LoadUnaligned(const char* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+class CompactWriter {
+public:
+  explicit CompactWriter(std::string& data, const size_t strings_offset)
+      : data_{data}, offset_{strings_offset} {}
+
+  CompactSpan write(const std::string_view str) {
+    const CompactSpan span{static_cast<std::uint32_t>(offset_),
+                           static_cast<std::uint32_t>(str.size())};
+    std::memcpy(data_.data() + offset_, str.data(), str.size());
+    offset_ += str.size();
+    return span;
+  }
+
+  CompactSpan write(const std::string& str) {
+    return write(std::string_view{str});
+  }
+
+  CompactSpan write(const std::optional<std::string>& str) {
+    return str ? write(std::string_view{*str}) : CompactSpan{};
+  }
+
+private:
+  std::string& data_;
+  size_t offset_;
+};
+
+inline size_t StringsSize(const Uri& uri) {
+  size_t size = OptionalSize(uri.scheme) + uri.path.size() +
+                OptionalSize(uri.query) + OptionalSize(uri.fragment);
+  if (uri.authority) {
+    size += OptionalSize(uri.authority->user_info) +
+            uri.authority->host.size() +
+            OptionalSize(uri.authority->port);
+  }
+  return size;
+}
+
+inline bool IsRegisteredName(const HeaderField& header_field) {
+  return header_field.id != header::kUnknown &&
+         header_field.name == header::to_name(header_field.id);
+}
+
+}  // namespace detail
+
+// A read-only view of a compact message in any buffer, e.g. a memory-mapped
+// file. Strings are views into the same buffer.
+class CompactMessageView {
+public:
+  CompactMessageView() = default;
+  explicit CompactMessageView(const std::string_view data) : data_{data} {}
+
+  // Checks that the message is complete and that all spans are inside of it.
+  // Must be called before reading untrusted data.
+  bool valid() const {
+    if (data_.size() < sizeof(compact::Header)) {
+      return false;
+    }
+    const auto header = this->header();
+    if (header.size != data_.size() ||
+        (header.kind != compact::kRequest &&
+         header.kind != compact::kResponse) ||
+        data_.size() < sizeof(compact::Header) +
+                       header.header_count * sizeof(compact::Field)) {
+      return false;
+    }
+    const auto in_bounds = [this](const CompactSpan span) {
+      return span.length == CompactSpan::kUndefined ||
+             std::uint64_t{span.offset} + span.length <= data_.size();
+    };
+    if (!in_bounds(header.method) || !in_bounds(header.body)) {
+      return false;
+    }
+    for (const auto& span : header.uri) {
+      if (!in_bounds(span)) return false;
+    }
+    const auto is_defined = [&in_bounds](const CompactSpan span) {
+      return span.length != CompactSpan::kUndefined && in_bounds(span);
+    };
+    for (size_t i = 0; i < header.header_count; ++i) {
+      const auto field = this->field(i);
+      if (!is_defined(field.value) ||
+          (field.name.offset == CompactSpan::kRegistered ?
+               header::to_name(static_cast<header::Id>(field.id)).empty() :
+               !is_defined(field.name))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::string_view data() const {
+    return data_;
+  }
+  size_t size() const {
+    return data_.size();
+  }
+
+  compact::Kind kind() const {
+    return header().kind;
+  }
+
+  std::string_view method() const {
+    return get(header().method).value_or(std::string_view{});
+  }
+  RequestTarget::Form target_form() const {
+    return static_cast<RequestTarget::Form>(header().target_form);
+  }
+  UriView uri() const {
+    const auto header = this->header();
+    const auto& spans = header.uri;
+    UriView uri;
+    uri.scheme = get(spans[UriColumns::kScheme]);
+    if (const auto host = get(spans[UriColumns::kHost])) {
+      uri.authority = UriView::Authority{get(spans[UriColumns::kUserInfo]),
+                                         *host, get(spans[UriColumns::kPort])};
+    }
+    uri.path = get(spans[UriColumns::kPath]).value_or(std::string_view{});
+    uri.query = get(spans[UriColumns::kQuery]);
+    uri.fragment = get(spans[UriColumns::kFragment]);
+    return uri;
+  }
+
+  Version version() const {
+    const auto header = this->header();
+    return {header.version_major, header.version_minor};
+  }
+  status::code_t code() const {
+    return header().code;
+  }
+
+  size_t header_count() const {
+    return header().header_count;
+  }
+  HeaderFieldView header_field(const size_t index) const {
+    const auto field = this->field(index);
+    const auto id = static_cast<header::Id>(field.id);
+    return {field.name.offset == CompactSpan::kRegistered ?
+                header::to_name(id) : *get(field.name),
+            *get(field.value), id};
+  }
+  // Returns the value of the first header field with the ID.
+  std::optional<std::string_view> header_value(const header::Id id) const {
+    for (size_t i = 0; i < header_count(); ++i) {
+      const auto field = this->field(i);
+      if (field.id == id) return get(field.value);
+    }
+    return std::nullopt;
+  }
+
+  std::string_view body() const {
+    return get(header().body).value_or(std::string_view{});
+  }
+
+private:
+  compact::Header header() const {
+    return detail::LoadUnaligned<compact::Header>(data_.data());
+  }
+  compact::Field field(const size_t index) const {
+    return detail::LoadUnaligned<compact::Field>(
+        data_.data() + sizeof(compact::Header) +
+        index * sizeof(compact::Field));
+  }
+
+  std::optional<std::string_view> get(const CompactSpan span) const {
+    if (span.length == CompactSpan::kUndefined) return std::nullopt;
+    return data_.substr(span.offset, span.length);
+  }
+
+  std::string_view data_;
+};
+
+// A message in a single allocation, with 32-bit offsets instead of separately
+// allocated strings.
+class CompactMessage {
+public:
+  CompactMessage() = default;
+  explicit CompactMessage(std::string data) : data_{std::move(data)} {}
+
+  CompactMessageView view() const {
+    return CompactMessageView{data_};
+  }
+  std::string_view data() const {
+    return data_;
+  }
+  size_t size() const {
+    return data_.size();
+  }
+
+private:
+  std::string data_;
+};
+
+namespace detail {
+
+// `write_start_line` writes the strings of the start line, whose total size
+// is `start_line_size`.
+template <typename StartLine, typename WriteStartLine>
+hypp::Expected<CompactMessage> Compact(const Message<StartLine>& message,
+                                 compact::Header header,
+                                 const size_t start_line_size,
+                                 WriteStartLine write_start_line) {
+  const auto& header_fields = message.header_fields;
+  if (header_fields.size() > std::numeric_limits<std::uint16_t>::max()) {
+    return hypp::Unexpected{Error::Request_Header_Fields_Too_Large};
+  }
+
+  const size_t strings_offset = sizeof(compact::Header) +
+                                header_fields.size() * sizeof(compact::Field);
+  size_t size = strings_offset + start_line_size + message.body.size();
+  for (const auto& header_field : header_fields) {
+    size += header_field.value.size();
+    if (!IsRegisteredName(header_field)) {
+      size += header_field.name.size();
+    }
+  }
+  // Offsets and lengths must not reach the reserved values
+  if (size >= CompactSpan::kUndefined) {
+    return hypp::Unexpected{Error::Payload_Too_Large};
+  }
+
+  std::string data(size, '\0');
+  CompactWriter writer{data, strings_offset};
+
+  write_start_line(writer, header);
+  header.size = static_cast<std::uint32_t>(size);
+  header.header_count = static_cast<std::uint16_t>(header_fields.size());
+  header.body = writer.write(message.body);
+
+  char* field_data = data.data() + sizeof(compact::Header);
+  for (const auto& header_field : header_fields) {
+    compact::Field field;
+    if (IsRegisteredName(header_field)) {
+      field.name = {CompactSpan::kRegistered,
+                    static_cast<std::uint32_t>(header_field.name.size())};
+    } else {
+      field.name = writer.write(header_field.name);
+    }
+    field.value = writer.write(header_field.value);
+    field.id = header_field.id;
+    std::memcpy(field_data, &field, sizeof(field));
+    field_data += sizeof(field);
+  }
+
+  std::memcpy(data.data(), &header, sizeof(header));
+  return CompactMessage{std::move(data)};
+}
+
+template <typename StartLine>
+void ExpandHeaderFields(const CompactMessageView view,
+                        Message<StartLine>& message) {
+  message.header_fields.reserve(view.header_count());
+  for (size_t i = 0; i < view.header_count(); ++i) {
+    const auto header_field = view.header_field(i);
+    message.header_fields.push_back({std::string{header_field.name},
+                                     std::string{header_field.value},
+                                     header_field.id});
+  }
+  message.body = view.body();
+}
+
+template <typename T>
+std::optional<std::string> ToOptionalString(const std::optional<T>& str) {
+  return str ? std::optional<std::string>{std::string{*str}} : std::nullopt;
+}
+
+}  // namespace detail
+
+inline Expected<CompactMessage> Compact(const Request& request) {
+  const auto& start_line = request.start_line;
+  const auto& uri = start_line.target.uri;
+  const size_t start_line_size = start_line.method.size() +
+                                 detail::StringsSize(uri);
+
+  compact::Header header;
+  header.kind = compact::kRequest;
+  header.version_major = start_line.version.major;
+  header.version_minor = start_line.version.minor;
+  header.target_form = static_cast<std::uint8_t>(start_line.target.form);
+
+  return detail::Compact(request, header, start_line_size,
+      [&](detail::CompactWriter& writer, compact::Header& header) {
+        header.method = writer.write(start_line.method);
+        auto& spans = header.uri;
+        spans[UriColumns::kScheme] = writer.write(uri.scheme);
+        if (uri.authority) {
+          spans[UriColumns::kUserInfo] =
+              writer.write(uri.authority->user_info);
+          spans[UriColumns::kHost] = writer.write(uri.authority->host);
+          spans[UriColumns::kPort] = writer.write(uri.authority->port);
+        }
+        spans[UriColumns::kPath] = writer.write(uri.path);
+        spans[UriColumns::kQuery] = writer.write(uri.query);
+        spans[UriColumns::kFragment] = writer.write(uri.fragment);
+      });
+}
+
+inline Expected<CompactMessage> Compact(const Response& response) {
+  compact::Header header;
+  header.kind = compact::kResponse;
+  header.version_major = response.start_line.version.major;
+  header.version_minor = response.start_line.version.minor;
+  header.code = static_cast<std::uint16_t>(response.start_line.code);
+  return detail::Compact(response, header, 0,
+                         [](detail::CompactWriter&, compact::Header&) {});
+}
+
+inline Request to_request(const CompactMessageView view) {
+  Request request;
+  auto& start_line = request.start_line;
+  start_line.method = view.method();
+  start_line.target.form = view.target_form();
+  const auto uri = view.uri();
+  auto& target_uri = start_line.target.uri;
+  target_uri.scheme = detail::ToOptionalString(uri.scheme);
+  if (uri.authority) {
+    target_uri.authority = Uri::Authority{
+        detail::ToOptionalString(uri.authority->user_info),
+        std::string{uri.authority->host},
+        detail::ToOptionalString(uri.authority->port)};
+  }
+  target_uri.path = uri.path;
+  target_uri.query = detail::ToOptionalString(uri.query);
+  target_uri.fragment = detail::ToOptionalString(uri.fragment);
+  start_line.version = view.version();
+  detail::ExpandHeaderFields(view, request);
+  return request;
+}
+
+inline Response to_response(const CompactMessageView view) {
+  Response response;
+  response.start_line.version = view.version();
+  response.start_line.code = view.code();
+  detail::ExpandHeaderFields(view, response);
+  return response;
+}
+
+}  // namespace hypp
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace hypp::detail {
+
+// A temporary file that is written sequentially, and removed when the object
+// is destroyed. Writes go directly to the file, without a stream buffer.
+class TempFile {
+public:
+  TempFile() = default;
+  ~TempFile() {
+    remove();
+  }
+
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+
+  bool is_open() const {
+#if defined(_WIN32)
+    return file_ != INVALID_HANDLE_VALUE;
+#else
+    return fd_ >= 0;
+#endif
+  }
+  const std::string& path() const {
+    return path_;
+  }
+
+  // Creates a file in `directory`, or in the default temporary directory if
+  // it is empty.
+  bool create(std::string directory = {}) {
+    remove();
+#if defined(_WIN32)
+    if (directory.empty()) {
+      char buffer[MAX_PATH + 1] = {};
+      if (!::GetTempPathA(sizeof(buffer), buffer)) {
+        return false;
+      }
+      directory = buffer;
+    }
+    char path[MAX_PATH + 1] = {};
+    if (!::GetTempFileNameA(directory.c_str(), "hyp", 0, path)) {
+      return false;
+    }
+    file_ = ::CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                          FILE_ATTRIBUTE_TEMPORARY, nullptr);
+    path_ = path;
+#else
+    if (directory.empty()) {
+      const char* const tmpdir = std::getenv("TMPDIR");
+      directory = tmpdir && *tmpdir ? tmpdir : "/tmp";
+    }
+    std::string path = directory + "/hypp-XXXXXX";
+    fd_ = ::mkstemp(path.data());
+    path_ = std::move(path);
+#endif
+    if (!is_open()) {
+      path_.clear();
+    }
+    return is_open();
+  }
+
+  bool write(std::string_view data) {
+    while (!data.empty() && is_open()) {
+#if defined(_WIN32)
+      DWORD size = 0;
+      if (!::WriteFile(file_, data.data(),
+                       static_cast<DWORD>(std::min<size_t>(data.size(),
+                                                           0x40000000)),
+                       &size, nullptr)) {
+        return false;
+      }
+#else
+      const auto size = ::write(fd_, data.data(), data.size());
+      if (size < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+#endif
+      data.remove_prefix(static_cast<size_t>(size));
+    }
+    return data.empty();
+  }
+
+  // Closes the file, but keeps it on disk until the object is destroyed.
+  void close() {
+#if defined(_WIN32)
+    if (file_ != INVALID_HANDLE_VALUE) {
+      ::CloseHandle(file_);
+      file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+#endif
+  }
+
+  void remove() {
+    close();
+    if (!path_.empty()) {
+      std::remove(path_.c_str());
+      path_.clear();
+    }
+  }
+
+private:
+#if defined(_WIN32)
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+  int fd_ = -1;
+#endif
+  std::string path_;
+};
+
+}  // namespace hypp::detail
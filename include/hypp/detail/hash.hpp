@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace hypp {
+
+struct Hash128 {
+  std::uint64_t low = 0;
+  std::uint64_t high = 0;
+
+  constexpr bool operator==(const Hash128& rhs) const {
+    return low == rhs.low && high == rhs.high;
+  }
+  constexpr bool operator!=(const Hash128& rhs) const {
+    return !(*this == rhs);
+  }
+};
+
+}  // namespace hypp
+
+namespace hypp::detail {
+
+// A streaming, non-cryptographic hash function with stable output across
+// platforms and releases. Input is consumed in little-endian 64-bit words, so
+// the result only depends on the byte sequence, not on how it was split into
+// calls.
+//
+// It can be used as an output for functions that append to a std::string.
+class Hasher {
+public:
+  constexpr Hasher() = default;
+  constexpr explicit Hasher(const std::uint64_t seed)
+      : a_{kSeedA ^ seed}, b_{kSeedB ^ seed} {}
+
+  constexpr void push_back(const char c) {
+    word_ |= static_cast<std::uint64_t>(static_cast<unsigned char>(c))
+             << (8 * (length_ % 8));
+    if (++length_ % 8 == 0) {
+      mix(word_);
+      word_ = 0;
+    }
+  }
+
+  constexpr Hasher& append(const std::string_view str) {
+    size_t i = 0;
+    // Fill the pending word first, then consume whole words
+    for (; i < str.size() && length_ % 8; ++i) {
+      push_back(str[i]);
+    }
+    for (; i + 8 <= str.size(); i += 8) {
+      std::uint64_t word = 0;
+      for (size_t j = 0; j < 8; ++j) {
+        word |= static_cast<std::uint64_t>(
+                    static_cast<unsigned char>(str[i + j])) << (8 * j);
+      }
+      mix(word);
+      length_ += 8;
+    }
+    for (; i < str.size(); ++i) {
+      push_back(str[i]);
+    }
+    return *this;
+  }
+  constexpr Hasher& append(const size_t count, const char c) {
+    for (size_t i = 0; i < count; ++i) {
+      push_back(c);
+    }
+    return *this;
+  }
+
+  constexpr std::uint64_t digest() const {
+    return finish().a_;
+  }
+  constexpr Hash128 digest128() const {
+    const Hasher h = finish();
+    return {h.a_, h.b_};
+  }
+
+private:
+  static constexpr std::uint64_t kSeedA = 0x243F6A8885A308D3ull;
+  static constexpr std::uint64_t kSeedB = 0x13198A2E03707344ull;
+  static constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+  static constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+  static constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ull;
+
+  static constexpr std::uint64_t rotl(const std::uint64_t x, const int r) {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  // Reference: MurmurHash3 64-bit finalizer
+  static constexpr std::uint64_t fmix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+  }
+
+  constexpr void mix(const std::uint64_t word) {
+    a_ = rotl(a_ ^ (word * kPrime1), 31) * kPrime2 + kPrime3;
+    b_ = rotl(b_ ^ (word * kPrime2), 27) * kPrime1 + kPrime3;
+  }
+
+  constexpr Hasher finish() const {
+    Hasher h{*this};
+    h.mix(h.word_ ^ (static_cast<std::uint64_t>(h.length_) << 56));
+    h.a_ = fmix(h.a_ ^ h.length_);
+    h.b_ = fmix(h.b_ + h.a_);
+    h.a_ += h.b_;
+    return h;
+  }
+
+  std::uint64_t a_ = kSeedA;
+  std::uint64_t b_ = kSeedB;
+  std::uint64_t word_ = 0;
+  std::uint64_t length_ = 0;
+};
+
+inline std::uint64_t Hash(const std::string_view str) {
+  return Hasher{}.append(str).digest();
+}
+
+}  // namespace hypp::detail
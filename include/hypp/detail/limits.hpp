@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <type_traits>
 
 namespace hypp::detail::limits {
 
@@ -36,33 +37,61 @@ namespace hypp::detail::limits {
 #define EXACTLY(x) (x)
 #define ARBITRARY(x) (x)
 
-constexpr size_t kMaxLimit = ARBITRARY(std::numeric_limits<std::uint16_t>::max());
+// The default limits policy. Parse functions take the policy as a template
+// parameter, so a stricter or more lenient policy can be declared by deriving
+// from this one and hiding some of its members:
+//
+//   struct EdgeLimits : hypp::DefaultLimits {
+//     static constexpr size_t kFieldValue = 1024;
+//   };
+//
+//   hypp::ParseRequest<EdgeLimits>(view);
+struct Default {
+  static constexpr size_t kMaxLimit = ARBITRARY(std::numeric_limits<std::uint16_t>::max());
+
+  // Generic
+  static constexpr size_t kHttpName     = EXACTLY(4);     // "HTTP"
+  static constexpr size_t kBody         = kMaxLimit;
+
+  // Request line
+  static constexpr size_t kRequestLine  = kMaxLimit;
+  static constexpr size_t kHttpVersion  = EXACTLY(8);     // "HTTP/1.1"
+  static constexpr size_t kMethod       = ARBITRARY(64);  // "GET", "POST", "UPDATEREDIRECTREF", etc.
+
+  // Status line
+  static constexpr size_t kStatusLine   = kMaxLimit;
+  static constexpr size_t kStatusCode   = EXACTLY(3);     // "200", "404", etc.
+  static constexpr size_t kReasonPhrase = ARBITRARY(64);  // "OK", "Bad Request", "Network Authentication Required", etc.
+
+  // Header fields
+  static constexpr size_t kHeaderFields = kMaxLimit;
+  static constexpr size_t kFieldName    = kMaxLimit;
+  static constexpr size_t kFieldValue   = kMaxLimit;
+
+  // URI
+  static constexpr size_t kURI          = kMaxLimit;
+  static constexpr size_t kScheme       = ARBITRARY(64);  // "http", "https", "file", "ftp", "mailto", "tel", etc.
+  static constexpr size_t kPort         = ARBITRARY(16);  // "80", "8888", etc.
+};
 
-// Generic
-constexpr size_t kHttpName     = EXACTLY(4);     // "HTTP"
-constexpr size_t kBody         = kMaxLimit;
+#undef EXACTLY
+#undef ARBITRARY
 
-// Request line
-constexpr size_t kRequestLine  = kMaxLimit;
-constexpr size_t kHttpVersion  = EXACTLY(8);     // "HTTP/1.1"
-constexpr size_t kMethod       = ARBITRARY(64);  // "GET", "POST", "UPDATEREDIRECTREF", etc.
+// The smallest unsigned type that can count up to `N`. Scanners that are
+// bounded by a limit use it as their counter.
+template <size_t N>
+using counter_t =
+    std::conditional_t<(N <= std::numeric_limits<std::uint8_t>::max()),
+                       std::uint8_t,
+    std::conditional_t<(N <= std::numeric_limits<std::uint16_t>::max()),
+                       std::uint16_t,
+    std::conditional_t<(N <= std::numeric_limits<std::uint32_t>::max()),
+                       std::uint32_t, size_t>>>;
 
-// Status line
-constexpr size_t kStatusLine   = kMaxLimit;
-constexpr size_t kStatusCode   = EXACTLY(3);     // "200", "404", etc.
-constexpr size_t kReasonPhrase = ARBITRARY(64);  // "OK", "Bad Request", "Network Authentication Required", etc.
+}  // namespace hypp::detail::limits
 
-// Header fields
-constexpr size_t kHeaderFields = kMaxLimit;
-constexpr size_t kFieldName    = kMaxLimit;
-constexpr size_t kFieldValue   = kMaxLimit;
+namespace hypp {
 
-// URI
-constexpr size_t kURI          = kMaxLimit;
-constexpr size_t kScheme       = ARBITRARY(64);  // "http", "https", "file", "ftp", "mailto", "tel", etc.
-constexpr size_t kPort         = ARBITRARY(16);  // "80", "8888", etc.
+using DefaultLimits = detail::limits::Default;
 
-#undef EXACTLY
-#undef ARBITRARY
-
-}  // namespace hypp::detail::limits
+}  // namespace hypp
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hypp::detail {
+
+// A read-only memory mapping of a whole file
+class MappedFile {
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path) {
+    open(path);
+  }
+  ~MappedFile() {
+    close();
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept {
+    swap(other);
+  }
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      swap(other);
+    }
+    return *this;
+  }
+
+  bool is_open() const {
+    return open_;
+  }
+  std::string_view view() const {
+    return {static_cast<const char*>(data_), size_};
+  }
+
+  bool open(const std::string& path) {
+    close();
+#if defined(_WIN32)
+    const HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ,
+        FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+    LARGE_INTEGER size{};
+    if (::GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+      const HANDLE mapping = ::CreateFileMappingA(file, nullptr,
+          PAGE_READONLY, 0, 0, nullptr);
+      if (mapping) {
+        data_ = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);
+      }
+      size_ = data_ ? static_cast<size_t>(size.QuadPart) : 0;
+      open_ = data_ != nullptr;
+    } else {
+      open_ = size.QuadPart == 0;
+    }
+    ::CloseHandle(file);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* const data = ::mmap(nullptr, static_cast<size_t>(st.st_size),
+                                PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = data;
+        size_ = static_cast<size_t>(st.st_size);
+        open_ = true;
+      }
+    } else {
+      // Empty files cannot be mapped, but are valid input
+      open_ = st.st_size == 0;
+    }
+    ::close(fd);
+#endif
+    return open_;
+  }
+
+  void close() {
+    if (data_) {
+#if defined(_WIN32)
+      ::UnmapViewOfFile(data_);
+#else
+      ::munmap(data_, size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+  }
+
+private:
+  void swap(MappedFile& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(open_, other.open_);
+  }
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+};
+
+}  // namespace hypp::detail
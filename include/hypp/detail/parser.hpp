@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <functional>
 #include <string_view>
+#include <type_traits>
+
+#include <hypp/detail/limits.hpp>
 
 namespace hypp::detail {
 
@@ -42,11 +45,12 @@ public:
     return std::distance(v_.begin(), it);
   }
   size_t count(size_t n, const func_t f) const {
-    view_t v{v_.substr(0, n)};
+    const view_t bounded{v_.substr(0, n)};
+    view_t v{bounded};
     while (!v.empty() && (n = f(v))) {
       v.remove_prefix(n);
     }
-    return v_.size() - v.size();
+    return bounded.size() - v.size();
   }
 
   char match(const pred_t p) {
@@ -61,6 +65,43 @@ public:
   view_t match(const size_t n, const func_t f) {
     return read(count(n, f));
   }
+  // Same as `match(N, p)`, with the limit known at compile time. The counter is
+  // the smallest type that can hold `N`.
+  // Also takes a function like `match(N, f)`.
+  template <size_t N, typename Predicate>
+  view_t match(const Predicate p) {
+    if constexpr (std::is_invocable_v<Predicate, const view_t>) {
+      return match<N>([](const char) { return false; }, p);
+    } else {
+      using counter_t = limits::counter_t<N>;
+      const auto n = static_cast<counter_t>(std::min<size_t>(N, v_.size()));
+      counter_t i = 0;
+      while (i < n && p(v_[i])) {
+        ++i;
+      }
+      return read(i);
+    }
+  }
+  // Same as `match(N, p, f)`, with the limit known at compile time.
+  template <size_t N, typename Predicate, typename Function>
+  view_t match(const Predicate p, const Function f) {
+    using counter_t = limits::counter_t<N>;
+    const auto n = static_cast<counter_t>(std::min<size_t>(N, v_.size()));
+    counter_t i = 0;
+    while (i < n) {
+      if (p(v_[i])) {
+        ++i;
+        continue;
+      }
+      // `f` only sees the bytes within the limit
+      const auto size = f(v_.substr(i, n - i));
+      if (!size) {
+        break;
+      }
+      i = static_cast<counter_t>(i + size);
+    }
+    return read(i);
+  }
   view_t match(const size_t n, const pred_t p, const func_t f) {
     const auto f_both = [&](const view_t v) {
       return p(v.front()) ? size_t{1} : f(v);
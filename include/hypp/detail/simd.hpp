@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HYPP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <hypp/detail/syntax.hpp>
+
+namespace hypp::detail::simd {
+
+// Returns the number of trailing zero bits. `value` must not be zero.
+inline unsigned count_trailing_zeros(const std::uint32_t value) {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+// Returns a pointer to the first occurrence of either `a` or `b`, or `last`.
+inline const char* find_first_of(const char* first, const char* last,
+                                 const char a, const char b) {
+#if defined(HYPP_SSE2)
+  const __m128i va = _mm_set1_epi8(a);
+  const __m128i vb = _mm_set1_epi8(b);
+  for (; last - first >= 16; first += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, va),
+                                    _mm_cmpeq_epi8(v, vb));
+    const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+    if (mask) {
+      return first + count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+  while (first != last && *first != a && *first != b) {
+    ++first;
+  }
+  return first;
+}
+
+// Returns a pointer to the first character that is not unreserved, or `last`.
+//
+// unreserved = ALPHA / DIGIT / "-" / "." / "_" / "~"
+inline const char* find_first_not_unreserved(const char* first,
+                                             const char* last) {
+#if defined(HYPP_SSE2)
+  // Characters with the high bit set compare as negative, so they never fall
+  // into any of the ranges below.
+  const auto in_range = [](const __m128i v, const char lo, const char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+  };
+  const auto equals = [](const __m128i v, const char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+  };
+
+  for (; last - first >= 16; first += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i alpha = in_range(lower, 'a', 'z');
+    const __m128i digit = in_range(v, '0', '9');
+    const __m128i marks = _mm_or_si128(
+        _mm_or_si128(equals(v, '-'), equals(v, '.')),
+        _mm_or_si128(equals(v, '_'), equals(v, '~')));
+    const __m128i ok = _mm_or_si128(_mm_or_si128(alpha, digit), marks);
+    const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(ok));
+    if (mask != 0xFFFF) {
+      return first + count_trailing_zeros(~mask & 0xFFFF);
+    }
+  }
+#endif
+
+  while (first != last && is_unreserved(*first)) {
+    ++first;
+  }
+  return first;
+}
+
+}  // namespace hypp::detail::simd
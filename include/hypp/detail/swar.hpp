@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace hypp::detail::swar {
+
+// Loads 8 bytes so that the first character is in the lowest byte. Compilers
+// turn this into a single load on little-endian targets.
+constexpr std::uint64_t load64(const char* data) {
+  std::uint64_t word = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i]))
+            << (8 * i);
+  }
+  return word;
+}
+
+// Returns true if all 8 bytes are ASCII digits.
+constexpr bool is_eight_digits(const std::uint64_t word) {
+  // Digits are 0x30-0x39, so their high nibble is 3, and adding 6 does not
+  // carry into it.
+  return ((word & 0xF0F0F0F0F0F0F0F0) |
+          (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// Converts 8 ASCII digits (first digit in the lowest byte) to their value.
+constexpr std::uint32_t parse_eight_digits(std::uint64_t word) {
+  word -= 0x3030303030303030;
+  word = (word * 10) + (word >> 8);  // pairs of digits
+  word = (((word & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+          (((word >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+  return static_cast<std::uint32_t>(word);
+}
+
+// Parses a non-empty sequence of ASCII digits, 8 at a time. Returns nothing if
+// there are other characters, or if the value does not fit in 64 bits.
+constexpr std::optional<std::uint64_t> parse_digits(std::string_view digits) {
+  // Values of up to 19 digits always fit
+  constexpr size_t kMaxDigits = 19;
+
+  if (digits.empty()) {
+    return std::nullopt;
+  }
+  while (digits.size() > 1 && digits.front() == '0') {
+    digits.remove_prefix(1);
+  }
+  if (digits.size() > kMaxDigits) {
+    return std::nullopt;
+  }
+
+  std::uint64_t value = 0;
+  for (; digits.size() >= 8; digits.remove_prefix(8)) {
+    const auto word = load64(digits.data());
+    if (!is_eight_digits(word)) {
+      return std::nullopt;
+    }
+    value = value * 100000000 + parse_eight_digits(word);
+  }
+  for (const char c : digits) {
+    if (c < '0' || c > '9') {
+      return std::nullopt;
+    }
+    value = value * 10 + static_cast<std::uint64_t>(c - '0');
+  }
+  return value;
+}
+
+}  // namespace hypp::detail::swar
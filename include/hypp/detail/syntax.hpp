@@ -77,6 +77,13 @@ constexpr bool is_vchar(const char c) {
   return 0x21 <= c && c <= 0x7E;
 }
 
+// field-vchar / SP / HTAB, i.e. anything but control characters other than
+// HTAB. A value that is made of these cannot end the header field early.
+constexpr bool is_field_value_char(const char c) {
+  const auto u = static_cast<unsigned char>(c);
+  return (0x20 <= u && u != 0x7F) || c == syntax::kHTAB;
+}
+
 // gen-delims = ":" / "/" / "?" / "#" / "[" / "]" / "@"
 //            ; delimiters of the generic URI components
 constexpr bool is_gen_delim(const char c) {
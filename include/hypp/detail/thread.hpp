@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hypp::detail {
+
+inline size_t ThreadCount(const size_t threads) {
+  return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Worker threads that are shared by all parallel loops, so that a loop does
+// not create and join threads on every call. Workers are started when they
+// are first needed, and run until the process exits.
+class ThreadPool {
+public:
+  static ThreadPool& instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      stop_ = true;
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Queues `job` to run once on each of `n` workers.
+  void post(const size_t n, const std::function<void()>& job) {
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      while (workers_.size() < n) {
+        workers_.emplace_back([this] { run(); });
+      }
+      jobs_.insert(jobs_.end(), n, job);
+    }
+    ready_.notify_all();
+  }
+
+  // Returns the number of workers that have been started.
+  size_t size() {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    return workers_.size();
+  }
+
+private:
+  ThreadPool() = default;
+
+  void run() {
+    for (;;) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        ready_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (stop_) {
+          return;
+        }
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+      }
+      job();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> jobs_;
+  std::vector<std::thread> workers_;
+  bool stop_ = false;
+};
+
+// Calls `function(begin, end)` for chunks of [0, count) on up to `threads`
+// threads, including the calling thread. Chunks are claimed from a shared
+// counter, so threads that finish early take over the remaining work instead
+// of idling behind a static partition.
+//
+// The other threads are workers of the ThreadPool. A worker may only start
+// after the calling thread has claimed every chunk, e.g. when the workers are
+// busy with another loop, so the loop never waits for a worker that has not
+// started, and a worker that starts late returns without calling `function`.
+template <typename Function>
+void ParallelFor(const size_t count, const size_t chunk_size,
+                 const size_t threads, const Function& function) {
+  const size_t chunk = std::max<size_t>(chunk_size, 1);
+  const size_t chunks = (count + chunk - 1) / chunk;
+
+  struct State {
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable idle;
+    size_t active = 0;  // workers that may still call `function`
+  };
+  const auto state = std::make_shared<State>();
+
+  // Claiming a chunk is an acquire-release operation, so that a worker that
+  // claims one is counted as active before the calling thread claims the last
+  const auto work = [state, chunk, chunks, count, &function]() {
+    for (size_t i;
+         (i = state->next.fetch_add(1, std::memory_order_acq_rel)) < chunks; ) {
+      function(i * chunk, std::min(count, (i + 1) * chunk));
+    }
+  };
+
+  const size_t n = std::min(ThreadCount(threads), chunks);
+  if (n > 1) {
+    ThreadPool::instance().post(n - 1, [state, work]() {
+      {
+        const std::lock_guard<std::mutex> lock{state->mutex};
+        ++state->active;
+      }
+      work();
+      {
+        const std::lock_guard<std::mutex> lock{state->mutex};
+        --state->active;
+      }
+      state->idle.notify_all();
+    });
+  }
+  work();
+
+  std::unique_lock<std::mutex> lock{state->mutex};
+  state->idle.wait(lock, [&state] { return !state->active; });
+}
+
+}  // namespace hypp::detail
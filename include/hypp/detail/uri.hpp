@@ -1,65 +1,266 @@
 #pragma once
 
+#include <array>
+#include <cstring>
+#include <iterator>
 #include <string>
 #include <string_view>
 
+#include <hypp/detail/simd.hpp>
+#include <hypp/detail/syntax.hpp>
+
 namespace hypp::detail::uri {
 
-inline std::string decode(const std::string_view str) {
+// Reference: https://tools.ietf.org/html/rfc3986#section-2.1
+
+namespace table {
+
+// Value of each HEXDIG (case-insensitive), or -1
+constexpr auto kHexValue = [] {
+  std::array<signed char, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    table[c] = ('0' <= c && c <= '9') ? static_cast<signed char>(c - '0') :
+               ('A' <= c && c <= 'F') ? static_cast<signed char>(c - 'A' + 10) :
+               ('a' <= c && c <= 'f') ? static_cast<signed char>(c - 'a' + 10) :
+               -1;
+  }
+  return table;
+}();
+
+// > For consistency, URI producers and normalizers should use uppercase
+// hexadecimal digits for all percent-encodings.
+// Reference: https://tools.ietf.org/html/rfc3986#section-2.1
+constexpr auto kHexDigits = "0123456789ABCDEF";
+
+}  // namespace table
+
+constexpr int hex_value(const char c) {
+  return table::kHexValue[static_cast<unsigned char>(c)];
+}
+
+// Returns the octet of a valid pct-encoded triplet at the beginning of `p`, or
+// -1. `p` must have at least 3 characters available.
+constexpr int decode_triplet(const char* p) {
+  if (p[0] != '%') return -1;
+  const int hi = hex_value(p[1]);
+  const int lo = hex_value(p[2]);
+  return (hi | lo) < 0 ? -1 : (hi << 4) | lo;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Exact size of the encoded output, so that callers can allocate once
+inline size_t encoded_size(const std::string_view str) {
+  const char* first = str.data();
+  const char* const last = first + str.size();
+  size_t size = str.size();
+  while ((first = simd::find_first_not_unreserved(first, last)) != last) {
+    size += 2;
+    ++first;
+  }
+  return size;
+}
+
+// Appends the encoded form of `str` to `output`. Every octet except for
+// unreserved characters is percent-encoded.
+inline void encode(const std::string_view str, std::string& output) {
+  const size_t offset = output.size();
+  output.resize(offset + encoded_size(str));
+
+  char* out = output.data() + offset;
+  const char* first = str.data();
+  const char* const last = first + str.size();
+
+  while (first != last) {
+    const char* const run = simd::find_first_not_unreserved(first, last);
+    std::memcpy(out, first, run - first);
+    out += run - first;
+    first = run;
+    if (first != last) {
+      const auto c = static_cast<unsigned char>(*first++);
+      *out++ = '%';
+      *out++ = table::kHexDigits[c >> 4];
+      *out++ = table::kHexDigits[c & 0x0F];
+    }
+  }
+}
+
+inline std::string encode(const std::string_view str) {
   std::string output;
+  encode(str, output);
+  return output;
+}
 
-  constexpr auto digits = "0123456789ABCDEF";
-  constexpr auto is_xdigit = [](const char c) {
-    return ('0' <= c && c <= '9') ||
-           ('A' <= c && c <= 'F') ||
-           ('a' <= c && c <= 'f');
-  };
-  const auto is_encoded = [&](const size_t i) {
-    return str[i] == '%' &&
-           i + 2 < str.size() &&
-           is_xdigit(str[i + 1]) &&
-           is_xdigit(str[i + 2]);
-  };
+////////////////////////////////////////////////////////////////////////////////
 
-  for (size_t i = 0; i < str.size(); ++i) {
-    if (!is_encoded(i)) {
-      output.push_back(str[i]);
+// Invalid pct-encoded triplets are left as-is.
+inline size_t decoded_size(const std::string_view str) {
+  size_t size = str.size();
+  for (auto pos = str.find('%'); pos != str.npos; pos = str.find('%', pos)) {
+    if (pos + 2 < str.size() && decode_triplet(str.data() + pos) >= 0) {
+      size -= 2;
+      pos += 3;
     } else {
-      char c = 0;
-      for (char j = 0; j < 16; ++j) {
-        if (str[i + 1] == digits[j]) c += j << 4;
-        if (str[i + 2] == digits[j]) c += j;
+      pos += 1;
+    }
+  }
+  return size;
+}
+
+// Decodes `size` characters at `data` in place, and returns the new size. The
+// output is never longer than the input, so it can safely overwrite it.
+inline size_t decode_in_place(char* const data, const size_t size) {
+  const char* const end = data + size;
+  const char* first = static_cast<const char*>(std::memchr(data, '%', size));
+  if (!first) {
+    return size;
+  }
+
+  char* out = const_cast<char*>(first);
+  while (first != end) {
+    if (end - first > 2) {
+      if (const int c = decode_triplet(first); c >= 0) {
+        *out++ = static_cast<char>(c);
+        first += 3;
+      } else {
+        *out++ = *first++;
       }
-      output.push_back(c);
-      i += 2;
+    } else {
+      *out++ = *first++;
     }
+    // Copy the run up to the next "%" at once
+    const auto* next = static_cast<const char*>(
+        std::memchr(first, '%', end - first));
+    const char* const run_end = next ? next : end;
+    std::memmove(out, first, run_end - first);
+    out += run_end - first;
+    first = run_end;
   }
 
-  return output;
+  return out - data;
 }
 
-inline std::string encode(const std::string_view str) {
+inline void decode_in_place(std::string& str) {
+  str.resize(decode_in_place(str.data(), str.size()));
+}
+
+// Appends the decoded form of `str` to `output`.
+inline void decode(const std::string_view str, std::string& output) {
+  const size_t offset = output.size();
+  output.append(str);
+  output.resize(offset + decode_in_place(output.data() + offset, str.size()));
+}
+
+inline std::string decode(const std::string_view str) {
   std::string output;
+  decode(str, output);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// A lazily decoded view of a percent-encoded string. Iterating over it yields
+// decoded characters without allocating.
+//
+// If `plus_as_space` is set, "+" is decoded as SP, as in
+// application/x-www-form-urlencoded data.
+// Reference: https://url.spec.whatwg.org/#application/x-www-form-urlencoded
+class DecodeView {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = char;
+
+    constexpr iterator() = default;
+    constexpr iterator(const char* first, const char* last,
+                       const bool plus_as_space)
+        : first_{first}, last_{last}, plus_as_space_{plus_as_space} {}
+
+    constexpr char operator*() const {
+      const int c = width() == 3 ? decode_triplet(first_) : -1;
+      if (c >= 0) return static_cast<char>(c);
+      return plus_as_space_ && *first_ == '+' ? ' ' : *first_;
+    }
+
+    constexpr iterator& operator++() {
+      first_ += width();
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      iterator it{*this};
+      ++*this;
+      return it;
+    }
+
+    constexpr bool operator==(const iterator& rhs) const {
+      return first_ == rhs.first_;
+    }
+    constexpr bool operator!=(const iterator& rhs) const {
+      return first_ != rhs.first_;
+    }
+
+  private:
+    constexpr size_t width() const {
+      return last_ - first_ > 2 && decode_triplet(first_) >= 0 ? 3 : 1;
+    }
 
-  constexpr auto digits = "0123456789ABCDEF";
-  constexpr auto safe = [](const char c) {
-    return ('0' <= c && c <= '9') ||
-           ('A' <= c && c <= 'Z') ||
-           ('a' <= c && c <= 'z') ||
-           c == '-' || c == '.' || c == '_' || c == '~';
+    const char* first_ = nullptr;
+    const char* last_ = nullptr;
+    bool plus_as_space_ = false;
   };
 
-  for (const auto c : str) {
-    if (safe(c)) {
-      output.push_back(c);
-    } else {
-      output.push_back('%');
-      output.push_back(digits[(c >> 4) & 0x0F]);
-      output.push_back(digits[c & 0x0F]);
+  constexpr DecodeView() = default;
+  constexpr explicit DecodeView(const std::string_view str,
+                                const bool plus_as_space = false)
+      : str_{str}, plus_as_space_{plus_as_space} {}
+
+  constexpr iterator begin() const {
+    return {str_.data(), str_.data() + str_.size(), plus_as_space_};
+  }
+  constexpr iterator end() const {
+    const auto last = str_.data() + str_.size();
+    return {last, last, plus_as_space_};
+  }
+
+  constexpr bool empty() const {
+    return str_.empty();
+  }
+  constexpr std::string_view encoded() const {
+    return str_;
+  }
+  size_t size() const {
+    return decoded_size(str_);
+  }
+
+  bool operator==(const std::string_view rhs) const {
+    auto it = begin();
+    for (const char c : rhs) {
+      if (it == end() || *it != c) return false;
+      ++it;
     }
+    return it == end();
+  }
+  bool operator!=(const std::string_view rhs) const {
+    return !(*this == rhs);
   }
 
-  return output;
-}
+  std::string to_string() const {
+    return plus_as_space_ ? std::string(begin(), end()) : decode(str_);
+  }
+
+private:
+  std::string_view str_;
+  bool plus_as_space_ = false;
+};
 
 }  // namespace hypp::detail::uri
+
+namespace hypp {
+
+using DecodeView = detail::uri::DecodeView;
+
+}  // namespace hypp
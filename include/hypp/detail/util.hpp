@@ -15,6 +15,19 @@ std::string concat(const Ts&... args) {
   return (std::string{} + ... + args);
 }
 
+constexpr char to_lower(const char c) {
+  return ('A' <= c && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+constexpr bool equals_ignore_case(const std::string_view lhs,
+                                  const std::string_view rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (to_lower(lhs[i]) != to_lower(rhs[i])) return false;
+  }
+  return true;
+}
+
 template <typename T>
 T from_chars(const std::string_view str) {
   T value{0};
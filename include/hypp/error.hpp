@@ -12,6 +12,7 @@ namespace hypp {
 // protocol require different error handling strategies.
 // Reference: https://tools.ietf.org/html/rfc7230#section-2.5
 
+// New values are added at the end, so that existing values keep their numbers.
 enum class Error {
   // HTTP status codes
   Bad_Request,
@@ -48,8 +49,22 @@ enum class Error {
   // HTTP version
   Invalid_HTTP_Name,
   Invalid_HTTP_Version,
+
+  // Framing
+  Invalid_Content_Length,
+  Invalid_Transfer_Encoding,
+
+  // Media type
+  Invalid_Media_Type,
+
+  // Connection
+  Connection_Closed,  // closed before the first byte of a message
 };
 
+// Number of Error values. Keep in sync with the last enumerator above.
+constexpr size_t kErrorCount =
+    static_cast<size_t>(Error::Connection_Closed) + 1;
+
 using Unexpected = detail::Unexpected<Error>;
 
 template <typename T>
@@ -97,6 +112,14 @@ inline std::string to_string(const Error error) {
       return "Invalid HTTP Name";
     case Error::Invalid_HTTP_Version:
       return "Invalid HTTP Version";
+    case Error::Invalid_Content_Length:
+      return "Invalid Content Length";
+    case Error::Invalid_Transfer_Encoding:
+      return "Invalid Transfer Encoding";
+    case Error::Invalid_Media_Type:
+      return "Invalid Media Type";
+    case Error::Connection_Closed:
+      return "Connection Closed";
     default:
       return "Unknown Error";
   }
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <hypp/detail/hash.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/generator/header.hpp>
+#include <hypp/generator/request.hpp>
+#include <hypp/generator/response.hpp>
+#include <hypp/buffer.hpp>
+#include <hypp/header.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+
+namespace hypp {
+
+// Serializes messages back to back, e.g. requests that are pipelined on one
+// connection, so that they can be sent with a single write. The output is the
+// same as concatenating to_string() of each message.
+//
+// Header sections that are identical to one that was added before are
+// serialized only once, and are shared between the messages. Bodies are not
+// copied, so they must stay valid until the batch is cleared. The exact size
+// of the output is known before it is written, so it takes one allocation.
+template <typename MessageT>
+class MessageBatch {
+public:
+  void add(const MessageT& message) {
+    Entry entry;
+    const auto start_line = hypp::to_string(message.start_line);
+    entry.start_line = {text_.size(), start_line.size()};
+    text_.append(start_line);
+    entry.header_block = add_header_block(message.header_fields);
+    entry.body = message.body;
+    bytes_ += entry.start_line.size + blocks_[entry.header_block].size +
+              entry.body.size();
+    entries_.push_back(entry);
+  }
+
+  // Returns the number of messages.
+  size_t size() const {
+    return entries_.size();
+  }
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  // Returns the number of distinct header sections.
+  size_t header_block_count() const {
+    return blocks_.size();
+  }
+
+  // Returns the exact size of the output.
+  size_t bytes() const {
+    return bytes_;
+  }
+
+  // Appends the messages to `output`.
+  void write(std::string& output) const {
+    output.reserve(output.size() + bytes_);
+    for (const auto& entry : entries_) {
+      output.append(view(entry.start_line));
+      output.append(view(blocks_[entry.header_block]));
+      output.append(entry.body);
+    }
+  }
+
+  std::string to_string() const {
+    std::string output;
+    write(output);
+    return output;
+  }
+
+  // Returns the messages as buffers that point into the batch and the bodies
+  // of the messages, for a gather write. Shared header sections are
+  // referenced rather than repeated. The buffers are valid until the batch is
+  // changed.
+  ConstBuffers buffers() const {
+    ConstBuffers buffers;
+    buffers.reserve(entries_.size() * 3);
+    for (const auto& entry : entries_) {
+      AppendBuffer(buffers, view(entry.start_line));
+      AppendBuffer(buffers, view(blocks_[entry.header_block]));
+      AppendBuffer(buffers, entry.body);
+    }
+    return buffers;
+  }
+
+  void clear() {
+    text_.clear();
+    entries_.clear();
+    blocks_.clear();
+    block_index_.clear();
+    bytes_ = 0;
+  }
+
+private:
+  struct Span {
+    size_t offset = 0;  // in text_
+    size_t size = 0;
+  };
+
+  struct Entry {
+    Span start_line;
+    size_t header_block = 0;
+    std::string_view body;
+  };
+
+  std::string_view view(const Span span) const {
+    return std::string_view{text_}.substr(span.offset, span.size);
+  }
+
+  // *( header-field CRLF ) CRLF
+  size_t add_header_block(const HeaderFields& header_fields) {
+    using namespace detail::syntax;
+
+    // header-field = field-name ":" SP field-value
+    size_t size = 2;
+    detail::Hasher hasher;
+    for (const auto& header_field : header_fields) {
+      size += header_field.name.size() + header_field.value.size() + 4;
+      hasher.append(header_field.name).append(1, ':');
+      hasher.append(header_field.value).append(1, '\n');
+    }
+    const auto hash = hasher.digest();
+
+    // Header sections are compared with the serialized ones, so that
+    // identical ones are found without serializing or keeping their fields
+    const auto range = block_index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (blocks_[it->second].size == size &&
+          equals(header_fields, view(blocks_[it->second]))) {
+        return it->second;
+      }
+    }
+
+    blocks_.push_back({text_.size(), size});
+    for (const auto& header_field : header_fields) {
+      text_.append(header_field.name).append(1, ':').append(1, kSP);
+      text_.append(header_field.value).append(kCRLF);
+    }
+    text_.append(kCRLF);
+    block_index_.emplace(hash, blocks_.size() - 1);
+    return blocks_.size() - 1;
+  }
+
+  // Returns true if `block` is the serialization of `header_fields`.
+  static bool equals(const HeaderFields& header_fields,
+                     std::string_view block) {
+    using namespace detail::syntax;
+    const auto skip = [&block](const std::string_view text) {
+      if (block.substr(0, text.size()) != text) {
+        return false;
+      }
+      block.remove_prefix(text.size());
+      return true;
+    };
+    for (const auto& header_field : header_fields) {
+      if (!skip(header_field.name) || !skip(": ") ||
+          !skip(header_field.value) || !skip(kCRLF)) {
+        return false;
+      }
+    }
+    return block == kCRLF;
+  }
+
+  std::string text_;  // start lines and header sections
+  std::vector<Entry> entries_;
+  std::vector<Span> blocks_;
+  std::unordered_multimap<std::uint64_t, size_t> block_index_;
+  size_t bytes_ = 0;
+};
+
+using RequestBatch = MessageBatch<Request>;
+using ResponseBatch = MessageBatch<Response>;
+
+}  // namespace hypp
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/parser.hpp>
+#include <hypp/generator/header.hpp>
+#include <hypp/parser/media_type.hpp>
+#include <hypp/buffer.hpp>
+#include <hypp/header.hpp>
+
+namespace hypp {
+
+namespace detail {
+
+// chunk-ext      = *( ";" chunk-ext-name [ "=" chunk-ext-val ] )
+// chunk-ext-name = token
+// chunk-ext-val  = token / quoted-string
+// Reference: https://tools.ietf.org/html/rfc7230#section-4.1.1
+//
+// Returns true if `extension` is empty, or a chunk-ext without its leading
+// ";", e.g. "name=value" or "a;b=\"c d\"".
+inline bool IsChunkExtension(const std::string_view extension) {
+  Parser parser{extension};
+  if (parser.empty()) {
+    return true;
+  }
+  do {
+    if (parser.match(extension.size(), is_tchar).empty()) {
+      return false;
+    }
+    if (parser.skip('=') &&
+        parser.match(extension.size(), is_tchar).empty() &&
+        !ParseQuotedString(parser)) {
+      return false;
+    }
+  } while (parser.skip(';'));
+  return parser.empty();
+}
+
+}  // namespace detail
+
+// Encodes a body with the chunked transfer coding as it is generated, for
+// messages whose length is not known in advance.
+//
+// chunked-body = *chunk last-chunk trailer-part CRLF
+// Reference: https://tools.ietf.org/html/rfc7230#section-4.1
+//
+// Small writes are collected into chunks of `chunk_size` bytes, so that
+// writing byte by byte does not produce a chunk for each byte. The encoded
+// output is available as buffers that can be sent with a single gather write,
+// after which clear() makes room for more. Once the body is finished, writes
+// and flushes are ignored, so that no chunk follows the last chunk.
+//
+// Chunk extensions are validated, so that they cannot end the chunk-size line
+// early. Functions that take one return false, and write nothing, if it is
+// invalid.
+class ChunkedEncoder {
+public:
+  static constexpr size_t kDefaultChunkSize = 8 * 1024;
+
+  explicit ChunkedEncoder(const size_t chunk_size = kDefaultChunkSize)
+      : chunk_size_{std::max<size_t>(chunk_size, 1)} {}
+
+  // Copies `data` into the current chunk, and completes each chunk that
+  // reaches the chunk size.
+  void write(std::string_view data) {
+    if (finished_) {
+      return;
+    }
+    while (!data.empty()) {
+      const auto size = std::min(data.size(), chunk_size_ - open_size());
+      data_.append(data.data(), size);
+      data.remove_prefix(size);
+      if (open_size() == chunk_size_) {
+        flush();
+      }
+    }
+  }
+
+  // Writes `data` as a chunk of its own without copying it, after completing
+  // the current chunk. `data` must stay valid until clear() is called. This is
+  // meant for large blocks, which would not benefit from batching.
+  bool write_view(const std::string_view data,
+                  const std::string_view extension = {}) {
+    if (!detail::IsChunkExtension(extension)) {
+      return false;
+    }
+    if (finished_) {
+      return true;
+    }
+    flush();
+    if (!data.empty()) {
+      append_size_line(data.size(), extension);
+      append_segment({Segment::Kind::View, 0, data.size(), data.data()});
+      append_view(detail::syntax::kCRLF);
+    }
+    return true;
+  }
+
+  // Completes the current chunk, even if it is smaller than the chunk size.
+  // `extension` is appended to its chunk-size, e.g. "name=value".
+  //
+  // chunk = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
+  bool flush(const std::string_view extension = {}) {
+    if (!detail::IsChunkExtension(extension)) {
+      return false;
+    }
+    if (finished_ || !open_size()) {
+      return true;
+    }
+    append_size_line(open_size(), extension);
+    append_segment({Segment::Kind::Data, open_begin_, open_size()});
+    append_view(detail::syntax::kCRLF);
+    open_begin_ = data_.size();
+    return true;
+  }
+
+  // Completes the body, with optional trailer fields.
+  //
+  // last-chunk = 1*("0") [ chunk-ext ] CRLF
+  // trailer-part = *( header-field CRLF )
+  bool finish(const HeaderFields& trailers = {},
+              const std::string_view extension = {}) {
+    using namespace detail::syntax;
+    if (!detail::IsChunkExtension(extension)) {
+      return false;
+    }
+    if (finished_) {
+      return true;
+    }
+    flush();
+    const auto begin = meta_.size();
+    meta_ += '0';
+    append_extension(extension);
+    meta_ += kCRLF;
+    meta_ += to_string(trailers);
+    meta_ += kCRLF;
+    append_segment({Segment::Kind::Meta, begin, meta_.size() - begin});
+    finished_ = true;
+    return true;
+  }
+
+  bool finished() const {
+    return finished_;
+  }
+
+  // Returns the number of bytes of complete chunks that are ready to be sent.
+  size_t size() const {
+    return size_;
+  }
+
+  // Returns the complete chunks. Bytes of the current chunk are not included
+  // until it is completed. The buffers are valid until the encoder is changed.
+  ConstBuffers buffers() const {
+    ConstBuffers buffers;
+    buffers.reserve(segments_.size());
+    for (const auto& segment : segments_) {
+      switch (segment.kind) {
+        case Segment::Kind::Meta:
+          AppendBuffer(buffers, {meta_.data() + segment.offset, segment.size});
+          break;
+        case Segment::Kind::Data:
+          AppendBuffer(buffers, {data_.data() + segment.offset, segment.size});
+          break;
+        case Segment::Kind::View:
+          AppendBuffer(buffers, {segment.view, segment.size});
+          break;
+      }
+    }
+    return buffers;
+  }
+
+  // Discards the complete chunks, e.g. after they were sent. The current chunk
+  // is kept.
+  void clear() {
+    segments_.clear();
+    size_ = 0;
+    meta_.clear();
+    data_.erase(0, open_begin_);
+    open_begin_ = 0;
+  }
+
+private:
+  struct Segment {
+    enum class Kind {
+      Meta,  // in meta_
+      Data,  // in data_
+      View,  // not owned
+    };
+
+    Kind kind = Kind::Meta;
+    size_t offset = 0;
+    size_t size = 0;
+    const char* view = nullptr;
+  };
+
+  size_t open_size() const {
+    return data_.size() - open_begin_;
+  }
+
+  // chunk-size = 1*HEXDIG
+  void append_size_line(const size_t size, const std::string_view extension) {
+    const auto begin = meta_.size();
+    char digits[16];
+    const auto result = std::to_chars(digits, digits + sizeof(digits),
+                                      static_cast<std::uint64_t>(size), 16);
+    meta_.append(digits, result.ptr);
+    append_extension(extension);
+    meta_ += detail::syntax::kCRLF;
+    append_segment({Segment::Kind::Meta, begin, meta_.size() - begin});
+  }
+
+  // chunk-ext = *( ";" chunk-ext-name [ "=" chunk-ext-val ] )
+  void append_extension(const std::string_view extension) {
+    if (!extension.empty()) {
+      meta_ += ';';
+      meta_ += extension;
+    }
+  }
+
+  void append_view(const std::string_view view) {
+    append_segment({Segment::Kind::View, 0, view.size(), view.data()});
+  }
+
+  void append_segment(const Segment& segment) {
+    segments_.push_back(segment);
+    size_ += segment.size;
+  }
+
+  size_t chunk_size_;
+  std::string data_;  // chunk data, including the current chunk
+  std::string meta_;  // chunk-size lines and the last chunk
+  std::vector<Segment> segments_;
+  size_t size_ = 0;  // of the segments
+  size_t open_begin_ = 0;  // of the current chunk in data_
+  bool finished_ = false;
+};
+
+}  // namespace hypp
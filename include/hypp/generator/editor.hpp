@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/list.hpp>
+#include <hypp/buffer.hpp>
+#include <hypp/header.hpp>
+
+namespace hypp {
+
+// Edits a message without re-serializing it, e.g. to forward it through a
+// proxy. Edits are recorded as a list of patches against the original bytes,
+// and the output is a list of buffers that mostly point into the original
+// message, so that only changed lines are copied.
+//
+// The message must have been validated by the parser, and must stay alive
+// while the editor is in use. Everything after the header section (i.e. the
+// body as framed by the caller) is passed through as is.
+class MessageEditor {
+public:
+  struct Patch {
+    enum class Kind {
+      RemoveField,
+      ReplaceValue,
+      AddField,
+      ReplaceTarget,
+    };
+
+    Kind kind = Kind::RemoveField;
+    size_t field = 0;  // index of the original field
+    std::string text;  // the replacement bytes
+  };
+
+  explicit MessageEditor(const std::string_view message) {
+    using namespace detail::syntax;
+
+    // start-line = request-line / status-line
+    auto pos = message.find(kCRLF);
+    if (pos == message.npos) {
+      return;
+    }
+    start_line_ = message.substr(0, pos + 2);
+
+    // status-line = HTTP-version SP status-code SP reason-phrase CRLF
+    // request-line = method SP request-target SP HTTP-version CRLF
+    if (start_line_.substr(0, 5) != "HTTP/") {
+      const auto target_begin = start_line_.find(kSP);
+      const auto target_end = start_line_.rfind(kSP);
+      if (target_begin == start_line_.npos || target_end <= target_begin) {
+        return;
+      }
+      target_ = start_line_.substr(target_begin + 1,
+                                   target_end - target_begin - 1);
+    }
+
+    // *( header-field CRLF ) CRLF
+    pos += 2;
+    while (true) {
+      const auto end = message.find(kCRLF, pos);
+      if (end == message.npos) {
+        return;
+      }
+      if (end == pos) {
+        rest_ = message.substr(pos);  // CRLF [ message-body ]
+        break;
+      }
+      const auto line = message.substr(pos, end + 2 - pos);
+      pos = end + 2;
+
+      // obs-fold is rejected by the parser as well
+      const auto colon = line.find(':');
+      if (colon == line.npos || colon == 0 || line.front() == kSP ||
+          line.front() == kHTAB) {
+        return;
+      }
+      const auto name = line.substr(0, colon);
+      fields_.push_back({line, name, header::to_id(name)});
+    }
+
+    valid_ = true;
+  }
+
+  bool valid() const {
+    return valid_;
+  }
+  bool is_request() const {
+    return !target_.empty();
+  }
+
+  const std::vector<Patch>& patches() const {
+    return patches_;
+  }
+
+  // Returns the value of the first field named `name`, as it was originally.
+  std::optional<std::string_view> get(const std::string_view name) const {
+    for (const auto& field : fields_) {
+      if (matches(field, name, header::to_id(name))) {
+        return field.value();
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Removes all fields named `name`, and returns how many there were.
+  size_t remove(const std::string_view name) {
+    const auto id = header::to_id(name);
+    size_t count = 0;
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      if (matches(fields_[i], name, id)) {
+        patches_.push_back({Patch::Kind::RemoveField, i, {}});
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  // Replaces the value of the first field named `name` and removes the
+  // others, or adds the field if there is none. Returns false, without changing
+  // anything, if the field is invalid (see add()).
+  bool replace(const std::string_view name, const std::string_view value) {
+    if (!is_valid_field(name, value)) {
+      return false;
+    }
+    const auto id = header::to_id(name);
+    bool replaced = false;
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      if (!matches(fields_[i], name, id)) {
+        continue;
+      }
+      if (replaced) {
+        patches_.push_back({Patch::Kind::RemoveField, i, {}});
+      } else {
+        // The original name is kept, followed by the new value
+        patches_.push_back({Patch::Kind::ReplaceValue, i,
+                            detail::concat(": ", value, kCRLF)});
+        replaced = true;
+      }
+    }
+    if (!replaced) {
+      return add(name, value);
+    }
+    return true;
+  }
+
+  // header-field = field-name ":" OWS field-value OWS
+  //
+  // Returns false, without changing anything, if `name` is not a token or
+  // `value` contains control characters, as a CR or LF would end the field and
+  // let the rest of the value be read as more fields or another message.
+  bool add(const std::string_view name, const std::string_view value) {
+    if (!is_valid_field(name, value)) {
+      return false;
+    }
+    patches_.push_back({Patch::Kind::AddField, 0,
+                        detail::concat(name, ": ", value, kCRLF)});
+    return true;
+  }
+
+  // Replaces the request-target of a request. Returns false if the message is
+  // not a request, or if `target` is empty or contains whitespace or control
+  // characters.
+  bool set_request_target(const std::string_view target) {
+    if (!is_request() || target.empty() ||
+        !std::all_of(target.begin(), target.end(), detail::is_vchar)) {
+      return false;
+    }
+    patches_.push_back({Patch::Kind::ReplaceTarget, 0, std::string{target}});
+    return true;
+  }
+
+  // Rewrites an absolute-form request-target into origin-form, and sets the
+  // Host header field to its authority, as a proxy does before forwarding a
+  // request to an origin server. Returns false if there was nothing to do.
+  //
+  // > When a proxy receives a request with an absolute-form of
+  // request-target, the proxy MUST ignore the received Host header field (if
+  // any) and instead replace it with the host information of the
+  // request-target.
+  // Reference: https://tools.ietf.org/html/rfc7230#section-5.4
+  bool to_origin_form() {
+    const auto scheme_end = target_.find("://");
+    if (!is_request() || target_.front() == '/' || scheme_end == 0 ||
+        scheme_end == target_.npos) {
+      return false;
+    }
+    auto rest = target_.substr(scheme_end + 3);
+    const auto authority_end = rest.find_first_of("/?#");
+    auto authority = rest.substr(0, authority_end);
+    rest = authority_end != rest.npos ? rest.substr(authority_end) :
+                                        std::string_view{};
+
+    // > A sender MUST NOT generate the userinfo subcomponent (and its "@"
+    // delimiter) when an "http" URI reference is generated within a message
+    // as a request target or header field value.
+    // Reference: https://tools.ietf.org/html/rfc7230#section-2.7.1
+    if (const auto at = authority.rfind('@'); at != authority.npos) {
+      authority.remove_prefix(at + 1);
+    }
+    // The fragment is not part of the target URI
+    rest = rest.substr(0, rest.find('#'));
+
+    // origin-form = absolute-path [ "?" query ]
+    set_request_target(rest.empty() || rest.front() != '/' ?
+                       detail::concat("/", rest) : std::string{rest});
+    replace("Host", authority);
+    return true;
+  }
+
+  // Removes the fields that are only meant for the immediate connection.
+  // Returns the number of removed fields.
+  //
+  // > Intermediaries MUST parse a received Connection header field before a
+  // message is forwarded and, for each connection-option in this field,
+  // remove any header field(s) from the message with the same name as the
+  // connection-option, and then remove the Connection header field itself (or
+  // replace it with the intermediary's own connection options for the
+  // forwarded message).
+  // Reference: https://tools.ietf.org/html/rfc7230#section-6.1
+  size_t remove_hop_by_hop() {
+    std::vector<bool> hop_by_hop(fields_.size(), false);
+    const auto mark = [&](const std::string_view name) {
+      const auto id = header::to_id(name);
+      for (size_t i = 0; i < fields_.size(); ++i) {
+        if (matches(fields_[i], name, id)) {
+          hop_by_hop[i] = true;
+        }
+      }
+    };
+
+    for (const auto& field : fields_) {
+      if (field.id == header::kConnection) {
+        for (const auto option : ListElements{field.value()}) {
+          mark(option);
+        }
+      }
+    }
+    for (const auto name : {"Connection", "Keep-Alive", "Proxy-Connection",
+                            "Proxy-Authenticate", "Proxy-Authorization", "TE",
+                            "Trailer", "Upgrade"}) {
+      mark(name);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      if (hop_by_hop[i]) {
+        patches_.push_back({Patch::Kind::RemoveField, i, {}});
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  // Returns the edited message. The buffers point into the original message
+  // and into the editor, and are valid until either is changed or destroyed.
+  ConstBuffers buffers() const {
+    // Applies the patches in order, so that later ones win
+    constexpr size_t kKeep = static_cast<size_t>(-1);
+    constexpr size_t kRemove = static_cast<size_t>(-2);
+    std::vector<size_t> states(fields_.size(), kKeep);
+    const Patch* target = nullptr;
+    size_t added = 0;
+    for (size_t i = 0; i < patches_.size(); ++i) {
+      const auto& patch = patches_[i];
+      switch (patch.kind) {
+        case Patch::Kind::RemoveField:
+          states[patch.field] = kRemove;
+          break;
+        case Patch::Kind::ReplaceValue:
+          states[patch.field] = i;
+          break;
+        case Patch::Kind::AddField:
+          ++added;
+          break;
+        case Patch::Kind::ReplaceTarget:
+          target = &patch;
+          break;
+      }
+    }
+
+    ConstBuffers buffers;
+    buffers.reserve(fields_.size() + added + 4);
+
+    if (target) {
+      const auto target_begin =
+          static_cast<size_t>(target_.data() - start_line_.data());
+      AppendBuffer(buffers, start_line_.substr(0, target_begin));
+      AppendBuffer(buffers, target->text);
+      AppendBuffer(buffers, start_line_.substr(target_begin + target_.size()));
+    } else {
+      AppendBuffer(buffers, start_line_);
+    }
+
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      const auto& field = fields_[i];
+      if (states[i] == kKeep) {
+        AppendBuffer(buffers, field.line);
+      } else if (states[i] != kRemove) {
+        AppendBuffer(buffers, field.name);
+        AppendBuffer(buffers, patches_[states[i]].text);
+      }
+    }
+    for (const auto& patch : patches_) {
+      if (patch.kind == Patch::Kind::AddField) {
+        AppendBuffer(buffers, patch.text);
+      }
+    }
+
+    AppendBuffer(buffers, rest_);
+    return buffers;
+  }
+
+private:
+  static constexpr auto kCRLF = detail::syntax::kCRLF;
+
+  struct Field {
+    std::string_view line;  // including CRLF
+    std::string_view name;
+    header::Id id = header::kUnknown;
+
+    std::string_view value() const {
+      return detail::TrimWhitespace(
+          line.substr(name.size() + 1, line.size() - name.size() - 3));
+    }
+  };
+
+  // field-name = token
+  static bool is_valid_field(const std::string_view name,
+                             const std::string_view value) {
+    return !name.empty() &&
+           std::all_of(name.begin(), name.end(), detail::is_tchar) &&
+           std::all_of(value.begin(), value.end(),
+                       detail::is_field_value_char);
+  }
+
+  static bool matches(const Field& field, const std::string_view name,
+                      const header::Id id) {
+    return id != header::kUnknown ?
+        field.id == id : detail::equals_ignore_case(field.name, name);
+  }
+
+  std::string_view start_line_;  // including CRLF
+  std::string_view target_;
+  std::vector<Field> fields_;
+  std::string_view rest_;  // the final CRLF and the body
+  std::vector<Patch> patches_;
+  bool valid_ = false;
+};
+
+}  // namespace hypp
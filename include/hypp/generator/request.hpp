@@ -1,12 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <initializer_list>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include <hypp/detail/uri.hpp>
 #include <hypp/detail/util.hpp>
 #include <hypp/detail/syntax.hpp>
 #include <hypp/generator/message.hpp>
 #include <hypp/generator/uri.hpp>
 #include <hypp/generator/version.hpp>
+#include <hypp/error.hpp>
+#include <hypp/header.hpp>
 #include <hypp/request.hpp>
 
 namespace hypp {
@@ -71,4 +81,223 @@ inline std::string to_string(const Request& request) {
   return to_string<RequestLine>(request);
 }
 
+// A request that is serialized once and then filled many times.
+//
+// Placeholders are written as "{name}" in the request-target and in header
+// field values (e.g. "/users/{id}?q={query}" or "Bearer {token}"). Values that
+// are substituted into the request-target are percent-encoded, values that are
+// substituted into header fields are copied as-is. Static parts are never
+// encoded or validated again. Values for header fields that contain control
+// characters (e.g. CR or LF, which would end the field and start another one)
+// are rejected.
+//
+// The body is not part of the template. It is passed to fill(), and the
+// Content-Length header field is generated from its size, unless the template
+// has a Transfer-Encoding header field, in which case the body must already be
+// encoded (e.g. chunked).
+class RequestTemplate {
+public:
+  explicit RequestTemplate(const Request& request) {
+    using namespace detail::syntax;
+
+    // request-line = method SP request-target SP HTTP-version CRLF
+    //
+    // Only the request-target has slots
+    const auto& request_line = request.start_line;
+    append_static(request_line.method);
+    append_static({&kSP, 1});
+    append_text(to_string(request_line.target), true);
+    append_static({&kSP, 1});
+    append_static(to_string(request_line.version));
+    append_static(kCRLF);
+
+    bool has_content_length = !request.body.empty();
+    bool has_transfer_encoding = false;
+
+    for (const auto& header_field : request.header_fields) {
+      if (detail::equals_ignore_case(header_field.name, kContentLength)) {
+        has_content_length = true;
+        continue;
+      }
+      has_transfer_encoding = has_transfer_encoding ||
+          detail::IsHeaderField(header_field, header::kTransfer_Encoding);
+      append_text(to_string(header_field) + kCRLF, false);
+    }
+
+    // > A sender MUST NOT send a Content-Length header field in any message
+    // that contains a Transfer-Encoding header field.
+    // Reference: https://tools.ietf.org/html/rfc7230#section-3.3.2
+    //
+    // Otherwise, Content-Length is generated even for an empty body if the
+    // template had one, so that e.g. an empty POST request still indicates
+    // its length.
+    if (!has_transfer_encoding) {
+      segments_.push_back({Segment::Kind::ContentLength, 0, 0, 0, false});
+      content_length_ = has_content_length;
+    }
+
+    append_text(kCRLF, false);
+  }
+
+  // Number of distinct placeholders, in the order of their first appearance
+  size_t slot_count() const {
+    return slots_.size();
+  }
+
+  std::optional<size_t> find_slot(const std::string_view name) const {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (slots_[i] == name) return i;
+    }
+    return std::nullopt;
+  }
+
+  // Values are given in slot order. Missing values are substituted with empty
+  // strings.
+  Expected<std::string> fill(
+      const std::initializer_list<std::string_view> values,
+      const std::string_view body = {}) const {
+    std::string output;
+    if (const auto error = fill(output, values.begin(), values.size(), body)) {
+      return Unexpected{*error};
+    }
+    return output;
+  }
+
+  // Same as above, but writes into `output`, which is left empty on error.
+  std::optional<Error> fill(
+      std::string& output, const std::initializer_list<std::string_view> values,
+      const std::string_view body = {}) const {
+    return fill(output, values.begin(), values.size(), body);
+  }
+
+  std::optional<Error> fill(std::string& output,
+                            const std::vector<std::string_view>& values,
+                            const std::string_view body = {}) const {
+    return fill(output, values.data(), values.size(), body);
+  }
+
+private:
+  static constexpr std::string_view kContentLength = "Content-Length";
+
+  struct Segment {
+    enum class Kind {
+      Text,
+      Slot,
+      ContentLength,
+    };
+
+    Kind kind = Kind::Text;
+    size_t offset = 0;  // in text_
+    size_t size = 0;
+    size_t slot = 0;
+    bool encode = false;
+  };
+
+  void append_text(const std::string_view text, const bool encode) {
+    // Placeholder names are tokens, which cannot contain braces. This keeps
+    // values such as JSON in header fields from being mistaken for slots.
+    size_t pos = 0;
+    while (pos < text.size()) {
+      const auto open = text.find('{', pos);
+      const auto close = open != text.npos ? text.find('}', open) : text.npos;
+      if (close == text.npos) {
+        break;
+      }
+      const auto name = text.substr(open + 1, close - open - 1);
+      if (name.empty() ||
+          !std::all_of(name.begin(), name.end(), detail::is_tchar)) {
+        append_static(text.substr(pos, open + 1 - pos));
+        pos = open + 1;
+        continue;
+      }
+      append_static(text.substr(pos, open - pos));
+      segments_.push_back({Segment::Kind::Slot, 0, 0, add_slot(name), encode});
+      pos = close + 1;
+    }
+    append_static(text.substr(pos));
+  }
+
+  void append_static(const std::string_view text) {
+    if (text.empty()) {
+      return;
+    }
+    // Adjacent static parts are merged into a single copy
+    if (!segments_.empty() && segments_.back().kind == Segment::Kind::Text) {
+      segments_.back().size += text.size();
+    } else {
+      segments_.push_back({Segment::Kind::Text, text_.size(), text.size()});
+    }
+    text_.append(text);
+  }
+
+  size_t add_slot(const std::string_view name) {
+    if (const auto slot = find_slot(name)) {
+      return *slot;
+    }
+    slots_.emplace_back(name);
+    return slots_.size() - 1;
+  }
+
+  std::optional<Error> fill(std::string& output,
+                            const std::string_view* values, const size_t count,
+                            const std::string_view body) const {
+    using namespace detail::syntax;
+
+    const auto value = [&](const size_t slot) {
+      return slot < count ? values[slot] : std::string_view{};
+    };
+
+    output.clear();
+
+    // Static parts and unencoded values are exact; encoded values may grow
+    size_t size = text_.size() + body.size() + kContentLength.size() + 24;
+    for (const auto& segment : segments_) {
+      if (segment.kind == Segment::Kind::Slot) {
+        const auto slot_value = value(segment.slot);
+        if (!segment.encode &&
+            !std::all_of(slot_value.begin(), slot_value.end(),
+                         detail::is_field_value_char)) {
+          return Error::Invalid_Header_Format;
+        }
+        size += slot_value.size();
+      }
+    }
+
+    output.reserve(size);
+
+    for (const auto& segment : segments_) {
+      switch (segment.kind) {
+        case Segment::Kind::Text:
+          output.append(text_, segment.offset, segment.size);
+          break;
+        case Segment::Kind::Slot:
+          if (segment.encode) {
+            detail::uri::encode(value(segment.slot), output);
+          } else {
+            output.append(value(segment.slot));
+          }
+          break;
+        case Segment::Kind::ContentLength:
+          if (content_length_ || !body.empty()) {
+            std::array<char, 20> digits;
+            const auto result = std::to_chars(
+                digits.data(), digits.data() + digits.size(), body.size());
+            output.append(kContentLength).append(": ");
+            output.append(digits.data(), result.ptr - digits.data());
+            output.append(kCRLF);
+          }
+          break;
+      }
+    }
+
+    output.append(body);
+    return std::nullopt;
+  }
+
+  std::string text_;
+  std::vector<Segment> segments_;
+  std::vector<std::string> slots_;
+  bool content_length_ = false;
+};
+
 }  // namespace hypp
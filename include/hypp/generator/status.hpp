@@ -10,7 +10,7 @@ namespace hypp {
 
 // status-code = 3DIGIT
 inline std::string to_string(const status::code_t& code) {
-  return detail::to_chars(code).substr(0, detail::limits::kStatusCode);
+  return detail::to_chars(code).substr(0, DefaultLimits::kStatusCode);
 }
 
 }  // namespace hypp
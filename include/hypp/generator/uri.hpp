@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 
+#include <hypp/detail/hash.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/uri.hpp>
 #include <hypp/detail/util.hpp>
 #include <hypp/uri.hpp>
 
@@ -48,6 +54,159 @@ inline bool VerifyUri(const Uri& uri) {
   return true;
 }
 
+// Removes "." and ".." segments from the path at `data`, and returns the new
+// size. The output is never longer than the input, so the path is rewritten in
+// place.
+// Reference: https://tools.ietf.org/html/rfc3986#section-5.2.4
+inline size_t RemoveDotSegments(char* const data, const size_t size) {
+  const char* in = data;
+  const char* const end = data + size;
+  char* out = data;
+
+  const auto rest = [&]() {
+    return std::string_view(in, end - in);
+  };
+  const auto starts_with = [&](const std::string_view prefix) {
+    return rest().substr(0, prefix.size()) == prefix;
+  };
+  const auto remove_last_segment = [&]() {
+    while (out != data && *--out != '/') {}
+  };
+
+  while (in != end) {
+    // A. If the input buffer begins with a prefix of "../" or "./", then
+    // remove that prefix from the input buffer
+    if (starts_with("../")) {
+      in += 3;
+    } else if (starts_with("./")) {
+      in += 2;
+
+    // B. if the input buffer begins with a prefix of "/./" or "/.", where "."
+    // is a complete path segment, then replace that prefix with "/" in the
+    // input buffer
+    } else if (starts_with("/./")) {
+      in += 2;
+    } else if (rest() == "/.") {
+      *out++ = '/';
+      in = end;
+
+    // C. if the input buffer begins with a prefix of "/../" or "/..", where
+    // ".." is a complete path segment, then replace that prefix with "/" in
+    // the input buffer and remove the last segment and its preceding "/" (if
+    // any) from the output buffer
+    } else if (starts_with("/../")) {
+      in += 3;
+      remove_last_segment();
+    } else if (rest() == "/..") {
+      in = end;
+      remove_last_segment();
+      *out++ = '/';
+
+    // D. if the input buffer consists only of "." or "..", then remove that
+    // from the input buffer
+    } else if (rest() == "." || rest() == "..") {
+      in = end;
+
+    // E. move the first path segment in the input buffer to the end of the
+    // output buffer, including the initial "/" character (if any) and any
+    // subsequent characters up to, but not including, the next "/"
+    } else {
+      const char* next = static_cast<const char*>(
+          std::memchr(in + 1, '/', end - in - 1));
+      next = next ? next : end;
+      std::memmove(out, in, next - in);
+      out += next - in;
+      in = next;
+    }
+  }
+
+  return out - data;
+}
+
+// Appends `str`, with percent-encodings normalized: triplets that encode
+// unreserved characters are decoded, and the rest use uppercase hexadecimal
+// digits. If `lower` is set, other characters are converted to lowercase.
+// Reference: https://tools.ietf.org/html/rfc3986#section-6.2.2
+template <typename Output>
+void AppendNormalized(Output& output, const std::string_view str,
+                      const bool lower) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    // Runs without percent-encodings are copied at once
+    if (!lower) {
+      auto next = str.find('%', i);
+      next = next != str.npos ? next : str.size();
+      output.append(str.substr(i, next - i));
+      if ((i = next) == str.size()) break;
+    }
+    const char c = str[i];
+    if (c == '%' && i + 2 < str.size()) {
+      if (const int octet = uri::decode_triplet(str.data() + i); octet >= 0) {
+        const char decoded = static_cast<char>(octet);
+        if (is_unreserved(decoded)) {
+          output.push_back(lower ? to_lower(decoded) : decoded);
+        } else {
+          output.push_back('%');
+          output.push_back(uri::table::kHexDigits[(octet >> 4) & 0x0F]);
+          output.push_back(uri::table::kHexDigits[octet & 0x0F]);
+        }
+        i += 2;
+        continue;
+      }
+    }
+    output.push_back(lower ? to_lower(c) : c);
+  }
+}
+
+// The parser stores IP literals without their brackets. A reg-name cannot
+// contain a colon, so any host that does is an IP literal.
+// Reference: https://tools.ietf.org/html/rfc3986#section-3.2.2
+template <typename Output>
+void AppendHost(Output& output, const std::string_view host,
+                const bool normalize) {
+  const bool ip_literal = host.find(':') != host.npos;
+  if (ip_literal) output.push_back('[');
+  if (normalize) {
+    AppendNormalized(output, host, true);
+  } else {
+    output.append(host);
+  }
+  if (ip_literal) output.push_back(']');
+}
+
+inline void AppendAuthority(std::string& output,
+                            const Uri::Authority& authority) {
+  if (authority.user_info.has_value()) {
+    output.append(*authority.user_info).append(1, '@');
+  }
+  AppendHost(output, authority.host, false);
+  if (authority.port.has_value()) {
+    output.append(1, ':').append(*authority.port);
+  }
+}
+
+inline size_t AuthoritySize(const std::optional<Uri::Authority>& authority) {
+  if (!authority.has_value()) {
+    return 0;
+  }
+  return 4 + authority->host.size() +
+      (authority->user_info ? authority->user_info->size() + 1 : 0) +
+      (authority->port ? authority->port->size() + 1 : 0);
+}
+
+inline size_t OptionalSize(const std::optional<std::string>& component) {
+  return component.has_value() ? component->size() + 1 : 0;
+}
+
+// Reference: https://tools.ietf.org/html/rfc3986#section-6.2.3
+constexpr std::string_view DefaultPort(const std::string_view scheme) {
+  if (equals_ignore_case(scheme, "http")) return "80";
+  if (equals_ignore_case(scheme, "https")) return "443";
+  if (equals_ignore_case(scheme, "ws")) return "80";
+  if (equals_ignore_case(scheme, "wss")) return "443";
+  if (equals_ignore_case(scheme, "ftp")) return "21";
+  return {};
+}
+
 }  // namespace detail
 
 // authority = [ userinfo "@" ] host [ ":" port ]
@@ -112,4 +271,213 @@ inline std::string to_string(const Uri& uri) {
   return output;
 }
 
+// Transforms a URI reference into its target URI, relative to a base URI. The
+// result is recomposed into `output`, which is allocated once.
+// Reference: https://tools.ietf.org/html/rfc3986#section-5.2
+inline void Resolve(const Uri& base, const Uri& reference,
+                    std::string& output) {
+  const Uri* scheme = &base;
+  const Uri* authority = &base;
+  const Uri* query = &reference;
+  std::string_view base_path;  // merged with the reference path if non-empty
+
+  // > A non-strict parser may ignore a scheme in the reference if it is
+  // identical to the base URI's scheme. (...) a validating parser should
+  // [not] do this.
+  // Reference: https://tools.ietf.org/html/rfc3986#section-5.2.2
+  if (reference.scheme.has_value()) {
+    scheme = authority = &reference;
+  } else if (reference.authority.has_value()) {
+    authority = &reference;
+  } else if (reference.path.empty()) {
+    base_path = base.path;
+    if (!reference.query.has_value()) {
+      query = &base;
+    }
+  } else if (reference.path.front() != '/') {
+    // Reference: https://tools.ietf.org/html/rfc3986#section-5.2.3
+    if (base.authority.has_value() && base.path.empty()) {
+      base_path = "/";
+    } else if (const auto pos = base.path.rfind('/'); pos != base.path.npos) {
+      base_path = std::string_view{base.path}.substr(0, pos + 1);
+    }
+  }
+  const std::string_view reference_path =
+      reference.scheme || reference.authority || !reference.path.empty() ?
+          std::string_view{reference.path} : std::string_view{};
+
+  // Recomposition
+  // Reference: https://tools.ietf.org/html/rfc3986#section-5.3
+  output.clear();
+  output.reserve(detail::OptionalSize(scheme->scheme) +
+                 detail::AuthoritySize(authority->authority) +
+                 base_path.size() + reference_path.size() +
+                 detail::OptionalSize(query->query) +
+                 detail::OptionalSize(reference.fragment));
+
+  if (scheme->scheme.has_value()) {
+    output.append(*scheme->scheme).append(1, ':');
+  }
+  if (authority->authority.has_value()) {
+    output.append("//");
+    detail::AppendAuthority(output, *authority->authority);
+  }
+
+  const size_t path_offset = output.size();
+  output.append(base_path).append(reference_path);
+  if (!reference_path.empty()) {
+    output.resize(path_offset + detail::RemoveDotSegments(
+        output.data() + path_offset, output.size() - path_offset));
+  }
+
+  if (query->query.has_value()) {
+    output.append(1, '?').append(*query->query);
+  }
+  if (reference.fragment.has_value()) {
+    output.append(1, '#').append(*reference.fragment);
+  }
+}
+
+inline std::string Resolve(const Uri& base, const Uri& reference) {
+  std::string output;
+  Resolve(base, reference, output);
+  return output;
+}
+
+namespace detail {
+
+inline size_t AppendNormalizedPath(std::string& output,
+                                   const std::string_view path,
+                                   const bool remove_dot_segments = true) {
+  const size_t offset = output.size();
+  AppendNormalized(output, path, false);
+  if (remove_dot_segments) {
+    output.resize(offset + RemoveDotSegments(output.data() + offset,
+                                             output.size() - offset));
+  }
+  return output.size() - offset;
+}
+
+// Returns true if any segment is "." or "..", possibly percent-encoded.
+inline bool HasDotSegments(const std::string_view path) {
+  for (size_t pos = 0; pos <= path.size(); ) {
+    auto next = path.find('/', pos);
+    next = next != path.npos ? next : path.size();
+    // The longest form of a dot segment is "%2E%2E"
+    if (const auto segment = path.substr(pos, next - pos);
+        !segment.empty() && segment.size() <= 6) {
+      const uri::DecodeView decoded{segment};
+      if (decoded == "." || decoded == "..") return true;
+    }
+    pos = next + 1;
+  }
+  return false;
+}
+
+// Hashing streams the normalized path without materializing it, unless dot
+// segments have to be removed. That requires a scratch copy of the path only.
+inline size_t AppendNormalizedPath(Hasher& output,
+                                   const std::string_view path,
+                                   const bool remove_dot_segments = true) {
+  if (!remove_dot_segments || !HasDotSegments(path)) {
+    AppendNormalized(output, path, false);
+    return path.size();
+  }
+  std::string scratch;
+  const size_t size = AppendNormalizedPath(scratch, path);
+  output.append(scratch);
+  return size;
+}
+
+template <typename Output>
+void NormalizeUri(const Uri& uri, Output& output) {
+  // > (...) the scheme and host are case-insensitive and therefore should be
+  // normalized to lowercase.
+  // Reference: https://tools.ietf.org/html/rfc3986#section-6.2.2.1
+  if (uri.scheme.has_value()) {
+    for (const char c : *uri.scheme) {
+      output.push_back(to_lower(c));
+    }
+    output.push_back(':');
+  }
+
+  if (uri.authority.has_value()) {
+    const auto& authority = *uri.authority;
+    output.append("//");
+    if (authority.user_info.has_value()) {
+      AppendNormalized(output, *authority.user_info, false);
+      output.push_back('@');
+    }
+    AppendHost(output, authority.host, true);
+
+    // > Normalization should not remove delimiters when their associated
+    // component is empty unless licensed to do so by the scheme
+    // specification. (...) the default port for the "http" scheme is "80"
+    // Reference: https://tools.ietf.org/html/rfc3986#section-6.2.3
+    if (authority.port.has_value() && !authority.port->empty() &&
+        *authority.port != DefaultPort(uri.scheme.value_or(""))) {
+      output.push_back(':');
+      output.append(*authority.port);
+    }
+  }
+
+  // Dot segments of a relative reference are only meaningful once it is
+  // resolved against a base URI, so a relative path keeps them.
+  // Reference: https://tools.ietf.org/html/rfc3986#section-5.2.2
+  const bool remove_dot_segments = uri.scheme || uri.authority ||
+      (!uri.path.empty() && uri.path.front() == '/');
+
+  // > (...) an empty path component should be normalized to a path of "/".
+  // Reference: https://tools.ietf.org/html/rfc3986#section-6.2.3
+  if (!AppendNormalizedPath(output, uri.path, remove_dot_segments) &&
+      uri.authority.has_value()) {
+    output.push_back('/');
+  }
+
+  if (uri.query.has_value()) {
+    output.push_back('?');
+    AppendNormalized(output, *uri.query, false);
+  }
+  if (uri.fragment.has_value()) {
+    output.push_back('#');
+    AppendNormalized(output, *uri.fragment, false);
+  }
+}
+
+}  // namespace detail
+
+// Applies syntax-based and scheme-based normalization, so that equivalent URIs
+// are recomposed into the same string. `output` is allocated once.
+// Reference: https://tools.ietf.org/html/rfc3986#section-6.2.2
+// Reference: https://tools.ietf.org/html/rfc3986#section-6.2.3
+inline void Normalize(const Uri& uri, std::string& output) {
+  output.clear();
+  output.reserve(detail::OptionalSize(uri.scheme) +
+                 detail::AuthoritySize(uri.authority) +
+                 uri.path.size() + 1 +
+                 detail::OptionalSize(uri.query) +
+                 detail::OptionalSize(uri.fragment));
+  detail::NormalizeUri(uri, output);
+}
+
+inline std::string Normalize(const Uri& uri) {
+  std::string output;
+  Normalize(uri, output);
+  return output;
+}
+
+// Returns a stable hash of the normalized form of `uri`, without building it.
+// The result is equal to hashing the output of Normalize().
+inline std::uint64_t HashNormalized(const Uri& uri) {
+  detail::Hasher hasher;
+  detail::NormalizeUri(uri, hasher);
+  return hasher.digest();
+}
+
+inline Hash128 HashNormalized128(const Uri& uri) {
+  detail::Hasher hasher;
+  detail::NormalizeUri(uri, hasher);
+  return hasher.digest128();
+}
+
 }  // namespace hypp
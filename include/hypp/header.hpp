@@ -1,15 +1,454 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <hypp/detail/util.hpp>
+
+namespace hypp::header {
+
+using id_t = std::uint16_t;
+
+// Well-known header field names, so that fields can be identified without
+// comparing strings. Names that are not in the table are kUnknown.
+//
+// Reference: https://www.iana.org/assignments/message-headers
+enum Id : id_t {
+  kUnknown = 0,
+  // Do not modify this list. It is automatically generated by a script.
+  // @http-header-fields-begin
+  kA_IM = 1,                                // [RFC4229]
+  kAccept = 2,                              // [RFC7231, Section 5.3.2]
+  kAccept_Additions = 3,                    // [RFC4229]
+  kAccept_Charset = 4,                      // [RFC7231, Section 5.3.3]
+  kAccept_Datetime = 5,                     // [RFC7089]
+  kAccept_Encoding = 6,                     // [RFC7231, Section 5.3.4]
+  kAccept_Features = 7,                     // [RFC4229]
+  kAccept_Language = 8,                     // [RFC7231, Section 5.3.5]
+  kAccept_Patch = 9,                        // [RFC5789]
+  kAccept_Ranges = 10,                      // [RFC7233, Section 2.3]
+  kAge = 11,                                // [RFC7234, Section 5.1]
+  kAllow = 12,                              // [RFC7231, Section 7.4.1]
+  kALPN = 13,                               // [RFC7639, Section 2]
+  kAlt_Svc = 14,                            // [RFC7838]
+  kAlt_Used = 15,                           // [RFC7838]
+  kAlternates = 16,                         // [RFC4229]
+  kApply_To_Redirect_Ref = 17,              // [RFC4437]
+  kAuthentication_Control = 18,             // [RFC8053, Section 4]
+  kAuthentication_Info = 19,                // [RFC7615, Section 3]
+  kAuthorization = 20,                      // [RFC7235, Section 4.2]
+  kC_Ext = 21,                              // [RFC4229]
+  kC_Man = 22,                              // [RFC4229]
+  kC_Opt = 23,                              // [RFC4229]
+  kC_PEP = 24,                              // [RFC4229]
+  kC_PEP_Info = 25,                         // [RFC4229]
+  kCache_Control = 26,                      // [RFC7234, Section 5.2]
+  kCalDAV_Timezones = 27,                   // [RFC7809, Section 7.1]
+  kClose = 28,                              // [RFC7230, Section 8.1]
+  kConnection = 29,                         // [RFC7230, Section 6.1]
+  kContent_Base = 30,                       // [RFC2068] [RFC2616]
+  kContent_Disposition = 31,                // [RFC6266]
+  kContent_Encoding = 32,                   // [RFC7231, Section 3.1.2.2]
+  kContent_ID = 33,                         // [RFC4229]
+  kContent_Language = 34,                   // [RFC7231, Section 3.1.3.2]
+  kContent_Length = 35,                     // [RFC7230, Section 3.3.2]
+  kContent_Location = 36,                   // [RFC7231, Section 3.1.4.2]
+  kContent_MD5 = 37,                        // [RFC4229]
+  kContent_Range = 38,                      // [RFC7233, Section 4.2]
+  kContent_Script_Type = 39,                // [RFC4229]
+  kContent_Style_Type = 40,                 // [RFC4229]
+  kContent_Type = 41,                       // [RFC7231, Section 3.1.1.5]
+  kContent_Version = 42,                    // [RFC4229]
+  kCookie = 43,                             // [RFC6265]
+  kCookie2 = 44,                            // [RFC2965] [RFC6265]
+  kDASL = 45,                               // [RFC5323]
+  kDAV = 46,                                // [RFC4918]
+  kDate = 47,                               // [RFC7231, Section 7.1.1.2]
+  kDefault_Style = 48,                      // [RFC4229]
+  kDelta_Base = 49,                         // [RFC4229]
+  kDepth = 50,                              // [RFC4918]
+  kDerived_From = 51,                       // [RFC4229]
+  kDestination = 52,                        // [RFC4918]
+  kDifferential_ID = 53,                    // [RFC4229]
+  kDigest = 54,                             // [RFC4229]
+  kEarly_Data = 55,                         // [RFC8470]
+  kETag = 56,                               // [RFC7232, Section 2.3]
+  kExpect = 57,                             // [RFC7231, Section 5.1.1]
+  kExpires = 58,                            // [RFC7234, Section 5.3]
+  kExt = 59,                                // [RFC4229]
+  kForwarded = 60,                          // [RFC7239]
+  kFrom = 61,                               // [RFC7231, Section 5.5.1]
+  kGetProfile = 62,                         // [RFC4229]
+  kHobareg = 63,                            // [RFC7486, Section 6.1.1]
+  kHost = 64,                               // [RFC7230, Section 5.4]
+  kHTTP2_Settings = 65,                     // [RFC7540, Section 3.2.1]
+  kIM = 66,                                 // [RFC4229]
+  kIf = 67,                                 // [RFC4918]
+  kIf_Match = 68,                           // [RFC7232, Section 3.1]
+  kIf_Modified_Since = 69,                  // [RFC7232, Section 3.3]
+  kIf_None_Match = 70,                      // [RFC7232, Section 3.2]
+  kIf_Range = 71,                           // [RFC7233, Section 3.2]
+  kIf_Schedule_Tag_Match = 72,              // [RFC6638]
+  kIf_Unmodified_Since = 73,                // [RFC7232, Section 3.4]
+  kInclude_Referred_Token_Binding_ID = 74,  // [RFC8473]
+  kKeep_Alive = 75,                         // [RFC4229]
+  kLabel = 76,                              // [RFC4229]
+  kLast_Modified = 77,                      // [RFC7232, Section 2.2]
+  kLink = 78,                               // [RFC8288]
+  kLocation = 79,                           // [RFC7231, Section 7.1.2]
+  kLock_Token = 80,                         // [RFC4918]
+  kMan = 81,                                // [RFC4229]
+  kMax_Forwards = 82,                       // [RFC7231, Section 5.1.2]
+  kMemento_Datetime = 83,                   // [RFC7089]
+  kMeter = 84,                              // [RFC4229]
+  kMIME_Version = 85,                       // [RFC7231, Appendix A.1]
+  kNegotiate = 86,                          // [RFC4229]
+  kOpt = 87,                                // [RFC4229]
+  kOptional_WWW_Authenticate = 88,          // [RFC8053, Section 3]
+  kOrdering_Type = 89,                      // [RFC4229]
+  kOrigin = 90,                             // [RFC6454]
+  kOSCORE = 91,                             // [RFC8613, Section 11.1]
+  kOverwrite = 92,                          // [RFC4918]
+  kP3P = 93,                                // [RFC4229]
+  kPEP = 94,                                // [RFC4229]
+  kPICS_Label = 95,                         // [RFC4229]
+  kPep_Info = 96,                           // [RFC4229]
+  kPosition = 97,                           // [RFC4229]
+  kPragma = 98,                             // [RFC7234, Section 5.4]
+  kPrefer = 99,                             // [RFC7240]
+  kPreference_Applied = 100,                // [RFC7240]
+  kProfileObject = 101,                     // [RFC4229]
+  kProtocol = 102,                          // [RFC4229]
+  kProtocol_Info = 103,                     // [RFC4229]
+  kProtocol_Query = 104,                    // [RFC4229]
+  kProtocol_Request = 105,                  // [RFC4229]
+  kProxy_Authenticate = 106,                // [RFC7235, Section 4.3]
+  kProxy_Authentication_Info = 107,         // [RFC7615, Section 4]
+  kProxy_Authorization = 108,               // [RFC7235, Section 4.4]
+  kProxy_Features = 109,                    // [RFC4229]
+  kProxy_Instruction = 110,                 // [RFC4229]
+  kPublic = 111,                            // [RFC4229]
+  kPublic_Key_Pins = 112,                   // [RFC7469]
+  kPublic_Key_Pins_Report_Only = 113,       // [RFC7469]
+  kRange = 114,                             // [RFC7233, Section 3.1]
+  kRedirect_Ref = 115,                      // [RFC4437]
+  kReferer = 116,                           // [RFC7231, Section 5.5.2]
+  kReplay_Nonce = 117,                      // [RFC8555, Section 6.5.1]
+  kRetry_After = 118,                       // [RFC7231, Section 7.1.3]
+  kSafe = 119,                              // [RFC4229]
+  kSchedule_Reply = 120,                    // [RFC6638]
+  kSchedule_Tag = 121,                      // [RFC6638]
+  kSec_Token_Binding = 122,                 // [RFC8473]
+  kSec_WebSocket_Accept = 123,              // [RFC6455]
+  kSec_WebSocket_Extensions = 124,          // [RFC6455]
+  kSec_WebSocket_Key = 125,                 // [RFC6455]
+  kSec_WebSocket_Protocol = 126,            // [RFC6455]
+  kSec_WebSocket_Version = 127,             // [RFC6455]
+  kSecurity_Scheme = 128,                   // [RFC4229]
+  kServer = 129,                            // [RFC7231, Section 7.4.2]
+  kSet_Cookie = 130,                        // [RFC6265]
+  kSet_Cookie2 = 131,                       // [RFC2965] [RFC6265]
+  kSetProfile = 132,                        // [RFC4229]
+  kSLUG = 133,                              // [RFC5023]
+  kSoapAction = 134,                        // [RFC4229]
+  kStatus_URI = 135,                        // [RFC4229]
+  kStrict_Transport_Security = 136,         // [RFC6797]
+  kSunset = 137,                            // [RFC8594]
+  kSurrogate_Capability = 138,              // [RFC4229]
+  kSurrogate_Control = 139,                 // [RFC4229]
+  kTCN = 140,                               // [RFC4229]
+  kTE = 141,                                // [RFC7230, Section 4.3]
+  kTimeout = 142,                           // [RFC4918]
+  kTopic = 143,                             // [RFC8030, Section 5.4]
+  kTrailer = 144,                           // [RFC7230, Section 4.4]
+  kTransfer_Encoding = 145,                 // [RFC7230, Section 3.3.1]
+  kTTL = 146,                               // [RFC8030, Section 5.2]
+  kUrgency = 147,                           // [RFC8030, Section 5.3]
+  kURI = 148,                               // [RFC4229]
+  kUpgrade = 149,                           // [RFC7230, Section 6.7]
+  kUser_Agent = 150,                        // [RFC7231, Section 5.5.3]
+  kVariant_Vary = 151,                      // [RFC4229]
+  kVary = 152,                              // [RFC7231, Section 7.1.4]
+  kVia = 153,                               // [RFC7230, Section 5.7.1]
+  kWant_Digest = 154,                       // [RFC4229]
+  kWarning = 155,                           // [RFC7234, Section 5.5]
+  kWWW_Authenticate = 156,                  // [RFC7235, Section 4.1]
+  kX_Frame_Options = 157,                   // [RFC7034]
+  // @http-header-fields-end
+};
+
+}  // namespace hypp::header
+
 namespace hypp {
 
 struct HeaderField {
   std::string name;
   std::string value;
+  header::Id id = header::kUnknown;
 };
 
 using HeaderFields = std::vector<HeaderField>;
 
 }  // namespace hypp
+
+namespace hypp::detail {
+
+constexpr std::string_view kHeaderNames[] = {
+  "",
+  // Do not modify this list. It is automatically generated by a script.
+  // @http-header-names-begin
+  "A-IM",
+  "Accept",
+  "Accept-Additions",
+  "Accept-Charset",
+  "Accept-Datetime",
+  "Accept-Encoding",
+  "Accept-Features",
+  "Accept-Language",
+  "Accept-Patch",
+  "Accept-Ranges",
+  "Age",
+  "Allow",
+  "ALPN",
+  "Alt-Svc",
+  "Alt-Used",
+  "Alternates",
+  "Apply-To-Redirect-Ref",
+  "Authentication-Control",
+  "Authentication-Info",
+  "Authorization",
+  "C-Ext",
+  "C-Man",
+  "C-Opt",
+  "C-PEP",
+  "C-PEP-Info",
+  "Cache-Control",
+  "CalDAV-Timezones",
+  "Close",
+  "Connection",
+  "Content-Base",
+  "Content-Disposition",
+  "Content-Encoding",
+  "Content-ID",
+  "Content-Language",
+  "Content-Length",
+  "Content-Location",
+  "Content-MD5",
+  "Content-Range",
+  "Content-Script-Type",
+  "Content-Style-Type",
+  "Content-Type",
+  "Content-Version",
+  "Cookie",
+  "Cookie2",
+  "DASL",
+  "DAV",
+  "Date",
+  "Default-Style",
+  "Delta-Base",
+  "Depth",
+  "Derived-From",
+  "Destination",
+  "Differential-ID",
+  "Digest",
+  "Early-Data",
+  "ETag",
+  "Expect",
+  "Expires",
+  "Ext",
+  "Forwarded",
+  "From",
+  "GetProfile",
+  "Hobareg",
+  "Host",
+  "HTTP2-Settings",
+  "IM",
+  "If",
+  "If-Match",
+  "If-Modified-Since",
+  "If-None-Match",
+  "If-Range",
+  "If-Schedule-Tag-Match",
+  "If-Unmodified-Since",
+  "Include-Referred-Token-Binding-ID",
+  "Keep-Alive",
+  "Label",
+  "Last-Modified",
+  "Link",
+  "Location",
+  "Lock-Token",
+  "Man",
+  "Max-Forwards",
+  "Memento-Datetime",
+  "Meter",
+  "MIME-Version",
+  "Negotiate",
+  "Opt",
+  "Optional-WWW-Authenticate",
+  "Ordering-Type",
+  "Origin",
+  "OSCORE",
+  "Overwrite",
+  "P3P",
+  "PEP",
+  "PICS-Label",
+  "Pep-Info",
+  "Position",
+  "Pragma",
+  "Prefer",
+  "Preference-Applied",
+  "ProfileObject",
+  "Protocol",
+  "Protocol-Info",
+  "Protocol-Query",
+  "Protocol-Request",
+  "Proxy-Authenticate",
+  "Proxy-Authentication-Info",
+  "Proxy-Authorization",
+  "Proxy-Features",
+  "Proxy-Instruction",
+  "Public",
+  "Public-Key-Pins",
+  "Public-Key-Pins-Report-Only",
+  "Range",
+  "Redirect-Ref",
+  "Referer",
+  "Replay-Nonce",
+  "Retry-After",
+  "Safe",
+  "Schedule-Reply",
+  "Schedule-Tag",
+  "Sec-Token-Binding",
+  "Sec-WebSocket-Accept",
+  "Sec-WebSocket-Extensions",
+  "Sec-WebSocket-Key",
+  "Sec-WebSocket-Protocol",
+  "Sec-WebSocket-Version",
+  "Security-Scheme",
+  "Server",
+  "Set-Cookie",
+  "Set-Cookie2",
+  "SetProfile",
+  "SLUG",
+  "SoapAction",
+  "Status-URI",
+  "Strict-Transport-Security",
+  "Sunset",
+  "Surrogate-Capability",
+  "Surrogate-Control",
+  "TCN",
+  "TE",
+  "Timeout",
+  "Topic",
+  "Trailer",
+  "Transfer-Encoding",
+  "TTL",
+  "Urgency",
+  "URI",
+  "Upgrade",
+  "User-Agent",
+  "Variant-Vary",
+  "Vary",
+  "Via",
+  "Want-Digest",
+  "Warning",
+  "WWW-Authenticate",
+  "X-Frame-Options",
+  // @http-header-names-end
+};
+
+// Do not modify these tables. They are automatically generated by a script.
+// @http-header-hash-begin
+constexpr size_t kHeaderHashSize = 256;
+constexpr size_t kHeaderHashBuckets = 32;
+constexpr std::uint16_t kHeaderHashDisplacements[kHeaderHashBuckets] = {
+    4,   7,   3,  19,   5,   5,   2,   0,   0,   7,   0,   0,   2,  15,  24,   1,
+    1,  29,   2,   0,  14,   8,  26,  44,   7,   0,  31,   0,  36,   8,   4,  17,
+};
+constexpr header::id_t kHeaderHashTable[kHeaderHashSize] = {
+   43, 107,   0,  76,   0,   0,   0,   0, 149,  22,  17,  72,   0, 110, 124,   3,
+    0,   0,  58, 157,  38,   0,  29,  19,  21, 112,   0,  18, 141,   0,  48,   0,
+    0,  33,   0,   0,  55,  68,   0,   0,  24,   0,  86, 106, 137,   0,   0, 115,
+   61, 100,  57,  31,   0,   0,  56,  46,   0,   0,  85,   0,  39, 121,  30,   0,
+   10, 140,  73,   0,   4,   0,   0,   0,   8,  83,   0, 145,   0,  66,  37,   0,
+    0,  14,   0,   0,   0, 114, 151,   0,   0, 150, 147,   0, 102, 132, 152,  98,
+  144,  36,   0,  99,   0,  52,   0,  53,   0, 133,  20,  27,   0,   7,  51,  15,
+    0,  77,  67, 104,  28,   0,   0,   0,  42,  25,  69, 122,   0,   0,   0,   0,
+    5,  13,  50, 143,  41,  65,   0,   0, 142,   0,  11,   0,  80,   6, 119, 130,
+    0,   0,  44,  92, 131, 153,   0,   0,   0,  35,   0, 125, 116, 138,   0,   2,
+   93,  70, 156,  74,  63,   0, 134,   0, 111, 135,   0, 120,   0,   0,   0, 129,
+  118, 126,   0,  32, 108,  16,  79,  34,   0,   0,  12, 154,   0,   0,  49,  59,
+    1,  78,   0, 109,   0,   0,  64,   0,   0,  89,  75,   0,   0,   0,  62,   0,
+    0,  81,   0, 103,  84,  82,   9,  40,   0,  91,  60, 128,   0, 105, 146,   0,
+  139,   0,   0, 101, 136,  95, 117,  71,   0,   0,   0, 123,  96,  23,  88, 148,
+   90,  94,  45,   0, 155,  47,   0, 127,   0,  26,  54,  87, 113,  97,   0,   0,
+};
+// @http-header-hash-end
+
+// FNV-1a of the lowercase name. Can be computed one character at a time while
+// scanning, starting from kHeaderHashBasis.
+constexpr std::uint32_t kHeaderHashBasis = 0x811c9dc5;
+
+constexpr std::uint32_t HashHeaderName(const std::uint32_t hash, const char c) {
+  return (hash ^ static_cast<unsigned char>(to_lower(c))) * 0x01000193;
+}
+
+constexpr std::uint32_t HashHeaderName(const std::string_view name) {
+  std::uint32_t hash = kHeaderHashBasis;
+  for (const char c : name) {
+    hash = HashHeaderName(hash, c);
+  }
+  return hash;
+}
+
+// MurmurHash3 finalizer
+constexpr std::uint32_t MixHeaderHash(std::uint32_t hash) {
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+// Looks up a name whose hash has already been computed with HashHeaderName.
+constexpr header::Id FindHeaderId(const std::string_view name,
+                                  const std::uint32_t hash) {
+  const auto displacement = kHeaderHashDisplacements[hash % kHeaderHashBuckets];
+  const auto id =
+      kHeaderHashTable[MixHeaderHash(hash + displacement) % kHeaderHashSize];
+  return id && equals_ignore_case(kHeaderNames[id], name) ?
+      static_cast<header::Id>(id) : header::kUnknown;
+}
+
+}  // namespace hypp::detail
+
+namespace hypp::header {
+
+// Returns the ID of a field name (case-insensitive), or kUnknown.
+constexpr Id to_id(const std::string_view name) {
+  return detail::FindHeaderId(name, detail::HashHeaderName(name));
+}
+
+// Returns the registered spelling of a field name, or an empty string.
+constexpr std::string_view to_name(const Id id) {
+  return id < std::size(detail::kHeaderNames) ? detail::kHeaderNames[id] :
+                                                std::string_view{};
+}
+
+}  // namespace hypp::header
+
+namespace hypp::detail {
+
+// Header fields that were not parsed (e.g. built by hand) may not have an ID,
+// so their names are compared instead.
+inline bool IsHeaderField(const HeaderField& header_field,
+                          const header::Id id) {
+  return header_field.id == id ||
+         (header_field.id == header::kUnknown &&
+          equals_ignore_case(header_field.name, header::to_name(id)));
+}
+
+}  // namespace hypp::detail
@@ -0,0 +1,524 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <hypp/detail/limits.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/chain.hpp>
+#include <hypp/parser/framing.hpp>
+#include <hypp/buffer.hpp>
+#include <hypp/error.hpp>
+#include <hypp/header.hpp>
+#include <hypp/method.hpp>
+#include <hypp/response.hpp>
+
+namespace hypp {
+
+// A view of writable bytes, e.g. for the next read from a socket.
+struct MutableBuffer {
+  char* data = nullptr;
+  size_t size = 0;
+};
+
+// The header section of a message, and how its body is delimited
+struct MessageFrame {
+  enum class Body {
+    Empty,          // the message ends with the header section
+    ContentLength,  // `content_length` bytes follow
+    Chunked,        // the chunked transfer coding
+    Close,          // the body extends until the connection is closed
+  };
+
+  size_t head_size = 0;
+  Body body = Body::Empty;
+  std::uint64_t content_length = 0;
+};
+
+namespace detail {
+
+struct InputSlab {
+  explicit InputSlab(const size_t size)
+      : data{std::make_unique<char[]>(size)}, size{size} {}
+
+  std::unique_ptr<char[]> data;
+  size_t size = 0;
+};
+
+// Reads the header section of the message that the reader is at, and returns
+// how its body is delimited, or nothing if the header section is incomplete.
+// For a response, `request_method` is the method of the request that it
+// answers, which decides whether a body follows.
+// Reference: https://tools.ietf.org/html/rfc7230#section-3.3.3
+template <typename MessageT, typename Limits>
+std::optional<MessageFrame> FrameMessageHead(
+    ChainReader& reader, const std::string_view request_method = {}) {
+  constexpr bool kResponse = std::is_same_v<MessageT, Response>;
+  using syntax::kCRLF;
+
+  const auto is_line = [](const std::optional<std::string_view>& line) {
+    return line && line->size() >= 2 &&
+           line->substr(line->size() - 2) == kCRLF;
+  };
+
+  MessageFrame frame;
+
+  // start-line
+  auto line = reader.read_line(Limits::kHeaderFields);
+  if (is_line(line) && *line == kCRLF) {
+    line = reader.read_line(Limits::kHeaderFields);
+  }
+  if (!is_line(line)) {
+    return std::nullopt;
+  }
+  bool empty_body = false;
+  if constexpr (kResponse) {
+    // > Any response to a HEAD request and any response with a 1xx
+    // (Informational), 204 (No Content), or 304 (Not Modified) status code is
+    // always terminated by the first empty line after the header fields,
+    // regardless of the header fields present in the message, and thus cannot
+    // contain a message body.
+    //
+    // > Any 2xx (Successful) response to a CONNECT request implies that the
+    // connection will become a tunnel immediately after the empty line that
+    // concludes the header fields.
+    // Reference: https://tools.ietf.org/html/rfc7230#section-3.3.3
+    if (line->size() > 12) {
+      const auto code = line->substr(9, 3);
+      empty_body = code[0] == '1' || code == "204" || code == "304" ||
+                   request_method == method::kHead ||
+                   (request_method == method::kConnect && code[0] == '2');
+    }
+  }
+
+  // *( header-field CRLF ) CRLF
+  //
+  // Invalid framing fields are ignored, as they are reported by the parser
+  Framing framing;
+  while (true) {
+    line = reader.read_line(Limits::kHeaderFields);
+    if (!is_line(line)) {
+      return std::nullopt;
+    }
+    if (*line == kCRLF) {
+      break;
+    }
+    const auto colon = line->find(':');
+    if (colon != line->npos) {
+      ParseFramingField(header::to_id(line->substr(0, colon)),
+                        line->substr(colon + 1, line->size() - colon - 3),
+                        framing);
+    }
+  }
+  frame.head_size = reader.position();
+
+  if (empty_body) {
+    frame.body = MessageFrame::Body::Empty;
+  } else if (framing.chunked) {
+    frame.body = MessageFrame::Body::Chunked;
+  } else if (framing.content_length.has_value()) {
+    frame.body = MessageFrame::Body::ContentLength;
+    frame.content_length = *framing.content_length;
+  } else if (kResponse) {
+    frame.body = MessageFrame::Body::Close;
+  } else {
+    frame.body = MessageFrame::Body::Empty;
+  }
+  return frame;
+}
+
+// Identifies the message type and limits that the framing state of an input
+// buffer was built with.
+template <typename MessageT, typename Limits>
+inline constexpr char kFrameKey = 0;
+
+}  // namespace detail
+
+// Keeps the bytes of a consumed message alive, so that views into them stay
+// valid after the input buffer has moved on. The bytes are freed when the last
+// lease that refers to them is released or destroyed.
+class InputLease {
+public:
+  InputLease() = default;
+
+  bool empty() const {
+    return buffers_.empty();
+  }
+  size_t size() const {
+    return BufferSize(buffers_);
+  }
+
+  const ConstBuffers& buffers() const {
+    return buffers_;
+  }
+
+  // Returns the bytes as a single view, if they lie within a single slab.
+  std::optional<std::string_view> contiguous() const {
+    if (buffers_.size() == 1) {
+      return buffers_.front().view();
+    }
+    return std::nullopt;
+  }
+
+  void release() {
+    buffers_.clear();
+    slabs_.clear();
+  }
+
+private:
+  friend class InputBuffer;
+
+  ConstBuffers buffers_;
+  std::vector<std::shared_ptr<const detail::InputSlab>> slabs_;
+};
+
+// The input buffer of a connection, as a chain of fixed-size slabs. Data is
+// read into the free space at the end of the last slab, and a new slab is
+// added when it is full, so unparsed bytes are never moved or copied. Slabs
+// are reused once they have been consumed, unless they are leased.
+//
+//   hypp::InputBuffer input;
+//   while (true) {
+//     const auto buffer = input.prepare();
+//     input.commit(read(socket, buffer.data, buffer.size));
+//     while (const auto lease = input.next<hypp::Request>()) {
+//       const auto request = hypp::ParseRequest(lease->buffers());
+//       ...
+//     }
+//   }
+class InputBuffer {
+public:
+  static constexpr size_t kDefaultSlabSize = 16 * 1024;
+
+  explicit InputBuffer(const size_t slab_size = kDefaultSlabSize)
+      : slab_size_{std::max<size_t>(slab_size, 1)} {}
+
+  // Returns the number of bytes that have been committed but not consumed.
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return !size_;
+  }
+
+  // Returns the number of slabs in use, and the number of spare ones.
+  size_t slab_count() const {
+    return slabs_.size();
+  }
+  size_t spare_slab_count() const {
+    return spare_.size();
+  }
+
+  // Returns the free space at the end of the buffer, which is never empty.
+  // Data that is written into it becomes part of the buffer with commit().
+  MutableBuffer prepare() {
+    if (slabs_.empty() || end_ == slabs_.back()->size) {
+      add_slab();
+    }
+    auto& slab = *slabs_.back();
+    return {slab.data.get() + end_, slab.size - end_};
+  }
+
+  // `n` must not be larger than the space returned by prepare().
+  void commit(const size_t n) {
+    end_ += n;
+    size_ += n;
+  }
+
+  // Returns the unconsumed bytes. The buffers are valid until the input
+  // buffer is changed.
+  ConstBuffers data() const {
+    ConstBuffers buffers;
+    buffers.reserve(slabs_.size());
+    for (size_t i = 0; i < slabs_.size(); ++i) {
+      const auto begin = i == 0 ? begin_ : 0;
+      const auto end = i + 1 == slabs_.size() ? end_ : slabs_[i]->size;
+      AppendBuffer(buffers, {slabs_[i]->data.get() + begin, end - begin});
+    }
+    return buffers;
+  }
+
+  // Returns the size of the complete message at the beginning of the buffer,
+  // or nothing if more data is needed. If the header section grows beyond the
+  // limits, or the body cannot be framed within them, all of the buffered data
+  // is returned, so that the parser can report the error. `end_of_stream` is
+  // set once the peer has closed the connection. For a response,
+  // `request_method` is the method of the request that it answers, e.g.
+  // "HEAD", whose responses have no body.
+  //
+  // The framing state is kept until the message is consumed, so each call only
+  // looks at the bytes that arrived since the last one.
+  template <typename MessageT, typename Limits = DefaultLimits>
+  std::optional<size_t> frame(
+      const bool end_of_stream = false,
+      const std::string_view request_method = {}) const {
+    auto& state = framing_;
+    if (!frame_head_once<MessageT, Limits>(request_method)) {
+      if (size_ > Limits::kHeaderFields + Limits::kRequestLine) {
+        return size_;
+      }
+      return std::nullopt;
+    }
+    const auto& head = *state.head;
+
+    // The parser needs some of the body to tell what is wrong with it
+    const auto give_up = [&]() -> std::optional<size_t> {
+      state.failed = true;
+      if (size_ > head.head_size) {
+        return size_;
+      }
+      return std::nullopt;
+    };
+    if (state.failed) {
+      return give_up();
+    }
+
+    const auto body_size = size_ - head.head_size;
+    switch (head.body) {
+      case MessageFrame::Body::Empty:
+        return head.head_size;
+      case MessageFrame::Body::ContentLength:
+        if (head.content_length > Limits::kBody) {
+          return give_up();
+        }
+        if (body_size < head.content_length) {
+          return std::nullopt;
+        }
+        return head.head_size + static_cast<size_t>(head.content_length);
+      case MessageFrame::Body::Chunked: {
+        // Only the bytes that arrived since the last call are decoded
+        bool failed = false;
+        for_each_from(state.scanned, [&](const std::string_view view) {
+          const auto size = state.decoder->decode(
+              view, [](std::string_view) { return true; });
+          failed = !size;
+          state.scanned += size ? size.value() : 0;
+          return size && !state.decoder->done();
+        });
+        if (failed) {
+          return give_up();
+        }
+        if (state.decoder->done()) {
+          return state.scanned;
+        }
+        return std::nullopt;
+      }
+      case MessageFrame::Body::Close:
+        if (body_size > Limits::kBody) {
+          return give_up();
+        }
+        if (end_of_stream) {
+          return size_;
+        }
+        return std::nullopt;
+    }
+    return std::nullopt;
+  }
+
+  // Returns the size of the header section at the beginning of the buffer, and
+  // how the body is delimited, or nothing if the header section is
+  // incomplete.
+  template <typename MessageT, typename Limits = DefaultLimits>
+  std::optional<MessageFrame> frame_head(
+      const std::string_view request_method = {}) const {
+    if (!frame_head_once<MessageT, Limits>(request_method)) {
+      return std::nullopt;
+    }
+    return framing_.head;
+  }
+
+  // Consumes the complete message at the beginning of the buffer, if there is
+  // one, and returns a lease of its bytes.
+  template <typename MessageT, typename Limits = DefaultLimits>
+  std::optional<InputLease> next(const bool end_of_stream = false,
+                                 const std::string_view request_method = {}) {
+    if (const auto size = frame<MessageT, Limits>(end_of_stream,
+                                                  request_method)) {
+      return consume(*size);
+    }
+    return std::nullopt;
+  }
+
+  // Consumes `n` bytes, and returns a lease that keeps them alive.
+  InputLease consume(size_t n) {
+    InputLease lease;
+    n = std::min(n, size_);
+    for (size_t i = 0; n; ++i) {
+      const auto begin = i == 0 ? begin_ : 0;
+      const auto end = i + 1 == slabs_.size() ? end_ : slabs_[i]->size;
+      const auto size = std::min(n, end - begin);
+      lease.slabs_.push_back(slabs_[i]);
+      AppendBuffer(lease.buffers_, {slabs_[i]->data.get() + begin, size});
+      n -= size;
+    }
+    discard(lease.size());
+    return lease;
+  }
+
+  // Consumes `n` bytes without keeping them alive.
+  void discard(size_t n) {
+    n = std::min(n, size_);
+    if (n) {
+      framing_ = {};
+    }
+    size_ -= n;
+    while (n) {
+      const auto end = slabs_.size() == 1 ? end_ : slabs_.front()->size;
+      const auto size = std::min(n, end - begin_);
+      begin_ += size;
+      n -= size;
+      if (begin_ == slabs_.front()->size) {
+        release_front();
+      }
+    }
+    // The last slab can be written from the beginning again, unless someone
+    // still refers to its bytes
+    if (!size_ && !slabs_.empty() && slabs_.back().use_count() == 1) {
+      begin_ = 0;
+      end_ = 0;
+    }
+  }
+
+  // Consumes everything.
+  void clear() {
+    discard(size_);
+  }
+
+private:
+  static constexpr size_t kMaxSpareSlabs = 4;
+
+  // How far the message at the beginning of the buffer has been framed
+  struct Framing {
+    const void* key = nullptr;  // kFrameKey of the message type and limits
+    std::string method;         // the request method of a response
+    size_t scanned = 0;         // bytes that have been looked at
+    int match = 0;              // bytes of "\r\n\r\n" that were just seen
+    std::optional<MessageFrame> head;
+    std::optional<detail::ChunkedDecoder> decoder;
+    bool failed = false;        // the body cannot be framed
+  };
+
+  // Frames the header section once its end has arrived, so that it is not
+  // parsed again on every read. Returns false if it is incomplete.
+  template <typename MessageT, typename Limits>
+  bool frame_head_once(const std::string_view request_method) const {
+    auto& state = framing_;
+    const void* const key = &detail::kFrameKey<MessageT, Limits>;
+    if (state.key != key || state.method != request_method) {
+      state = {};
+      state.key = key;
+      state.method = request_method;
+    }
+    if (state.head) {
+      return true;
+    }
+
+    bool found = false;
+    for_each_from(state.scanned, [&](const std::string_view view) {
+      for (size_t i = 0; i < view.size(); ++i) {
+        if (!state.match) {
+          const auto cr = view.find('\r', i);
+          if (cr == view.npos) {
+            state.scanned += view.size() - i;
+            break;
+          }
+          state.scanned += cr - i;
+          i = cr;
+        }
+        const char c = view[i];
+        ++state.scanned;
+        if (c == '\r') {
+          state.match = state.match == 2 ? 3 : 1;
+        } else if (c == '\n' && (state.match == 1 || state.match == 3)) {
+          ++state.match;
+        } else {
+          state.match = 0;
+        }
+        if (state.match == 4) {
+          found = true;
+          return false;
+        }
+      }
+      return true;
+    });
+    if (!found) {
+      return false;
+    }
+    state.match = 0;
+
+    const auto buffers = data();
+    detail::ChainReader reader{buffers.data(), buffers.size()};
+    state.head = detail::FrameMessageHead<MessageT, Limits>(reader,
+                                                            request_method);
+    if (!state.head) {
+      return false;
+    }
+    state.scanned = state.head->head_size;
+    if (state.head->body == MessageFrame::Body::Chunked) {
+      state.decoder.emplace(Limits::kHeaderFields, Limits::kBody);
+    }
+    return true;
+  }
+
+  // Passes the unconsumed bytes from `offset` on to `function` slab by slab,
+  // until it returns false.
+  template <typename Function>
+  void for_each_from(size_t offset, Function&& function) const {
+    for (size_t i = 0; i < slabs_.size(); ++i) {
+      const auto begin = i == 0 ? begin_ : 0;
+      const auto end = i + 1 == slabs_.size() ? end_ : slabs_[i]->size;
+      if (offset >= end - begin) {
+        offset -= end - begin;
+        continue;
+      }
+      if (!function(std::string_view{slabs_[i]->data.get() + begin + offset,
+                                     end - begin - offset})) {
+        return;
+      }
+      offset = 0;
+    }
+  }
+
+  void add_slab() {
+    if (!spare_.empty()) {
+      slabs_.push_back(std::move(spare_.back()));
+      spare_.pop_back();
+    } else {
+      slabs_.push_back(std::make_shared<detail::InputSlab>(slab_size_));
+    }
+    if (slabs_.size() == 1) {
+      begin_ = 0;
+    }
+    end_ = 0;
+  }
+
+  void release_front() {
+    auto& slab = slabs_.front();
+    if (slab.use_count() == 1 && spare_.size() < kMaxSpareSlabs) {
+      spare_.push_back(std::move(slab));
+    }
+    slabs_.pop_front();
+    begin_ = 0;
+    if (slabs_.empty()) {
+      end_ = 0;
+    }
+  }
+
+  size_t slab_size_;
+  std::deque<std::shared_ptr<detail::InputSlab>> slabs_;
+  std::vector<std::shared_ptr<detail::InputSlab>> spare_;
+  size_t begin_ = 0;  // in the first slab
+  size_t end_ = 0;    // in the last slab
+  size_t size_ = 0;
+  mutable Framing framing_;
+};
+
+}  // namespace hypp
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+#include <hypp/detail/util.hpp>
+
+namespace hypp::media_type {
+
+using id_t = std::uint8_t;
+
+// Common media types, so that content types can be dispatched on without
+// comparing strings. Other media types are kUnknown.
+//
+// Reference: https://www.iana.org/assignments/media-types
+enum Id : id_t {
+  kUnknown,
+  kApplication_Gzip,
+  kApplication_Javascript,
+  kApplication_Json,
+  kApplication_Octet_Stream,
+  kApplication_Pdf,
+  kApplication_Problem_Json,
+  kApplication_X_Www_Form_Urlencoded,
+  kApplication_Xml,
+  kApplication_Zip,
+  kAudio_Mpeg,
+  kAudio_Ogg,
+  kFont_Woff,
+  kFont_Woff2,
+  kImage_Gif,
+  kImage_Jpeg,
+  kImage_Png,
+  kImage_Svg_Xml,
+  kImage_Webp,
+  kImage_X_Icon,
+  kMultipart_Byteranges,
+  kMultipart_Form_Data,
+  kText_Css,
+  kText_Csv,
+  kText_Event_Stream,
+  kText_Html,
+  kText_Javascript,
+  kText_Plain,
+  kText_Xml,
+  kVideo_Mp4,
+  kVideo_Webm,
+};
+
+}  // namespace hypp::media_type
+
+namespace hypp::detail {
+
+struct MediaTypeName {
+  std::string_view type;
+  std::string_view subtype;
+};
+
+// Indexed by media_type::Id
+constexpr MediaTypeName kMediaTypes[] = {
+  {"", ""},
+  {"application", "gzip"},
+  {"application", "javascript"},
+  {"application", "json"},
+  {"application", "octet-stream"},
+  {"application", "pdf"},
+  {"application", "problem+json"},
+  {"application", "x-www-form-urlencoded"},
+  {"application", "xml"},
+  {"application", "zip"},
+  {"audio", "mpeg"},
+  {"audio", "ogg"},
+  {"font", "woff"},
+  {"font", "woff2"},
+  {"image", "gif"},
+  {"image", "jpeg"},
+  {"image", "png"},
+  {"image", "svg+xml"},
+  {"image", "webp"},
+  {"image", "x-icon"},
+  {"multipart", "byteranges"},
+  {"multipart", "form-data"},
+  {"text", "css"},
+  {"text", "csv"},
+  {"text", "event-stream"},
+  {"text", "html"},
+  {"text", "javascript"},
+  {"text", "plain"},
+  {"text", "xml"},
+  {"video", "mp4"},
+  {"video", "webm"},
+};
+
+}  // namespace hypp::detail
+
+namespace hypp::media_type {
+
+// Returns the ID of a media type (case-insensitive), or kUnknown.
+constexpr Id to_id(const std::string_view type,
+                   const std::string_view subtype) {
+  // The table is sorted by type, so only the entries of one type are compared
+  // by subtype.
+  for (id_t id = 1; id < std::size(detail::kMediaTypes); ++id) {
+    const auto& name = detail::kMediaTypes[id];
+    if (detail::equals_ignore_case(name.type, type)) {
+      for (; id < std::size(detail::kMediaTypes) &&
+             detail::kMediaTypes[id].type == name.type; ++id) {
+        if (detail::equals_ignore_case(detail::kMediaTypes[id].subtype,
+                                       subtype)) {
+          return static_cast<Id>(id);
+        }
+      }
+      break;
+    }
+    // Skip the remaining entries of this type
+    while (id + size_t{1} < std::size(detail::kMediaTypes) &&
+           detail::kMediaTypes[id + 1].type == name.type) {
+      ++id;
+    }
+  }
+  return kUnknown;
+}
+
+constexpr std::string_view to_type(const Id id) {
+  return id < std::size(detail::kMediaTypes) ? detail::kMediaTypes[id].type :
+                                               std::string_view{};
+}
+
+constexpr std::string_view to_subtype(const Id id) {
+  return id < std::size(detail::kMediaTypes) ? detail::kMediaTypes[id].subtype :
+                                               std::string_view{};
+}
+
+}  // namespace hypp::media_type
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <hypp/detail/parser.hpp>
+#include <hypp/error.hpp>
+#include <hypp/uri.hpp>
+
+namespace hypp {
+
+enum class ParsePhase {
+  StartLine,
+  Method,
+  RequestTarget,
+  Version,
+  StatusCode,
+  ReasonPhrase,
+  HeaderFields,  // the whole header section
+  HeaderName,
+  HeaderValue,
+  Body,
+};
+
+// Parse functions accept an observer that receives begin/end events for each
+// phase. `bytes` is the number of bytes consumed by the phase. If an observer
+// declares `static constexpr bool kTimestamps = true`, events also carry a
+// timestamp (TSC on x86, nanoseconds elsewhere); otherwise it is always zero.
+//
+// Observers may also declare `error(Error)`, which is called once if
+// ParseMessage fails, and `uri(const Uri&)`, which is called with the
+// request-target once it is parsed.
+//
+// The default observer does nothing, and compiles away completely.
+struct NullObserver {
+  static constexpr bool kTimestamps = false;
+
+  constexpr void begin(ParsePhase, std::uint64_t) {}
+  constexpr void end(ParsePhase, size_t, std::uint64_t) {}
+  constexpr void error(Error) {}
+};
+
+namespace detail {
+
+inline std::uint64_t ReadTimestamp() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+template <typename Observer, typename = void>
+struct ObserverTimestamps : std::false_type {};
+template <typename Observer>
+struct ObserverTimestamps<Observer, std::void_t<decltype(Observer::kTimestamps)>>
+    : std::bool_constant<Observer::kTimestamps> {};
+
+template <typename Observer, typename = void>
+struct ObserverErrors : std::false_type {};
+template <typename Observer>
+struct ObserverErrors<Observer, std::void_t<decltype(
+    std::declval<Observer&>().error(std::declval<Error>()))>>
+    : std::true_type {};
+
+template <typename Observer>
+void ObserveError(Observer& observer, const Error error) {
+  using observer_t = std::decay_t<Observer>;
+  if constexpr (!std::is_same_v<observer_t, NullObserver> &&
+                ObserverErrors<observer_t>::value) {
+    observer.error(error);
+  }
+}
+
+template <typename Observer, typename = void>
+struct ObserverUris : std::false_type {};
+template <typename Observer>
+struct ObserverUris<Observer, std::void_t<decltype(
+    std::declval<Observer&>().uri(std::declval<const Uri&>()))>>
+    : std::true_type {};
+
+template <typename Observer>
+void ObserveUri(Observer& observer, const Uri& uri) {
+  using observer_t = std::decay_t<Observer>;
+  if constexpr (!std::is_same_v<observer_t, NullObserver> &&
+                ObserverUris<observer_t>::value) {
+    observer.uri(uri);
+  }
+}
+
+// Reports a phase to an observer for the lifetime of the object.
+template <typename Observer>
+class ObservedPhase {
+public:
+  using observer_t = std::decay_t<Observer>;
+
+  static constexpr bool kEnabled = !std::is_same_v<observer_t, NullObserver>;
+  static constexpr bool kTimestamps = ObserverTimestamps<observer_t>::value;
+
+  ObservedPhase(observer_t& observer, const ParsePhase phase,
+                const Parser& parser)
+      : observer_{observer}, phase_{phase}, parser_{parser},
+        size_{parser.size()} {
+    if constexpr (kEnabled) {
+      observer_.begin(phase_, kTimestamps ? ReadTimestamp() : 0);
+    }
+  }
+
+  ~ObservedPhase() {
+    if constexpr (kEnabled) {
+      observer_.end(phase_, size_ - parser_.size(),
+                    kTimestamps ? ReadTimestamp() : 0);
+    }
+  }
+
+  ObservedPhase(const ObservedPhase&) = delete;
+  ObservedPhase& operator=(const ObservedPhase&) = delete;
+
+private:
+  observer_t& observer_;
+  const ParsePhase phase_;
+  const Parser& parser_;
+  const size_t size_;
+};
+
+}  // namespace detail
+
+}  // namespace hypp
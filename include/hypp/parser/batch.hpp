@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <hypp/detail/limits.hpp>
+#include <hypp/detail/parser.hpp>
+#include <hypp/detail/thread.hpp>
+#include <hypp/parser/request.hpp>
+#include <hypp/parser/uri.hpp>
+#include <hypp/batch.hpp>
+#include <hypp/error.hpp>
+#include <hypp/uri.hpp>
+
+namespace hypp {
+
+enum class UriBatchRule {
+  Uri,            // URI = scheme ":" hier-part [ "?" query ] [ "#" fragment ]
+  UriReference,   // URI-reference = URI / relative-ref
+  RequestTarget,  // request-target (RFC 7230)
+};
+
+namespace detail {
+
+// Same as ParseRequestTarget, but into views. The path of the asterisk-form
+// is "*", so that it is not mistaken for an empty origin-form.
+template <typename Limits>
+hypp::Expected<UriView> ParseRequestTargetView(Parser& parser) {
+  UriView uri;
+  Parser target_parser{parser};
+  const auto expected = ParseRequestTarget<UriView, Limits>(parser, uri);
+  if (!expected) {
+    return hypp::Unexpected{expected.error()};
+  }
+  if (expected.value() == RequestTarget::Form::Asterisk) {
+    uri.path = target_parser.read(1);
+  }
+  return uri;
+}
+
+template <typename Limits>
+hypp::Expected<UriView> ParseUriView(Parser& parser, const UriBatchRule rule) {
+  switch (rule) {
+    default:
+    case UriBatchRule::Uri:
+      return ParseUri<UriView, Limits>(parser);
+    case UriBatchRule::UriReference:
+      return ParseUriReference<UriView, Limits>(parser);
+    case UriBatchRule::RequestTarget:
+      return ParseRequestTargetView<Limits>(parser);
+  }
+}
+
+}  // namespace detail
+
+// Parses a column of URIs. The i-th URI is data[offsets[i], offsets[i + 1]),
+// so `offsets` has one more element than there are URIs. Rows are split into
+// chunks that are parsed on `threads` threads (0 for all cores), and each
+// thread writes directly into its own rows of the output columns.
+//
+// Offsets are 32-bit, so `data` must be smaller than 4 GiB.
+template <typename Limits = DefaultLimits>
+UriColumns ParseUriBatch(const std::string_view data,
+                         const std::vector<std::uint32_t>& offsets,
+                         const UriBatchRule rule = UriBatchRule::Uri,
+                         const size_t threads = 0) {
+  constexpr size_t kChunkSize = 4096;
+
+  UriColumns columns;
+  const size_t count = offsets.empty() ? 0 : offsets.size() - 1;
+  columns.resize(count);
+
+  const auto set = [&](const size_t row, const UriColumns::Component component,
+                       const std::optional<std::string_view>& view) {
+    if (view.has_value()) {
+      auto& column = columns.columns[component];
+      column.offsets[row] = static_cast<std::uint32_t>(view->data() - data.data());
+      column.lengths[row] = static_cast<std::uint32_t>(view->size());
+    }
+  };
+
+  detail::ParallelFor(count, kChunkSize, threads,
+      [&](const size_t begin, const size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+          Parser parser{data.substr(offsets[row], offsets[row + 1] - offsets[row])};
+          const auto expected = detail::ParseUriView<Limits>(parser, rule);
+          if (!expected || !parser.empty()) {
+            const auto error = expected ? Error::Invalid_URI : expected.error();
+            columns.errors[row] = static_cast<std::uint8_t>(error) + 1;
+            continue;
+          }
+          const auto& uri = expected.value();
+          set(row, UriColumns::kScheme, uri.scheme);
+          if (uri.authority.has_value()) {
+            set(row, UriColumns::kUserInfo, uri.authority->user_info);
+            set(row, UriColumns::kHost, uri.authority->host);
+            set(row, UriColumns::kPort, uri.authority->port);
+          }
+          set(row, UriColumns::kPath, uri.path);
+          set(row, UriColumns::kQuery, uri.query);
+          set(row, UriColumns::kFragment, uri.fragment);
+        }
+      });
+
+  return columns;
+}
+
+}  // namespace hypp
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <hypp/detail/limits.hpp>
+#include <hypp/detail/mmap.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/thread.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/framing.hpp>
+#include <hypp/parser/request.hpp>
+#include <hypp/parser/response.hpp>
+#include <hypp/error.hpp>
+#include <hypp/header.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+
+namespace hypp {
+
+struct BulkStatistics {
+  size_t bytes = 0;
+  size_t messages = 0;
+  size_t errors = 0;
+  double seconds = 0.0;
+
+  // Bytes per second
+  double throughput() const {
+    return seconds > 0.0 ? bytes / seconds : 0.0;
+  }
+};
+
+template <typename MessageT>
+struct BulkResult {
+  std::vector<Expected<MessageT>> messages;  // in input order
+  std::vector<size_t> offsets;  // of each message in the input
+  BulkStatistics statistics;
+};
+
+namespace detail {
+
+// Returns true if `view` begins with something that looks like a start line.
+// This is only used to find message boundaries, so it is intentionally loose;
+// the actual validation is done by the parser.
+inline bool IsStartLine(const std::string_view view) {
+  const auto is_version = [](const std::string_view v) {
+    return v.size() >= 8 && v.substr(0, 5) == "HTTP/" &&
+           is_digit(v[5]) && v[6] == '.' && is_digit(v[7]);
+  };
+
+  // status-line = HTTP-version SP status-code SP reason-phrase CRLF
+  if (is_version(view)) {
+    return view.size() >= 13 && view[8] == syntax::kSP &&
+           is_digit(view[9]) && is_digit(view[10]) && is_digit(view[11]) &&
+           view[12] == syntax::kSP;
+  }
+
+  // request-line = method SP request-target SP HTTP-version CRLF
+  const auto line = view.substr(0, view.find('\r'));
+  const auto method_end = line.find(syntax::kSP);
+  if (method_end == 0 || method_end == line.npos ||
+      !std::all_of(line.begin(), line.begin() + method_end, is_tchar)) {
+    return false;
+  }
+  const auto version_begin = line.rfind(syntax::kSP);
+  return version_begin > method_end + 1 &&
+         is_version(line.substr(version_begin + 1)) &&
+         line.size() == version_begin + 9;
+}
+
+// Returns the offset of the first line at or after `pos` that looks like a
+// start line, or the size of `view`.
+inline size_t FindStartLine(const std::string_view view, size_t pos) {
+  // Move to the beginning of the next line unless already there
+  if (pos > 0 && pos < view.size() && view[pos - 1] != '\n') {
+    pos = view.find('\n', pos);
+    pos = pos != view.npos ? pos + 1 : view.size();
+  }
+  while (pos < view.size()) {
+    if (IsStartLine(view.substr(pos))) {
+      return pos;
+    }
+    pos = view.find('\n', pos);
+    pos = pos != view.npos ? pos + 1 : view.size();
+  }
+  return view.size();
+}
+
+// Returns the size of the chunked message body at `pos`, including trailers.
+// A body that cannot be framed extends to the end of `view`, so that it is not
+// split into more messages and the parser reports it.
+// Reference: https://tools.ietf.org/html/rfc7230#section-4.1
+inline size_t FrameChunkedBody(const std::string_view view, size_t pos) {
+  while (pos < view.size()) {
+    const auto line_end = view.find(syntax::kCRLF, pos);
+    if (line_end == view.npos) {
+      return view.size();
+    }
+    const auto chunk_size = ParseChunkSize(view.substr(pos, line_end - pos));
+    if (!chunk_size) {
+      return view.size();
+    }
+    pos = line_end + 2;
+    // last-chunk trailer-part CRLF
+    if (chunk_size.value() == 0) {
+      while (pos < view.size()) {
+        const auto trailer_end = view.find(syntax::kCRLF, pos);
+        if (trailer_end == view.npos) {
+          return view.size();
+        }
+        const bool empty = trailer_end == pos;
+        pos = trailer_end + 2;
+        if (empty) break;
+      }
+      return std::min(pos, view.size());
+    }
+    // chunk-data CRLF
+    if (chunk_size.value() > view.size() - pos ||
+        view.size() - pos - chunk_size.value() < 2) {
+      return view.size();
+    }
+    pos += static_cast<size_t>(chunk_size.value());
+    if (view.substr(pos, 2) != syntax::kCRLF) {
+      return view.size();
+    }
+    pos += 2;
+  }
+  return view.size();
+}
+
+// Returns the size of the message at the beginning of `view`, following the
+// message body length rules. Messages that cannot be framed extend to the next
+// start line.
+// Reference: https://tools.ietf.org/html/rfc7230#section-3.3.3
+template <typename MessageT>
+size_t FrameMessage(const std::string_view view) {
+  constexpr bool kResponse = std::is_same_v<MessageT, Response>;
+
+  const auto head_end = view.find("\r\n\r\n");
+  if (head_end == view.npos) {
+    return FindStartLine(view, 1);
+  }
+  const size_t body_begin = head_end + 4;
+
+  if constexpr (kResponse) {
+    // 1xx, 204 and 304 responses are terminated by the end of the header
+    if (view.size() > 12) {
+      const auto code = view.substr(9, 3);
+      if (code[0] == '1' || code == "204" || code == "304") {
+        return body_begin;
+      }
+    }
+  }
+
+  // Invalid framing fields are ignored, as they only affect where the message
+  // is split
+  Framing framing;
+
+  for (size_t pos = view.find(syntax::kCRLF) + 2; pos < head_end; ) {
+    const auto line_end = view.find(syntax::kCRLF, pos);
+    const auto line = view.substr(pos, line_end - pos);
+    pos = line_end + 2;
+
+    const auto colon = line.find(':');
+    if (colon == line.npos) continue;
+    ParseFramingField(header::to_id(line.substr(0, colon)),
+                      line.substr(colon + 1), framing);
+  }
+
+  if (framing.chunked) {
+    return FrameChunkedBody(view, body_begin);
+  }
+  if (framing.content_length.has_value()) {
+    return body_begin + static_cast<size_t>(std::min<std::uint64_t>(
+        view.size() - body_begin, *framing.content_length));
+  }
+  if constexpr (kResponse) {
+    return FindStartLine(view, body_begin);
+  } else {
+    return body_begin;
+  }
+}
+
+template <typename MessageT>
+struct BulkPartition {
+  std::vector<hypp::Expected<MessageT>> messages;
+  std::vector<size_t> offsets;
+  size_t end = 0;
+};
+
+template <typename MessageT, typename Limits>
+void ParseBulkRange(const std::string_view data, size_t pos,
+                    const size_t limit, BulkPartition<MessageT>& partition) {
+  while (pos < limit) {
+    const auto view = data.substr(pos);
+    const size_t size = std::max<size_t>(FrameMessage<MessageT>(view), 1);
+    partition.messages.push_back(
+        hypp::ParseMessage<MessageT, Limits>(view.substr(0, size)));
+    partition.offsets.push_back(pos);
+    pos += size;
+  }
+  partition.end = pos;
+}
+
+// Partitions are at least this large, so that short inputs are not split.
+constexpr size_t kMinBulkPartitionSize = 1 << 16;
+
+// Splits `data` into `partition_count` partitions whose boundaries are moved
+// forward to the next line that looks like a start line, and parses them on
+// `threads` threads, `window` partitions at a time. Calls `visit(message,
+// offset)` for each message in input order. The messages of a window are
+// released before the next window is parsed.
+template <typename MessageT, typename Limits, typename Visitor>
+void ParseBulkPartitions(const std::string_view data, const size_t threads,
+                         const size_t partition_count, const size_t window,
+                         Visitor&& visit) {
+  std::vector<size_t> boundaries{0};
+  for (size_t i = 1; i < partition_count; ++i) {
+    const size_t pos = std::max(data.size() / partition_count * i,
+                                boundaries.back());
+    boundaries.push_back(FindStartLine(data, pos));
+  }
+  boundaries.push_back(data.size());
+
+  size_t cursor = 0;
+  for (size_t base = 0; base < partition_count; base += window) {
+    const size_t count = std::min(window, partition_count - base);
+    std::vector<BulkPartition<MessageT>> partitions(count);
+    ParallelFor(count, 1, threads,
+        [&](const size_t first, const size_t last) {
+          for (size_t i = first; i < last; ++i) {
+            ParseBulkRange<MessageT, Limits>(
+                data, boundaries[base + i], boundaries[base + i + 1],
+                partitions[i]);
+          }
+        });
+
+    for (size_t i = 0; i < count; ++i) {
+      auto* partition = &partitions[i];
+
+      // Resynchronize on the first message that starts where the previous
+      // partition ended, or re-parse the partition from there
+      size_t first = 0;
+      while (first < partition->offsets.size() &&
+             partition->offsets[first] < cursor) {
+        ++first;
+      }
+      BulkPartition<MessageT> reparsed;
+      if (first == partition->offsets.size() ?
+              partition->end != cursor : partition->offsets[first] != cursor) {
+        ParseBulkRange<MessageT, Limits>(data, cursor,
+                                         boundaries[base + i + 1], reparsed);
+        partition = &reparsed;
+        first = 0;
+      }
+
+      for (size_t j = first; j < partition->messages.size(); ++j) {
+        visit(std::move(partition->messages[j]), partition->offsets[j]);
+      }
+      cursor = partition->end;
+    }
+  }
+}
+
+inline size_t BulkPartitionCount(const size_t size, const size_t threads) {
+  return std::max<size_t>(1, std::min(ThreadCount(threads) * 8,
+                                      size / kMinBulkPartitionSize));
+}
+
+}  // namespace detail
+
+// Parses a sequence of concatenated messages on `threads` threads (0 for all
+// cores).
+//
+// The input is split into partitions whose boundaries are moved forward to the
+// next line that looks like a start line. Partitions are claimed dynamically by
+// the threads, and are stitched together in order afterwards. If a message
+// turns out to run past its partition boundary (e.g. a body that contains a
+// start line), the next partition is re-parsed from the end of that message.
+template <typename MessageT, typename Limits = DefaultLimits>
+BulkResult<MessageT> ParseBulk(const std::string_view data,
+                               const size_t threads = 0) {
+  const auto begin = std::chrono::steady_clock::now();
+
+  BulkResult<MessageT> result;
+  const size_t partition_count = detail::BulkPartitionCount(data.size(),
+                                                            threads);
+  detail::ParseBulkPartitions<MessageT, Limits>(
+      data, threads, partition_count, partition_count,
+      [&result](Expected<MessageT>&& expected, const size_t offset) {
+        if (!expected) {
+          ++result.statistics.errors;
+        }
+        result.messages.push_back(std::move(expected));
+        result.offsets.push_back(offset);
+      });
+
+  const auto end = std::chrono::steady_clock::now();
+  result.statistics.bytes = data.size();
+  result.statistics.messages = result.messages.size();
+  result.statistics.seconds = std::chrono::duration<double>(end - begin).count();
+
+  return result;
+}
+
+// Memory-maps the file at `path` and parses it with ParseBulk. Returns nothing
+// if the file cannot be opened.
+template <typename MessageT, typename Limits = DefaultLimits>
+std::optional<BulkResult<MessageT>> ParseBulkFile(const std::string& path,
+                                                  const size_t threads = 0) {
+  const detail::MappedFile file{path};
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  return ParseBulk<MessageT, Limits>(file.view(), threads);
+}
+
+}  // namespace hypp
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/list.hpp>
+
+namespace hypp {
+
+// Reference: https://tools.ietf.org/html/rfc7234#section-5.2
+enum CacheDirective : std::uint16_t {
+  kCacheNoCache         = 1 << 0,
+  kCacheNoStore         = 1 << 1,
+  kCacheNoTransform     = 1 << 2,
+  kCacheOnlyIfCached    = 1 << 3,  // request only
+  kCacheMustRevalidate  = 1 << 4,  // response only
+  kCachePublic          = 1 << 5,  // response only
+  kCachePrivate         = 1 << 6,  // response only
+  kCacheProxyRevalidate = 1 << 7,  // response only
+  kCacheImmutable       = 1 << 8,  // response only, RFC 8246
+};
+
+// The directives of a Cache-Control header field. Unknown directives are
+// ignored, as required.
+struct CacheControl {
+  std::uint16_t directives = 0;  // CacheDirective flags
+  std::optional<std::uint32_t> max_age;
+  std::optional<std::uint32_t> s_maxage;   // response only
+  std::optional<std::uint32_t> max_stale;  // request only
+  std::optional<std::uint32_t> min_fresh;  // request only
+  bool any_stale = false;  // "max-stale" without a value
+
+  constexpr bool has(const CacheDirective directive) const {
+    return directives & directive;
+  }
+};
+
+// delta-seconds = 1*DIGIT
+//
+// > If a cache receives a delta-seconds value greater than the greatest
+// integer it can represent, or if any of its subsequent calculations
+// overflows, the cache MUST consider the value to be either 2147483648 (2^31)
+// or the greatest positive integer it can conveniently represent.
+// Reference: https://tools.ietf.org/html/rfc7234#section-1.2.1
+constexpr std::optional<std::uint32_t> ParseDeltaSeconds(
+    const std::string_view value) {
+  constexpr std::uint32_t kMaxDeltaSeconds = 2147483648;
+
+  if (value.empty()) {
+    return std::nullopt;
+  }
+  std::uint64_t seconds = 0;
+  for (const char c : value) {
+    if (!detail::is_digit(c)) {
+      return std::nullopt;
+    }
+    if (seconds < kMaxDeltaSeconds) {
+      seconds = seconds * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+  }
+  return static_cast<std::uint32_t>(
+      seconds < kMaxDeltaSeconds ? seconds : kMaxDeltaSeconds);
+}
+
+namespace detail {
+
+// Values may be given as quoted-strings, but are not expected to contain
+// quoted-pairs.
+constexpr std::string_view UnquoteDirectiveValue(std::string_view value) {
+  if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+    value = value.substr(1, value.size() - 2);
+  }
+  return value;
+}
+
+// Directives with invalid values are left unset.
+constexpr void ParseCacheDirective(const std::string_view name,
+                                   const std::string_view value,
+                                   CacheControl& cache_control) {
+  const auto flag = [&cache_control](const CacheDirective directive) {
+    cache_control.directives |= directive;
+  };
+
+  if (equals_ignore_case(name, "max-age")) {
+    cache_control.max_age = ParseDeltaSeconds(UnquoteDirectiveValue(value));
+  } else if (equals_ignore_case(name, "s-maxage")) {
+    cache_control.s_maxage = ParseDeltaSeconds(UnquoteDirectiveValue(value));
+  } else if (equals_ignore_case(name, "max-stale")) {
+    if (value.empty()) {
+      cache_control.any_stale = true;
+    } else {
+      cache_control.max_stale =
+          ParseDeltaSeconds(UnquoteDirectiveValue(value));
+    }
+  } else if (equals_ignore_case(name, "min-fresh")) {
+    cache_control.min_fresh = ParseDeltaSeconds(UnquoteDirectiveValue(value));
+  } else if (equals_ignore_case(name, "no-cache")) {
+    // The field names of the qualified form are not kept, and the whole
+    // response is treated as unqualified no-cache, which is stricter.
+    flag(kCacheNoCache);
+  } else if (equals_ignore_case(name, "no-store")) {
+    flag(kCacheNoStore);
+  } else if (equals_ignore_case(name, "no-transform")) {
+    flag(kCacheNoTransform);
+  } else if (equals_ignore_case(name, "only-if-cached")) {
+    flag(kCacheOnlyIfCached);
+  } else if (equals_ignore_case(name, "must-revalidate")) {
+    flag(kCacheMustRevalidate);
+  } else if (equals_ignore_case(name, "public")) {
+    flag(kCachePublic);
+  } else if (equals_ignore_case(name, "private")) {
+    flag(kCachePrivate);
+  } else if (equals_ignore_case(name, "proxy-revalidate")) {
+    flag(kCacheProxyRevalidate);
+  } else if (equals_ignore_case(name, "immutable")) {
+    flag(kCacheImmutable);
+  }
+}
+
+}  // namespace detail
+
+// Cache-Control   = 1#cache-directive
+// cache-directive = token [ "=" ( token / quoted-string ) ]
+// Reference: https://tools.ietf.org/html/rfc7234#section-5.2
+//
+// Adds the directives in `value` to `cache_control`, so that it can be called
+// for each field of the same name.
+inline void ParseCacheControl(const std::string_view value,
+                              CacheControl& cache_control) {
+  for (const auto element : ListElements{value}) {
+    const auto pos = element.find('=');
+    const auto name = detail::TrimWhitespace(element.substr(0, pos));
+    const auto directive_value = pos != element.npos ?
+        detail::TrimWhitespace(element.substr(pos + 1)) : std::string_view{};
+    detail::ParseCacheDirective(name, directive_value, cache_control);
+  }
+}
+
+inline CacheControl ParseCacheControl(const std::string_view value) {
+  CacheControl cache_control;
+  ParseCacheControl(value, cache_control);
+  return cache_control;
+}
+
+}  // namespace hypp
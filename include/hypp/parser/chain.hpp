@@ -0,0 +1,618 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <hypp/detail/limits.hpp>
+#include <hypp/detail/parser.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/parser/framing.hpp>
+#include <hypp/parser/header.hpp>
+#include <hypp/parser/message.hpp>
+#include <hypp/parser/request.hpp>
+#include <hypp/parser/response.hpp>
+#include <hypp/buffer.hpp>
+#include <hypp/error.hpp>
+
+namespace hypp::detail {
+
+// Reads lines from a chain of buffers, e.g. the fixed-size slabs that data is
+// received into. A line that lies within a single buffer is returned as a view
+// into it. Only a line that crosses a boundary is copied, into a side buffer
+// that is reused for the next such line.
+class ChainReader {
+public:
+  ChainReader(const ConstBuffer* buffers, const size_t count)
+      : it_{buffers}, end_{buffers + count} {
+    skip_empty();
+  }
+
+  bool empty() const {
+    return it_ == end_;
+  }
+
+  // Returns the number of bytes that were read so far.
+  size_t position() const {
+    return position_;
+  }
+  // Returns the number of bytes that were copied into the side buffer so far.
+  size_t copied() const {
+    return copied_;
+  }
+
+  // Returns the bytes up to and including the next CRLF, or everything that is
+  // left if there is none. The view is valid until the next call. Returns
+  // nothing if the line would have to be copied, and is longer than `limit`.
+  std::optional<std::string_view> read_line(const size_t limit) {
+    using detail::syntax::kCRLF;
+
+    if (empty()) {
+      return std::string_view{};
+    }
+
+    const auto view = current();
+    if (const auto pos = view.find(kCRLF); pos != view.npos) {
+      advance(pos + 2);
+      return view.substr(0, pos + 2);
+    }
+    if (it_ + 1 == end_) {
+      advance(view.size());
+      return view;
+    }
+
+    side_.clear();
+    while (!empty()) {
+      const auto view = current();
+      auto end = view.npos;
+      if (!side_.empty() && side_.back() == '\r' && view.front() == '\n') {
+        end = 1;
+      } else if (const auto pos = view.find(kCRLF); pos != view.npos) {
+        end = pos + 2;
+      }
+      const auto size = std::min(end, view.size());
+      if (side_.size() + size > limit) {
+        return std::nullopt;
+      }
+      side_.append(view.data(), size);
+      advance(size);
+      if (end != view.npos) {
+        break;
+      }
+    }
+    copied_ += side_.size();
+    return std::string_view{side_};
+  }
+
+  size_t remaining() const {
+    size_t size = 0;
+    for (auto it = it_; it != end_; ++it) {
+      size += it->size;
+    }
+    return size - offset_;
+  }
+
+  void read_rest(std::string& output) {
+    output.reserve(output.size() + remaining());
+    read_each([&output](const std::string_view view) {
+      output.append(view);
+      return true;
+    });
+  }
+
+  // Passes the rest of the buffers to `function` one by one, until it returns
+  // false.
+  template <typename Function>
+  bool read_each(Function&& function) {
+    for (; it_ != end_; ++it_, offset_ = 0) {
+      const auto view = current();
+      position_ += view.size();
+      if (!function(view)) {
+        ++it_;
+        offset_ = 0;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Skips `n` bytes without reading them. Returns false if there are fewer.
+  bool skip(size_t n) {
+    while (n && !empty()) {
+      const auto size = std::min(n, current().size());
+      advance(size);
+      n -= size;
+    }
+    return !n;
+  }
+
+private:
+  std::string_view current() const {
+    return it_->view().substr(offset_);
+  }
+
+  void advance(const size_t n) {
+    offset_ += n;
+    position_ += n;
+    skip_empty();
+  }
+
+  void skip_empty() {
+    while (it_ != end_ && offset_ >= it_->size) {
+      ++it_;
+      offset_ = 0;
+    }
+  }
+
+  const ConstBuffer* it_;
+  const ConstBuffer* end_;
+  size_t offset_ = 0;
+  size_t position_ = 0;
+  std::string side_;
+  size_t copied_ = 0;
+};
+
+// The size of a message or a part of it, or nothing if it is incomplete
+using FrameSize = std::optional<size_t>;
+
+// Returns the size of the chunked message body that the reader is at,
+// including trailers, or nothing if it is incomplete. Bodies that cannot be
+// framed, or whose chunks add up to more than the body limit, are errors.
+// Reference: https://tools.ietf.org/html/rfc7230#section-4.1
+template <typename Limits>
+hypp::Expected<FrameSize> FrameChunkedBody(ChainReader& reader) {
+  constexpr std::string_view kCRLF = syntax::kCRLF;
+
+  const auto is_line = [&](const std::string_view line) {
+    return line.size() >= 2 && line.substr(line.size() - 2) == kCRLF;
+  };
+
+  const auto begin = reader.position();
+  std::uint64_t body_size = 0;
+  while (true) {
+    // chunk-size [ chunk-ext ] CRLF
+    const auto line = reader.read_line(Limits::kHeaderFields);
+    if (!line) {
+      return hypp::Unexpected{Error::Invalid_Transfer_Encoding};
+    }
+    if (!is_line(*line)) {
+      // An incomplete line can already be invalid
+      if (!line->empty() && !ParseChunkSize(*line)) {
+        return hypp::Unexpected{Error::Invalid_Transfer_Encoding};
+      }
+      return FrameSize{};
+    }
+    const auto chunk_size = ParseChunkSize(*line);
+    if (!chunk_size) {
+      return hypp::Unexpected{chunk_size.error()};
+    }
+    if (chunk_size.value() == 0) {
+      break;
+    }
+    if (chunk_size.value() > Limits::kBody - body_size) {
+      return hypp::Unexpected{Error::Payload_Too_Large};
+    }
+    body_size += chunk_size.value();
+
+    // chunk-data CRLF
+    if (!reader.skip(static_cast<size_t>(chunk_size.value()))) {
+      return FrameSize{};
+    }
+    const auto crlf = reader.read_line(Limits::kHeaderFields);
+    if (!crlf || *crlf != kCRLF) {
+      // Only the beginning of the CRLF may have arrived
+      if (crlf && reader.empty() && kCRLF.substr(0, crlf->size()) == *crlf) {
+        return FrameSize{};
+      }
+      return hypp::Unexpected{Error::Invalid_Transfer_Encoding};
+    }
+  }
+
+  // trailer-part CRLF
+  //
+  // Trailer fields are limited as a whole, like the header section
+  for (size_t size = 0; ; ) {
+    const auto trailer = reader.read_line(Limits::kHeaderFields);
+    if (!trailer || trailer->size() > Limits::kHeaderFields - size) {
+      return hypp::Unexpected{Error::Request_Header_Fields_Too_Large};
+    }
+    if (!is_line(*trailer)) {
+      return FrameSize{};
+    }
+    if (*trailer == kCRLF) {
+      return FrameSize{reader.position() - begin};
+    }
+    size += trailer->size();
+  }
+}
+
+// Decodes a chunked body that arrives in pieces, and passes only the chunk
+// data on, e.g. to a body sink. The CRLF that follows each chunk-data is
+// checked, and trailer fields are read but not passed on. Lines, and the
+// trailer fields as a whole, may not be longer than `line_limit`, and the
+// chunks may not add up to more than `body_limit`.
+// Reference: https://tools.ietf.org/html/rfc7230#section-4.1
+class ChunkedDecoder {
+public:
+  explicit ChunkedDecoder(
+      const size_t line_limit,
+      const std::uint64_t body_limit = std::numeric_limits<std::uint64_t>::max())
+      : line_limit_{line_limit}, body_limit_{body_limit} {}
+
+  // Returns true once the body, including its trailer fields, is complete.
+  bool done() const {
+    return state_ == State::Done;
+  }
+
+  // Decodes the beginning of `view`, and calls `write(data)` with each piece
+  // of chunk data. Returns the number of bytes that were used, which is less
+  // than the size of `view` only if the body is complete. Returns
+  // Payload_Too_Large if `write` returns false.
+  template <typename Write>
+  hypp::Expected<size_t> decode(std::string_view view, Write&& write) {
+    const auto size = view.size();
+    while (!view.empty() && state_ != State::Done) {
+      // chunk-data
+      if (state_ == State::Data) {
+        const auto n = static_cast<size_t>(
+            std::min<std::uint64_t>(remaining_, view.size()));
+        if (!write(view.substr(0, n))) {
+          return hypp::Unexpected{Error::Payload_Too_Large};
+        }
+        view.remove_prefix(n);
+        remaining_ -= n;
+        if (!remaining_) {
+          state_ = State::DataEnd;
+        }
+        continue;
+      }
+
+      // A chunk-size line, the CRLF after chunk-data, or a trailer field.
+      // Lines are only copied if they arrive in more than one piece.
+      const auto end = view.find('\n');
+      const auto n = end == view.npos ? view.size() : end + 1;
+      const size_t limit = state_ == State::Trailer ?
+          line_limit_ - trailer_size_ : line_limit_;
+      if (n > limit - std::min(limit, line_.size())) {
+        return hypp::Unexpected{state_ == State::Trailer ?
+            Error::Request_Header_Fields_Too_Large :
+            Error::Invalid_Transfer_Encoding};
+      }
+      std::string_view line = view.substr(0, n);
+      view.remove_prefix(n);
+      if (!line_.empty() || end == line.npos) {
+        line_.append(line);
+        line = line_;
+      }
+      if (end == line.npos) {
+        // An incomplete line can already be invalid
+        if ((state_ == State::Size && !ParseChunkSize(line)) ||
+            (state_ == State::DataEnd &&
+             std::string_view{syntax::kCRLF}.substr(0, line.size()) != line)) {
+          return hypp::Unexpected{Error::Invalid_Transfer_Encoding};
+        }
+        break;
+      }
+      if (const auto error = end_line(line)) {
+        return hypp::Unexpected{*error};
+      }
+      line_.clear();
+    }
+    return size - view.size();
+  }
+
+private:
+  enum class State {
+    Size,     // chunk-size [ chunk-ext ] CRLF
+    Data,     // chunk-data
+    DataEnd,  // the CRLF after chunk-data
+    Trailer,  // trailer-part CRLF
+    Done,
+  };
+
+  std::optional<Error> end_line(const std::string_view line) {
+    constexpr std::string_view kCRLF = syntax::kCRLF;
+    if (line.size() < 2 || line.substr(line.size() - 2) != kCRLF) {
+      return Error::Invalid_Transfer_Encoding;
+    }
+    switch (state_) {
+      case State::Size: {
+        const auto chunk_size = ParseChunkSize(line);
+        if (!chunk_size) {
+          return chunk_size.error();
+        }
+        if (chunk_size.value() > body_limit_ - body_size_) {
+          return Error::Payload_Too_Large;
+        }
+        body_size_ += chunk_size.value();
+        remaining_ = chunk_size.value();
+        state_ = remaining_ ? State::Data : State::Trailer;
+        break;
+      }
+      case State::DataEnd:
+        if (line != kCRLF) {
+          return Error::Invalid_Transfer_Encoding;
+        }
+        state_ = State::Size;
+        break;
+      case State::Trailer:
+        trailer_size_ += line.size();
+        if (line == kCRLF) {
+          state_ = State::Done;
+        }
+        break;
+      default:
+        break;
+    }
+    return std::nullopt;
+  }
+
+  size_t line_limit_;
+  std::uint64_t body_limit_;
+  State state_ = State::Size;
+  std::uint64_t remaining_ = 0;  // of the current chunk-data
+  std::uint64_t body_size_ = 0;  // of all chunk-data so far
+  size_t trailer_size_ = 0;
+  std::string line_;  // a line that arrived in pieces
+};
+
+// Returns the error that keeps the body that the reader is at from being
+// framed within the limits, if there is one. The body is not decoded, and an
+// incomplete body is not an error. Messages without any body bytes are not
+// checked, as they may be responses to HEAD requests.
+template <typename Limits, typename MessageT>
+std::optional<Error> CheckBodyFraming(const MessageT& message,
+                                      ChainReader reader) {
+  if (reader.empty()) {
+    return std::nullopt;
+  }
+  if constexpr (std::is_same_v<MessageT, Response>) {
+    // 1xx, 204 and 304 responses are terminated by the end of the header
+    const auto code = message.start_line.code;
+    if (code / 100 == 1 || code == 204 || code == 304) {
+      return std::nullopt;
+    }
+  }
+
+  // Invalid framing fields are ignored, as they are when framing the message
+  Framing framing;
+  for (const auto& header_field : message.header_fields) {
+    ParseFramingField(header_field.id, header_field.value, framing);
+  }
+
+  if (framing.chunked) {
+    if (const auto size = FrameChunkedBody<Limits>(reader); !size) {
+      return size.error();
+    }
+  } else if (framing.content_length &&
+             *framing.content_length > Limits::kBody) {
+    return Error::Payload_Too_Large;
+  }
+  return std::nullopt;
+}
+
+// Same as ParseMessage, but over a chain of buffers, and only up to the end of
+// the header section. Lines are parsed one by one with the same rules, so the
+// result is identical to parsing the concatenated buffers, except that a
+// single line that is copied may not be longer than the limit of its section.
+template <typename MessageT, typename Limits>
+hypp::Expected<MessageT> ParseMessageHead(ChainReader& reader) {
+  using namespace detail::syntax;
+
+  MessageT message;
+  NullObserver observer;
+
+  // start-line
+  constexpr bool kRequest = std::is_same_v<MessageT, Request>;
+  constexpr size_t kStartLine =
+      (kRequest ? Limits::kRequestLine : Limits::kStatusLine) + 2;
+  constexpr auto kStartLineTooLong =
+      kRequest ? Error::URI_Too_Long : Error::Bad_Response;
+  const auto copied = reader.copied();
+  auto line = reader.read_line(kStartLine);
+  if (!line) {
+    return hypp::Unexpected{kStartLineTooLong};
+  }
+  // The start-line parser decides whether a leading empty line is allowed
+  std::string start_line;
+  if (*line == kCRLF) {
+    const auto crlf = line->data();
+    line = reader.read_line(kStartLine);
+    if (!line) {
+      return hypp::Unexpected{kStartLineTooLong};
+    }
+    if (reader.copied() == copied && crlf + 2 == line->data()) {
+      line = std::string_view{crlf, line->size() + 2};
+    } else {
+      start_line = detail::concat(kCRLF, *line);
+      line = start_line;
+    }
+  }
+  Parser parser{*line};
+  if (const auto expected = ParseStartLine<Limits>(parser, message, observer)) {
+    message.start_line = expected.value();
+  } else {
+    return hypp::Unexpected{expected.error()};
+  }
+
+  // *( header-field CRLF ) CRLF
+  for (size_t size = 0; ; size += line->size()) {
+    if (size > Limits::kHeaderFields) {
+      return hypp::Unexpected{Error::Request_Header_Fields_Too_Large};
+    }
+    line = reader.read_line(Limits::kHeaderFields);
+    if (!line) {
+      return hypp::Unexpected{Error::Request_Header_Fields_Too_Large};
+    }
+    if (*line == kCRLF) {
+      break;  // Empty line indicates the end of the header section
+    }
+    if (line->empty()) {
+      return hypp::Unexpected{Error::Invalid_Header_Format};
+    }
+
+    // > A recipient that receives whitespace between the start-line and the
+    // first header field MUST either reject the message as invalid or consume
+    // each whitespace-preceded line without further processing of it.
+    // Reference: https://tools.ietf.org/html/rfc7230#section-3
+    Parser parser{*line};
+    if (message.header_fields.empty() && parser.strip(kWhitespace)) {
+      return hypp::Unexpected{Error::Invalid_Header_Format};
+    }
+
+    if (auto expected = ParseHeaderField<Limits>(parser)) {
+      message.header_fields.push_back(std::move(expected.value()));
+    } else {
+      return hypp::Unexpected{expected.error()};
+    }
+    if (!parser.skip(kCRLF) || !parser.empty()) {
+      return hypp::Unexpected{Error::Invalid_Header_Format};
+    }
+  }
+
+  return message;
+}
+
+template <typename MessageT, typename Limits>
+hypp::Expected<MessageT> ParseMessage(ChainReader& reader) {
+  auto expected = ParseMessageHead<MessageT, Limits>(reader);
+  if (!expected) {
+    return expected;
+  }
+  MessageT message = expected.value();
+
+  // [ message-body ]
+  //
+  // The body is not decoded, but a body that could never be framed within the
+  // limits is reported, e.g. when an input buffer has given up on it
+  if (const auto error = CheckBodyFraming<Limits>(message, reader)) {
+    return hypp::Unexpected{*error};
+  }
+  if (reader.remaining() > Limits::kBody) {
+    return hypp::Unexpected{Error::Payload_Too_Large};
+  }
+  reader.read_rest(message.body);
+
+  return message;
+}
+
+// Same as above, but passes the body to `sink` instead. Chunked bodies are
+// decoded, and bytes that follow the body are not passed on.
+template <typename MessageT, typename Limits, typename Sink>
+hypp::Expected<MessageT> ParseMessage(ChainReader& reader, Sink& sink) {
+  constexpr bool kResponse = std::is_same_v<MessageT, Response>;
+  constexpr auto kIncomplete = kResponse ? Error::Bad_Response :
+                                           Error::Bad_Request;
+
+  auto expected = ParseMessageHead<MessageT, Limits>(reader);
+  if (!expected) {
+    return expected;
+  }
+
+  // [ message-body ]
+  //
+  // Invalid framing fields are ignored, as they are when framing the message
+  Framing framing;
+  for (const auto& header_field : expected.value().header_fields) {
+    ParseFramingField(header_field.id, header_field.value, framing);
+  }
+  bool empty_body = !kResponse && !framing.chunked &&
+                    !framing.content_length;
+  if constexpr (kResponse) {
+    // 1xx, 204 and 304 responses are terminated by the end of the header
+    const auto code = expected.value().start_line.code;
+    empty_body = code / 100 == 1 || code == 204 || code == 304;
+  }
+
+  std::optional<Error> error;
+  if (empty_body) {
+    // No body
+  } else if (framing.chunked) {
+    ChunkedDecoder decoder{Limits::kHeaderFields};
+    reader.read_each([&](const std::string_view view) {
+      const auto size = decoder.decode(view, [&sink](const auto data) {
+        return sink.write(data);
+      });
+      if (!size) {
+        error = size.error();
+      }
+      return size && !decoder.done();
+    });
+    if (!error && !decoder.done()) {
+      error = kIncomplete;
+    }
+  } else if (framing.content_length) {
+    auto remaining = *framing.content_length;
+    reader.read_each([&](const std::string_view view) {
+      const auto data = view.substr(
+          0, static_cast<size_t>(std::min<std::uint64_t>(remaining,
+                                                         view.size())));
+      remaining -= data.size();
+      if (!data.empty() && !sink.write(data)) {
+        error = Error::Payload_Too_Large;
+      }
+      return !error && remaining;
+    });
+    if (!error && remaining) {
+      error = kIncomplete;
+    }
+  } else if (!reader.read_each([&sink](const std::string_view view) {
+               return sink.write(view);
+             })) {
+    // The body of a response extends until the connection is closed
+    error = Error::Payload_Too_Large;
+  }
+  if (error) {
+    return hypp::Unexpected{*error};
+  }
+  if (!sink.finish()) {
+    return hypp::Unexpected{Error::Payload_Too_Large};
+  }
+
+  return expected;
+}
+
+}  // namespace hypp::detail
+
+namespace hypp {
+
+// HTTP-message = start-line *( header-field CRLF ) CRLF [ message-body ]
+//
+// Parses a message that was received into several buffers, without copying
+// them into a contiguous string first. Only a line that crosses a boundary
+// between two buffers is copied.
+template <typename MessageT, typename Limits = DefaultLimits>
+Expected<MessageT> ParseMessage(const ConstBuffer* buffers,
+                                const size_t count) {
+  detail::ChainReader reader{buffers, count};
+  return detail::ParseMessage<MessageT, Limits>(reader);
+}
+
+template <typename MessageT, typename Limits = DefaultLimits>
+Expected<MessageT> ParseMessage(const ConstBuffers& buffers) {
+  return ParseMessage<MessageT, Limits>(buffers.data(), buffers.size());
+}
+
+// Same as above, but passes the body to a sink (see body.hpp) as it is read,
+// and leaves `Message::body` empty.
+template <typename MessageT, typename Limits = DefaultLimits, typename Sink>
+Expected<MessageT> ParseMessage(const ConstBuffers& buffers, Sink& sink) {
+  detail::ChainReader reader{buffers.data(), buffers.size()};
+  return detail::ParseMessage<MessageT, Limits>(reader, sink);
+}
+
+template <typename Limits = DefaultLimits>
+Expected<Request> ParseRequest(const ConstBuffers& buffers) {
+  return ParseMessage<Request, Limits>(buffers);
+}
+
+template <typename Limits = DefaultLimits>
+Expected<Response> ParseResponse(const ConstBuffers& buffers) {
+  return ParseMessage<Response, Limits>(buffers);
+}
+
+}  // namespace hypp
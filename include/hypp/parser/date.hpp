@@ -0,0 +1,229 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/list.hpp>
+
+namespace hypp {
+
+// Seconds since 1970-01-01T00:00:00Z
+using seconds_t = std::int64_t;
+
+namespace detail {
+
+// Returns the number of days since 1970-01-01 in the proleptic Gregorian
+// calendar.
+// Reference: https://howardhinnant.github.io/date_algorithms.html#days_from_civil
+constexpr seconds_t DaysFromCivil(seconds_t year, const unsigned month,
+                                  const unsigned day) {
+  year -= month <= 2;
+  const seconds_t era = (year >= 0 ? year : year - 399) / 400;
+  const auto yoe = static_cast<unsigned>(year - era * 400);  // [0, 399]
+  const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 +
+                       day - 1;                              // [0, 365]
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;  // [0, 146096]
+  return era * 146097 + static_cast<seconds_t>(doe) - 719468;
+}
+
+// Returns the year of the day that is `days` days after 1970-01-01.
+// Reference: https://howardhinnant.github.io/date_algorithms.html#civil_from_days
+constexpr seconds_t YearFromDays(seconds_t days) {
+  days += 719468;
+  const seconds_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const auto doe = static_cast<unsigned>(days - era * 146097);  // [0, 146096]
+  const unsigned yoe =
+      (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;    // [0, 399]
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);  // [0, 365]
+  const unsigned mp = (5 * doy + 2) / 153;                       // [0, 11]
+  return era * 400 + static_cast<seconds_t>(yoe) + (mp >= 10);
+}
+
+constexpr bool IsLeapYear(const seconds_t year) {
+  return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+inline seconds_t CurrentTime() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Reads exactly `n` digits.
+constexpr std::optional<unsigned> ParseDateDigits(std::string_view& view,
+                                                  const size_t n) {
+  if (view.size() < n) {
+    return std::nullopt;
+  }
+  unsigned value = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (!is_digit(view[i])) {
+      return std::nullopt;
+    }
+    value = value * 10 + static_cast<unsigned>(view[i] - '0');
+  }
+  view.remove_prefix(n);
+  return value;
+}
+
+constexpr bool SkipDateLiteral(std::string_view& view,
+                               const std::string_view literal) {
+  if (view.substr(0, literal.size()) != literal) {
+    return false;
+  }
+  view.remove_prefix(literal.size());
+  return true;
+}
+
+// month = %x4A.61.6E ; "Jan", case-sensitive
+//       / ...
+constexpr std::optional<unsigned> ParseMonth(std::string_view& view) {
+  constexpr std::string_view kMonths[] = {"Jan", "Feb", "Mar", "Apr",
+                                          "May", "Jun", "Jul", "Aug",
+                                          "Sep", "Oct", "Nov", "Dec"};
+  for (unsigned i = 0; i < 12; ++i) {
+    if (SkipDateLiteral(view, kMonths[i])) {
+      return i + 1;
+    }
+  }
+  return std::nullopt;
+}
+
+// time-of-day = hour ":" minute ":" second
+constexpr std::optional<seconds_t> ParseTimeOfDay(std::string_view& view) {
+  const auto hour = ParseDateDigits(view, 2);
+  if (!hour || !SkipDateLiteral(view, ":")) return std::nullopt;
+  const auto minute = ParseDateDigits(view, 2);
+  if (!minute || !SkipDateLiteral(view, ":")) return std::nullopt;
+  const auto second = ParseDateDigits(view, 2);
+  // > (...) a leap second (...) is represented by a second of 60.
+  if (!second || *hour > 23 || *minute > 59 || *second > 60) {
+    return std::nullopt;
+  }
+  return *hour * 3600 + *minute * 60 + *second;
+}
+
+constexpr std::optional<seconds_t> ToSeconds(const unsigned year,
+                                             const unsigned month,
+                                             const unsigned day,
+                                             const seconds_t time_of_day) {
+  constexpr unsigned kDaysInMonth[] = {31, 29, 31, 30, 31, 30,
+                                       31, 31, 30, 31, 30, 31};
+  if (day < 1 || day > kDaysInMonth[month - 1] ||
+      (month == 2 && day == 29 && !IsLeapYear(year))) {
+    return std::nullopt;
+  }
+  return DaysFromCivil(year, month, day) * 86400 + time_of_day;
+}
+
+}  // namespace detail
+
+// HTTP-date    = IMF-fixdate / obs-date
+// IMF-fixdate  = day-name "," SP date1 SP time-of-day SP GMT
+//              ; e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+// obs-date     = rfc850-date / asctime-date
+// rfc850-date  = day-name-l "," SP date2 SP time-of-day SP GMT
+//              ; e.g. "Sunday, 06-Nov-94 08:49:37 GMT"
+// asctime-date = day-name SP date3 SP time-of-day SP year
+//              ; e.g. "Sun Nov  6 08:49:37 1994"
+//
+// > Recipients of timestamp values are encouraged to be robust in parsing
+// timestamps unless otherwise restricted by the field definition.
+// Reference: https://tools.ietf.org/html/rfc7231#section-7.1.1.1
+//
+// The day name is not checked against the date. Two-digit years are taken to
+// be within 50 years of `now`.
+constexpr std::optional<seconds_t> ParseHttpDate(std::string_view view,
+                                                 const seconds_t now) {
+  using namespace detail;
+
+  view = TrimWhitespace(view);
+
+  // day-name, or day-name-l
+  size_t name_size = 0;
+  while (name_size < view.size() && is_alpha(view[name_size])) {
+    ++name_size;
+  }
+  if (name_size < 3) {
+    return std::nullopt;
+  }
+  view.remove_prefix(name_size);
+
+  // asctime-date
+  if (SkipDateLiteral(view, " ")) {
+    const auto month = ParseMonth(view);
+    if (!month || !SkipDateLiteral(view, " ")) return std::nullopt;
+    // date3 = month SP ( 2DIGIT / ( SP DIGIT ) )
+    SkipDateLiteral(view, " ");
+    std::optional<unsigned> day = ParseDateDigits(view, 2);
+    if (!day) day = ParseDateDigits(view, 1);
+    if (!day || !SkipDateLiteral(view, " ")) return std::nullopt;
+    const auto time_of_day = ParseTimeOfDay(view);
+    if (!time_of_day || !SkipDateLiteral(view, " ")) return std::nullopt;
+    const auto year = ParseDateDigits(view, 4);
+    if (!year || !view.empty()) return std::nullopt;
+    return ToSeconds(*year, *month, *day, *time_of_day);
+  }
+
+  if (!SkipDateLiteral(view, ", ")) {
+    return std::nullopt;
+  }
+  const auto day = ParseDateDigits(view, 2);
+  if (!day) {
+    return std::nullopt;
+  }
+
+  unsigned year = 0;
+  std::optional<unsigned> month;
+  if (SkipDateLiteral(view, " ")) {
+    // date1 = day SP month SP year
+    month = ParseMonth(view);
+    if (!month || !SkipDateLiteral(view, " ")) return std::nullopt;
+    const auto year4 = ParseDateDigits(view, 4);
+    if (!year4) return std::nullopt;
+    year = *year4;
+  } else if (SkipDateLiteral(view, "-")) {
+    // date2 = day "-" month "-" 2DIGIT
+    month = ParseMonth(view);
+    if (!month || !SkipDateLiteral(view, "-")) return std::nullopt;
+    const auto year2 = ParseDateDigits(view, 2);
+    if (!year2) return std::nullopt;
+    // > Recipients of a timestamp value in rfc850-date format, which uses a
+    // two-digit year, MUST interpret a timestamp that appears to be more than
+    // 50 years in the future as representing the most recent year in the past
+    // that had the same last two digits.
+    // Reference: https://tools.ietf.org/html/rfc7231#section-7.1.1.1
+    const auto current_year =
+        YearFromDays((now >= 0 ? now : now - 86399) / 86400);
+    auto full_year = current_year - current_year % 100 + *year2;
+    if (full_year > current_year + 50) {
+      full_year -= 100;
+    } else if (full_year <= current_year - 50) {
+      full_year += 100;
+    }
+    if (full_year < 0) {
+      return std::nullopt;
+    }
+    year = static_cast<unsigned>(full_year);
+  } else {
+    return std::nullopt;
+  }
+
+  if (!SkipDateLiteral(view, " ")) {
+    return std::nullopt;
+  }
+  const auto time_of_day = ParseTimeOfDay(view);
+  if (!time_of_day || view != " GMT") {
+    return std::nullopt;
+  }
+  return ToSeconds(year, *month, *day, *time_of_day);
+}
+
+inline std::optional<seconds_t> ParseHttpDate(const std::string_view view) {
+  return ParseHttpDate(view, detail::CurrentTime());
+}
+
+}  // namespace hypp
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <hypp/detail/swar.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/uri.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/list.hpp>
+#include <hypp/error.hpp>
+#include <hypp/header.hpp>
+
+namespace hypp {
+
+// Reference: https://tools.ietf.org/html/rfc7230#section-4
+enum TransferCoding : std::uint8_t {
+  kTransferCodingChunked  = 1 << 0,
+  kTransferCodingCompress = 1 << 1,  // also "x-compress"
+  kTransferCodingDeflate  = 1 << 2,
+  kTransferCodingGzip     = 1 << 3,  // also "x-gzip"
+  kTransferCodingIdentity = 1 << 4,
+  kTransferCodingOther    = 1 << 7,
+};
+
+// Reference: https://tools.ietf.org/html/rfc7230#section-6.1
+enum ConnectionOption : std::uint8_t {
+  kConnectionKeepAlive = 1 << 0,
+  kConnectionClose     = 1 << 1,
+  kConnectionUpgrade   = 1 << 2,
+  kConnectionOther     = 1 << 7,
+};
+
+// The header fields that determine how a message is delimited
+struct Framing {
+  std::optional<std::uint64_t> content_length;
+  std::uint8_t transfer_codings = 0;  // TransferCoding flags
+  std::uint8_t connection = 0;        // ConnectionOption flags
+  bool chunked = false;               // "chunked" is the final transfer coding
+
+  // > If a message is received with both a Transfer-Encoding and a
+  // Content-Length header field, the Transfer-Encoding overrides the
+  // Content-Length. Such a message might indicate an attempt to perform
+  // request smuggling or response splitting and ought to be handled as an
+  // error.
+  // Reference: https://tools.ietf.org/html/rfc7230#section-3.3.3
+  bool ambiguous() const {
+    return transfer_codings && content_length.has_value();
+  }
+};
+
+namespace detail {
+
+constexpr std::uint8_t ToTransferCoding(std::string_view coding) {
+  // transfer-coding = "chunked" / "compress" / "deflate" / "gzip" /
+  //                   transfer-extension
+  // transfer-extension = token *( OWS ";" OWS transfer-parameter )
+  coding = TrimWhitespace(coding.substr(0, coding.find(';')));
+  if (equals_ignore_case(coding, "chunked")) return kTransferCodingChunked;
+  if (equals_ignore_case(coding, "gzip")) return kTransferCodingGzip;
+  if (equals_ignore_case(coding, "x-gzip")) return kTransferCodingGzip;
+  if (equals_ignore_case(coding, "deflate")) return kTransferCodingDeflate;
+  if (equals_ignore_case(coding, "compress")) return kTransferCodingCompress;
+  if (equals_ignore_case(coding, "x-compress")) return kTransferCodingCompress;
+  if (equals_ignore_case(coding, "identity")) return kTransferCodingIdentity;
+  return kTransferCodingOther;
+}
+
+constexpr std::uint8_t ToConnectionOption(const std::string_view option) {
+  if (equals_ignore_case(option, "keep-alive")) return kConnectionKeepAlive;
+  if (equals_ignore_case(option, "close")) return kConnectionClose;
+  if (equals_ignore_case(option, "upgrade")) return kConnectionUpgrade;
+  return kConnectionOther;
+}
+
+}  // namespace detail
+
+// Content-Length = 1*DIGIT
+//
+// > If a message is received that has multiple Content-Length header fields
+// with field-values consisting of the same decimal value, or a single
+// Content-Length header field with a field value containing a list of
+// identical decimal values (e.g., "Content-Length: 42, 42"), indicating that
+// duplicate Content-Length header fields have been generated or combined by an
+// upstream message processor, then the recipient MUST either reject the
+// message as invalid or replace the duplicated field-values with a single
+// valid Content-Length field containing that decimal value prior to
+// determining the message body length or forwarding the message.
+// Reference: https://tools.ietf.org/html/rfc7230#section-3.3.2
+inline Expected<std::uint64_t> ParseContentLength(const std::string_view value) {
+  std::optional<std::uint64_t> length;
+  for (const auto element : ListElements{value}) {
+    const auto n = detail::swar::parse_digits(element);
+    if (!n || (length && *length != *n)) {
+      return Unexpected{Error::Invalid_Content_Length};
+    }
+    length = n;
+  }
+  if (!length) {
+    return Unexpected{Error::Invalid_Content_Length};
+  }
+  return *length;
+}
+
+// Transfer-Encoding = 1#transfer-coding
+//
+// Adds the codings in `value` to `framing`.
+inline std::optional<Error> ParseTransferEncoding(const std::string_view value,
+                                                  Framing& framing) {
+  for (const auto element : ListElements{value}) {
+    const auto coding = detail::ToTransferCoding(element);
+    // > A sender MUST NOT apply chunked more than once to a message body
+    // (i.e., chunking an already chunked message is not allowed).
+    // Reference: https://tools.ietf.org/html/rfc7230#section-3.3.1
+    if (coding & framing.transfer_codings & kTransferCodingChunked) {
+      return Error::Invalid_Transfer_Encoding;
+    }
+    framing.transfer_codings |= coding;
+    framing.chunked = coding == kTransferCodingChunked;
+  }
+  return std::nullopt;
+}
+
+// Connection = 1#connection-option
+inline std::uint8_t ParseConnection(const std::string_view value) {
+  std::uint8_t options = 0;
+  for (const auto element : ListElements{value}) {
+    options |= detail::ToConnectionOption(element);
+  }
+  return options;
+}
+
+// Adds a single header field to `framing`. Fields that are not related to
+// framing are ignored.
+inline std::optional<Error> ParseFramingField(const header::Id id,
+                                              const std::string_view value,
+                                              Framing& framing) {
+  switch (id) {
+    case header::kContent_Length:
+      if (const auto expected = ParseContentLength(value)) {
+        if (framing.content_length &&
+            *framing.content_length != expected.value()) {
+          return Error::Invalid_Content_Length;
+        }
+        framing.content_length = expected.value();
+      } else {
+        return expected.error();
+      }
+      break;
+    case header::kTransfer_Encoding:
+      return ParseTransferEncoding(value, framing);
+    case header::kConnection:
+      framing.connection |= ParseConnection(value);
+      break;
+    default:
+      break;
+  }
+  return std::nullopt;
+}
+
+// chunk = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
+// chunk-size = 1*HEXDIG
+//
+// Parses the chunk-size at the beginning of a chunk line. Sizes that do not
+// fit in 64 bits are rejected rather than wrapped, and so are lines that do
+// not begin with a chunk-size.
+// Reference: https://tools.ietf.org/html/rfc7230#section-4.1
+inline Expected<std::uint64_t> ParseChunkSize(const std::string_view line) {
+  constexpr size_t kMaxDigits = 16;
+
+  size_t i = 0;
+  std::uint64_t size = 0;
+  for (; i < line.size() && detail::is_hex_digit(line[i]); ++i) {
+    if (i == kMaxDigits) {
+      return Unexpected{Error::Invalid_Transfer_Encoding};
+    }
+    size = size * 16 +
+           static_cast<std::uint64_t>(detail::uri::hex_value(line[i]));
+  }
+  if (!i) {
+    return Unexpected{Error::Invalid_Transfer_Encoding};
+  }
+
+  // chunk-ext = *( BWS ";" BWS chunk-ext-name [ BWS "=" BWS chunk-ext-val ] )
+  // Reference: https://tools.ietf.org/html/rfc9112#section-7.1.1
+  using namespace detail::syntax;
+  if (i < line.size() && line[i] != ';' && line[i] != '\r' &&
+      line[i] != kSP && line[i] != kHTAB) {
+    return Unexpected{Error::Invalid_Transfer_Encoding};
+  }
+  return size;
+}
+
+// Parses the framing header fields in a single pass, without allocating.
+template <typename HeaderFieldsT>
+Expected<Framing> ParseFraming(const HeaderFieldsT& header_fields) {
+  Framing framing;
+  for (const auto& header_field : header_fields) {
+    if (const auto error = ParseFramingField(header_field.id,
+                                             header_field.value, framing)) {
+      return Unexpected{*error};
+    }
+  }
+  return framing;
+}
+
+}  // namespace hypp
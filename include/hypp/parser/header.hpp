@@ -1,24 +1,56 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
+
 #include <hypp/detail/limits.hpp>
 #include <hypp/detail/parser.hpp>
 #include <hypp/detail/syntax.hpp>
 #include <hypp/error.hpp>
 #include <hypp/header.hpp>
+#include <hypp/observer.hpp>
 
 namespace hypp {
 
 // field-name = token
-inline Expected<std::string_view> ParseHeaderFieldName(Parser& parser) {
-  const auto name = parser.match(detail::limits::kFieldName, detail::is_tchar);
+template <typename Limits = DefaultLimits>
+Expected<std::string_view> ParseHeaderFieldName(Parser& parser) {
+  const auto name = parser.match<Limits::kFieldName>(detail::is_tchar);
   if (name.empty()) {
     return Unexpected{Error::Invalid_Header_Name};
   }
   return name;
 }
 
+namespace detail {
+
+// Same as ParseHeaderFieldName, but also identifies well-known names. The hash
+// is computed during the scan, so that the lookup is a single table access and
+// comparison.
+template <typename Limits>
+hypp::Expected<std::string_view> ParseHeaderFieldName(Parser& parser,
+                                                      header::Id& id) {
+  std::uint32_t hash = kHeaderHashBasis;
+  const auto name = parser.match<Limits::kFieldName>(
+      [&hash](const char c) {
+        if (!is_tchar(c)) {
+          return false;
+        }
+        hash = HashHeaderName(hash, c);
+        return true;
+      });
+  if (name.empty()) {
+    return hypp::Unexpected{Error::Invalid_Header_Name};
+  }
+  id = FindHeaderId(name, hash);
+  return name;
+}
+
+}  // namespace detail
+
 // field-value = *( field-content / obs-fold )
-inline Expected<std::string_view> ParseHeaderFieldValue(Parser& parser) {
+template <typename Limits = DefaultLimits>
+Expected<std::string_view> ParseHeaderFieldValue(Parser& parser) {
   // field-content = field-vchar [ 1*( SP / HTAB ) field-vchar ]
   // field-vchar   = VCHAR / obs-text
   //
@@ -26,7 +58,7 @@ inline Expected<std::string_view> ParseHeaderFieldValue(Parser& parser) {
   // https://github.com/httpwg/http-core/issues/19
   //
   // Note that empty values are allowed.
-  return parser.match(detail::limits::kFieldValue,
+  return parser.match<Limits::kFieldValue>(
       [&parser](const char c) {
         switch (c) {
           default:
@@ -40,11 +72,16 @@ inline Expected<std::string_view> ParseHeaderFieldValue(Parser& parser) {
 }
 
 // header-field = field-name ":" OWS field-value OWS
-inline Expected<HeaderField> ParseHeaderField(Parser& parser) {
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<HeaderField> ParseHeaderField(Parser& parser,
+                                       Observer&& observer = {}) {
   HeaderField header_field;
 
   // field-name
-  if (const auto expected = ParseHeaderFieldName(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::HeaderName, parser};
+      const auto expected =
+          detail::ParseHeaderFieldName<Limits>(parser, header_field.id)) {
     header_field.name = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -62,7 +99,9 @@ inline Expected<HeaderField> ParseHeaderField(Parser& parser) {
   parser.strip(detail::syntax::kWhitespace);
 
   // field-value
-  if (const auto expected = ParseHeaderFieldValue(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::HeaderValue, parser};
+      const auto expected = ParseHeaderFieldValue<Limits>(parser)) {
     header_field.value = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -75,13 +114,18 @@ inline Expected<HeaderField> ParseHeaderField(Parser& parser) {
 }
 
 // *( header-field CRLF )
-inline Expected<HeaderFields> ParseHeaderFields(Parser& parser) {
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<HeaderFields> ParseHeaderFields(Parser& parser,
+                                         Observer&& observer = {}) {
+  const detail::ObservedPhase<Observer> phase{
+      observer, ParsePhase::HeaderFields, parser};
+
   HeaderFields header_fields;
 
   const auto initial_size = parser.size();
 
   while (!parser.empty()) {
-    if (initial_size - parser.size() > detail::limits::kHeaderFields) {
+    if (initial_size - parser.size() > Limits::kHeaderFields) {
       return Unexpected{Error::Request_Header_Fields_Too_Large};
     }
 
@@ -90,7 +134,7 @@ inline Expected<HeaderFields> ParseHeaderFields(Parser& parser) {
     }
 
     // *( header-field CRLF )
-    if (const auto expected = ParseHeaderField(parser)) {
+    if (const auto expected = ParseHeaderField<Limits>(parser, observer)) {
       header_fields.push_back(std::move(expected.value()));
     } else {
       return Unexpected{expected.error()};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+#include <hypp/detail/simd.hpp>
+#include <hypp/detail/syntax.hpp>
+
+namespace hypp {
+
+namespace detail {
+
+// OWS = *( SP / HTAB )
+constexpr std::string_view TrimWhitespace(std::string_view view) {
+  const auto first = view.find_first_not_of(syntax::kWhitespace);
+  if (first == view.npos) {
+    return {};
+  }
+  const auto last = view.find_last_not_of(syntax::kWhitespace);
+  return view.substr(first, last - first + 1);
+}
+
+// Returns the position of the first `delimiter` that is not inside a
+// quoted-string, or the size of `view`.
+//
+// quoted-string = DQUOTE *( qdtext / quoted-pair ) DQUOTE
+// quoted-pair   = "\" ( HTAB / SP / VCHAR / obs-text )
+// Reference: https://tools.ietf.org/html/rfc7230#section-3.2.6
+inline size_t FindUnquoted(const std::string_view view, const char delimiter) {
+  const char* const first = view.data();
+  const char* const last = first + view.size();
+
+  for (const char* p = first; ; ++p) {
+    p = simd::find_first_of(p, last, delimiter, '"');
+    if (p == last || *p == delimiter) {
+      return static_cast<size_t>(p - first);
+    }
+    // Skip the quoted-string. An unterminated one extends to the end.
+    for (++p; p != last && *p != '"'; ++p) {
+      if (*p == '\\' && p + 1 != last) {
+        ++p;
+      }
+    }
+    if (p == last) {
+      return view.size();
+    }
+  }
+}
+
+}  // namespace detail
+
+// A zero-copy range over the elements of a comma-separated list. Elements are
+// trimmed of OWS, and empty elements are skipped. Commas inside quoted-strings
+// do not separate elements.
+//
+// #rule = [ ( "," / element ) *( OWS "," [ OWS element ] ) ]
+// Reference: https://tools.ietf.org/html/rfc7230#section-7
+class ListElements {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    iterator() = default;
+    explicit iterator(const std::string_view list) : list_{list}, end_{false} {
+      next();
+    }
+
+    reference operator*() const {
+      return element_;
+    }
+    pointer operator->() const {
+      return &element_;
+    }
+
+    iterator& operator++() {
+      next();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it{*this};
+      next();
+      return it;
+    }
+
+    bool operator==(const iterator& rhs) const {
+      return end_ == rhs.end_ &&
+             (end_ || element_.data() == rhs.element_.data());
+    }
+    bool operator!=(const iterator& rhs) const {
+      return !(*this == rhs);
+    }
+
+  private:
+    void next() {
+      while (!list_.empty()) {
+        const auto pos = detail::FindUnquoted(list_, ',');
+        element_ = detail::TrimWhitespace(list_.substr(0, pos));
+        list_.remove_prefix(pos < list_.size() ? pos + 1 : list_.size());
+        if (!element_.empty()) {
+          return;
+        }
+      }
+      end_ = true;
+    }
+
+    std::string_view list_;
+    std::string_view element_;
+    bool end_ = true;
+  };
+
+  ListElements() = default;
+  explicit ListElements(const std::string_view list) : list_{list} {}
+
+  iterator begin() const {
+    return iterator{list_};
+  }
+  iterator end() const {
+    return {};
+  }
+
+  bool empty() const {
+    return begin() == end();
+  }
+
+private:
+  std::string_view list_;
+};
+
+}  // namespace hypp
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <hypp/detail/limits.hpp>
+#include <hypp/detail/parser.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/list.hpp>
+#include <hypp/error.hpp>
+#include <hypp/media_type.hpp>
+
+namespace hypp {
+
+// parameter = token "=" ( token / quoted-string )
+//
+// The value of a quoted-string is given without the surrounding quotes, but
+// quoted-pairs are not unescaped, so that it can still be a view.
+struct MediaTypeParameter {
+  std::string_view name;
+  std::string_view value;
+  bool quoted = false;
+
+  // Returns the value with quoted-pairs unescaped.
+  std::string unquoted_value() const {
+    std::string str;
+    str.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+      if (quoted && value[i] == '\\' && i + 1 < value.size()) {
+        ++i;
+      }
+      str.push_back(value[i]);
+    }
+    return str;
+  }
+};
+
+namespace detail {
+
+// quoted-string = DQUOTE *( qdtext / quoted-pair ) DQUOTE
+// qdtext        = HTAB / SP / %x21 / %x23-5B / %x5D-7E / obs-text
+// quoted-pair   = "\" ( HTAB / SP / VCHAR / obs-text )
+// Reference: https://tools.ietf.org/html/rfc7230#section-3.2.6
+//
+// Returns the contents, without the quotes.
+inline std::optional<std::string_view> ParseQuotedString(Parser& parser) {
+  Parser quoted_parser{parser};
+  if (!quoted_parser.skip('"')) {
+    return std::nullopt;
+  }
+  const auto size = quoted_parser.size();
+  size_t length = 0;
+  while (!quoted_parser.empty()) {
+    const char c = quoted_parser.read();
+    if (c == '"') {
+      parser.remove(1);
+      const auto contents = parser.read(length);
+      parser.remove(1);
+      return contents;
+    }
+    if (c == '\\') {
+      const char escaped = quoted_parser.read();
+      if (!(escaped == syntax::kHTAB || escaped == syntax::kSP ||
+            is_vchar(escaped) || is_obs_text(escaped))) {
+        return std::nullopt;
+      }
+    } else if (!(c == syntax::kHTAB || c == syntax::kSP || c == '\x21' ||
+                 ('\x23' <= c && c <= '\x5B') || ('\x5D' <= c && c <= '\x7E') ||
+                 is_obs_text(c))) {
+      return std::nullopt;
+    }
+    length = size - quoted_parser.size();
+  }
+  return std::nullopt;
+}
+
+// *( OWS ";" OWS [ parameter ] )
+//
+// Parses the next parameter. Returns nothing at the end of the input, or if
+// the input is invalid, in which case `valid` is set to false.
+inline std::optional<MediaTypeParameter> ParseMediaTypeParameter(
+    Parser& parser, bool& valid) {
+  valid = true;
+  while (!parser.empty()) {
+    parser.strip(syntax::kWhitespace);
+    if (!parser.skip(';')) {
+      valid = parser.empty();
+      return std::nullopt;
+    }
+    parser.strip(syntax::kWhitespace);
+    if (parser.empty() || parser.peek(';')) {
+      continue;  // empty parameters are allowed by RFC 9110
+    }
+
+    MediaTypeParameter parameter;
+    parameter.name = parser.match<DefaultLimits::kFieldValue>(is_tchar);
+    if (parameter.name.empty() || !parser.skip('=')) {
+      valid = false;
+      return std::nullopt;
+    }
+    if (parser.peek('"')) {
+      const auto value = ParseQuotedString(parser);
+      if (!value) {
+        valid = false;
+        return std::nullopt;
+      }
+      parameter.value = *value;
+      parameter.quoted = true;
+    } else {
+      parameter.value = parser.match<DefaultLimits::kFieldValue>(is_tchar);
+      if (parameter.value.empty()) {
+        valid = false;
+        return std::nullopt;
+      }
+    }
+    return parameter;
+  }
+  return std::nullopt;
+}
+
+}  // namespace detail
+
+// A zero-copy range over the parameters of a media type that has been
+// validated by ParseMediaType.
+class MediaTypeParameters {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = MediaTypeParameter;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const MediaTypeParameter*;
+    using reference = const MediaTypeParameter&;
+
+    iterator() = default;
+    explicit iterator(const std::string_view parameters)
+        : parser_{parameters}, end_{false} {
+      next();
+    }
+
+    reference operator*() const {
+      return parameter_;
+    }
+    pointer operator->() const {
+      return &parameter_;
+    }
+
+    iterator& operator++() {
+      next();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it{*this};
+      next();
+      return it;
+    }
+
+    bool operator==(const iterator& rhs) const {
+      return end_ == rhs.end_ &&
+             (end_ || parameter_.name.data() == rhs.parameter_.name.data());
+    }
+    bool operator!=(const iterator& rhs) const {
+      return !(*this == rhs);
+    }
+
+  private:
+    void next() {
+      bool valid = true;
+      const auto parameter = detail::ParseMediaTypeParameter(parser_, valid);
+      if (parameter) {
+        parameter_ = *parameter;
+      } else {
+        end_ = true;
+      }
+    }
+
+    Parser parser_{std::string_view{}};
+    MediaTypeParameter parameter_;
+    bool end_ = true;
+  };
+
+  MediaTypeParameters() = default;
+  explicit MediaTypeParameters(const std::string_view parameters)
+      : parameters_{parameters} {}
+
+  iterator begin() const {
+    return iterator{parameters_};
+  }
+  iterator end() const {
+    return {};
+  }
+
+  // Returns the first parameter named `name` (case-insensitive).
+  std::optional<MediaTypeParameter> get(const std::string_view name) const {
+    for (const auto& parameter : *this) {
+      if (detail::equals_ignore_case(parameter.name, name)) return parameter;
+    }
+    return std::nullopt;
+  }
+
+private:
+  std::string_view parameters_;
+};
+
+// Type, subtype and parameters are views into the parsed value.
+struct MediaType {
+  std::string_view type;
+  std::string_view subtype;
+  MediaTypeParameters parameters;
+  media_type::Id id = media_type::kUnknown;
+};
+
+// media-type = type "/" subtype *( OWS ";" OWS parameter )
+// type       = token
+// subtype    = token
+// Reference: https://tools.ietf.org/html/rfc7231#section-3.1.1.1
+inline Expected<MediaType> ParseMediaType(const std::string_view view) {
+  MediaType media_type;
+
+  Parser parser{detail::TrimWhitespace(view)};
+
+  // type "/" subtype
+  media_type.type = parser.match<DefaultLimits::kFieldValue>(detail::is_tchar);
+  if (media_type.type.empty() || !parser.skip('/')) {
+    return Unexpected{Error::Invalid_Media_Type};
+  }
+  media_type.subtype =
+      parser.match<DefaultLimits::kFieldValue>(detail::is_tchar);
+  if (media_type.subtype.empty()) {
+    return Unexpected{Error::Invalid_Media_Type};
+  }
+
+  // *( OWS ";" OWS parameter )
+  Parser parameters_parser{parser};
+  bool valid = true;
+  while (detail::ParseMediaTypeParameter(parameters_parser, valid)) {
+  }
+  if (!valid) {
+    return Unexpected{Error::Invalid_Media_Type};
+  }
+  media_type.parameters = MediaTypeParameters{parser.read_all()};
+
+  media_type.id = media_type::to_id(media_type.type, media_type.subtype);
+
+  return media_type;
+}
+
+}  // namespace hypp
@@ -8,30 +8,49 @@
 #include <hypp/parser/header.hpp>
 #include <hypp/error.hpp>
 #include <hypp/message.hpp>
+#include <hypp/observer.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
 
 namespace hypp {
 
 // message-body = *OCTET
-inline Expected<std::string_view> ParseMessageBody(Parser& parser) {
-  if (parser.size() > detail::limits::kBody) {
+template <typename Limits = DefaultLimits>
+Expected<std::string_view> ParseMessageBody(Parser& parser) {
+  if (parser.size() > Limits::kBody) {
     return Unexpected{Error::Payload_Too_Large};
   }
 
   return parser.read_all();
 }
 
+// start-line = request-line / status-line
+//
+// Defined in parser/request.hpp and parser/response.hpp.
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<RequestLine> ParseStartLine(Parser& parser, const Request&,
+                                     Observer&& observer = {});
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<StatusLine> ParseStartLine(Parser& parser, const Response&,
+                                    Observer&& observer = {});
+
+namespace detail {
+
 // HTTP-message = start-line *( header-field CRLF ) CRLF [ message-body ]
-template <typename MessageT>
-inline Expected<MessageT> ParseMessage(const std::string_view view) {
+template <typename MessageT, typename Limits, typename Observer>
+hypp::Expected<MessageT> ParseMessage(const std::string_view view,
+                                      Observer& observer) {
   MessageT message;
 
   Parser parser{view};
 
   // start-line
-  if (const auto expected = ParseStartLine(parser, message)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::StartLine, parser};
+      const auto expected = ParseStartLine<Limits>(parser, message, observer)) {
     message.start_line = expected.value();
   } else {
-    return Unexpected{expected.error()};
+    return hypp::Unexpected{expected.error()};
   }
 
   // > A recipient that receives whitespace between the start-line and the
@@ -39,27 +58,43 @@ inline Expected<MessageT> ParseMessage(const std::string_view view) {
   // each whitespace-preceded line without further processing of it.
   // Reference: https://tools.ietf.org/html/rfc7230#section-3
   if (parser.strip(detail::syntax::kWhitespace)) {
-    return Unexpected{Error::Invalid_Header_Format};
+    return hypp::Unexpected{Error::Invalid_Header_Format};
   }
 
   // *( header-field CRLF ) CRLF
-  if (const auto expected = ParseHeaderFields(parser)) {
+  if (const auto expected = ParseHeaderFields<Limits>(parser, observer)) {
     message.header_fields = expected.value();
   } else {
-    return Unexpected{expected.error()};
+    return hypp::Unexpected{expected.error()};
   }
   if (!parser.skip(detail::syntax::kCRLF)) {
-    return Unexpected{Error::Invalid_Header_Format};
+    return hypp::Unexpected{Error::Invalid_Header_Format};
   }
 
   // [ message-body ]
-  if (const auto expected = ParseMessageBody(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::Body, parser};
+      const auto expected = ParseMessageBody<Limits>(parser)) {
     message.body = expected.value();
   } else {
-    return Unexpected{expected.error()};
+    return hypp::Unexpected{expected.error()};
   }
 
   return message;
 }
 
+}  // namespace detail
+
+// HTTP-message = start-line *( header-field CRLF ) CRLF [ message-body ]
+template <typename MessageT, typename Limits = DefaultLimits,
+          typename Observer = NullObserver>
+Expected<MessageT> ParseMessage(const std::string_view view,
+                                Observer&& observer = {}) {
+  auto expected = detail::ParseMessage<MessageT, Limits>(view, observer);
+  if (!expected) {
+    detail::ObserveError(observer, expected.error());
+  }
+  return expected;
+}
+
 }  // namespace hypp
@@ -10,8 +10,9 @@
 namespace hypp {
 
 // method = token
-inline Expected<std::string_view> ParseMethod(Parser& parser) {
-  const auto view = parser.match(detail::limits::kMethod, detail::is_tchar);
+template <typename Limits = DefaultLimits>
+Expected<std::string_view> ParseMethod(Parser& parser) {
+  const auto view = parser.match<Limits::kMethod>(detail::is_tchar);
 
   if (view.empty()) {
     return Unexpected{Error::Invalid_Method};
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <hypp/detail/syntax.hpp>
+#include <hypp/detail/util.hpp>
+#include <hypp/parser/list.hpp>
+#include <hypp/parser/media_type.hpp>
+#include <hypp/header.hpp>
+#include <hypp/media_type.hpp>
+
+namespace hypp {
+
+// Quality values are kept as integers in thousandths, so that "0.5" is 500.
+using quality_t = std::uint16_t;
+
+constexpr quality_t kQualityMax = 1000;
+
+// qvalue = ( "0" [ "." 0*3DIGIT ] )
+//        / ( "1" [ "." 0*3("0") ] )
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.1
+constexpr std::optional<quality_t> ParseQuality(const std::string_view value) {
+  if (value.empty() || value.size() > 5 ||
+      (value[0] != '0' && value[0] != '1')) {
+    return std::nullopt;
+  }
+  if (value.size() > 1 && value[1] != '.') {
+    return std::nullopt;
+  }
+  quality_t quality = value[0] == '1' ? kQualityMax : 0;
+  quality_t scale = 100;
+  for (size_t i = 2; i < value.size(); ++i, scale /= 10) {
+    if (!detail::is_digit(value[i])) {
+      return std::nullopt;
+    }
+    quality += static_cast<quality_t>((value[i] - '0') * scale);
+  }
+  if (quality > kQualityMax) {
+    return std::nullopt;
+  }
+  return quality;
+}
+
+namespace detail {
+
+// The most specific range that matches an offer decides its quality.
+struct Preference {
+  quality_t quality = 0;
+  int specificity = -1;
+
+  constexpr bool matched() const {
+    return specificity >= 0;
+  }
+};
+
+// A list element with a weight, such as "gzip;q=0.5"
+struct WeightedElement {
+  std::string_view value;
+  MediaTypeParameters parameters;  // all parameters, including the weight
+  quality_t quality = kQualityMax;
+};
+
+// weight = OWS ";" OWS "q=" qvalue
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.1
+inline std::optional<quality_t> ParseWeight(
+    const MediaTypeParameters& parameters) {
+  const auto q = parameters.get("q");
+  return q ? ParseQuality(q->value) : kQualityMax;
+}
+
+inline std::optional<WeightedElement> ParseWeightedElement(
+    const std::string_view element) {
+  const auto pos = element.find(';');
+  WeightedElement weighted;
+  weighted.value = TrimWhitespace(element.substr(0, pos));
+  if (weighted.value.empty()) {
+    return std::nullopt;
+  }
+  if (pos != element.npos) {
+    // Validate the parameters before handing them out
+    Parser parser{element.substr(pos)};
+    bool valid = true;
+    while (ParseMediaTypeParameter(parser, valid)) {
+    }
+    if (!valid) {
+      return std::nullopt;
+    }
+    weighted.parameters = MediaTypeParameters{element.substr(pos)};
+  }
+  const auto quality = ParseWeight(weighted.parameters);
+  if (!quality) {
+    return std::nullopt;
+  }
+  weighted.quality = *quality;
+  return weighted;
+}
+
+// Calls `function` with each element of a single field value.
+template <typename Function>
+void ForEachElement(const std::string_view value, Function function) {
+  for (const auto element : ListElements{value}) {
+    function(element);
+  }
+}
+
+// Calls `function` with each element of all the fields named `id`, as if they
+// were combined into a single field.
+template <typename HeaderFieldsT, typename Function>
+void ForEachElement(const HeaderFieldsT& header_fields, const header::Id id,
+                    Function function) {
+  for (const auto& header_field : header_fields) {
+    if (IsHeaderField(header_field, id)) {
+      ForEachElement(header_field.value, function);
+    }
+  }
+}
+
+template <typename HeaderFieldsT>
+bool HasField(const HeaderFieldsT& header_fields, const header::Id id) {
+  for (const auto& header_field : header_fields) {
+    if (IsHeaderField(header_field, id)) return true;
+  }
+  return false;
+}
+
+// Finds the most specific element that matches an offer. `visit` calls its
+// argument with each list element, and `match` returns the specificity of a
+// match, or a negative value.
+template <typename Visit, typename Match>
+Preference FindPreference(Visit visit, Match match, size_t& count) {
+  Preference preference;
+  count = 0;
+  visit([&](const std::string_view element) {
+    const auto weighted = ParseWeightedElement(element);
+    if (!weighted) {
+      return;  // invalid elements are ignored
+    }
+    ++count;
+    const int specificity = match(*weighted);
+    if (specificity > preference.specificity) {
+      preference.specificity = specificity;
+      preference.quality = weighted->quality;
+    }
+  });
+  return preference;
+}
+
+// media-range = ( "*/*" / ( type "/" "*" ) / ( type "/" subtype ) )
+//               *( OWS ";" OWS parameter )
+//
+// > Media ranges can be overridden by more specific media ranges or specific
+// media types. If more than one media range applies to a given type, the most
+// specific reference has precedence.
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.2
+inline int MatchMediaRange(const WeightedElement& range,
+                           const MediaType& offer) {
+  const auto slash = range.value.find('/');
+  if (slash == range.value.npos) {
+    return -1;
+  }
+  const auto type = range.value.substr(0, slash);
+  const auto subtype = range.value.substr(slash + 1);
+
+  int specificity = 0;
+  if (type == "*") {
+    if (subtype != "*") {
+      return -1;
+    }
+  } else {
+    if (!equals_ignore_case(type, offer.type)) {
+      return -1;
+    }
+    specificity = 1;
+    if (subtype != "*") {
+      if (!equals_ignore_case(subtype, offer.subtype)) {
+        return -1;
+      }
+      specificity = 2;
+    }
+  }
+
+  // Parameters after the weight are accept-ext, and are not matched.
+  int parameters = 0;
+  for (const auto& parameter : range.parameters) {
+    if (equals_ignore_case(parameter.name, "q")) {
+      break;
+    }
+    const auto value = offer.parameters.get(parameter.name);
+    if (!value || !equals_ignore_case(value->value, parameter.value)) {
+      return -1;
+    }
+    ++parameters;
+  }
+
+  return (specificity << 8) | (parameters & 0xFF);
+}
+
+// codings = content-coding / "identity" / "*"
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.4
+inline int MatchCoding(const WeightedElement& coding,
+                       const std::string_view offer) {
+  if (coding.value == "*") return 0;
+  if (equals_ignore_case(coding.value, offer)) return 1;
+  return -1;
+}
+
+// language-range = (1*8ALPHA *("-" 1*8alphanum)) / "*"
+//
+// > A language range matches a particular language tag if, in a
+// case-insensitive comparison, it exactly equals the tag, or if it exactly
+// equals a prefix of the tag such that the first character following the
+// prefix is "-".
+// Reference: https://tools.ietf.org/html/rfc4647#section-3.3.1
+inline int MatchLanguageRange(const WeightedElement& range,
+                              const std::string_view offer) {
+  if (range.value == "*") {
+    return 0;
+  }
+  const auto size = range.value.size();
+  if (size > offer.size() || (size < offer.size() && offer[size] != '-') ||
+      !equals_ignore_case(range.value, offer.substr(0, size))) {
+    return -1;
+  }
+  return static_cast<int>(size);  // longer ranges are more specific
+}
+
+template <typename Visit>
+quality_t MediaTypeQuality(Visit visit, const std::string_view offer) {
+  const auto media_type = ParseMediaType(offer);
+  if (!media_type) {
+    return 0;
+  }
+  size_t count = 0;
+  const auto preference = FindPreference(visit,
+      [&media_type](const WeightedElement& range) {
+        return MatchMediaRange(range, media_type.value());
+      }, count);
+  if (!count) {
+    return kQualityMax;  // no preference
+  }
+  return preference.quality;
+}
+
+template <typename Visit>
+quality_t EncodingQuality(Visit visit, const std::string_view offer) {
+  size_t count = 0;
+  const auto preference = FindPreference(visit,
+      [offer](const WeightedElement& coding) {
+        return MatchCoding(coding, offer);
+      }, count);
+  if (!preference.matched()) {
+    // > If the representation has no content-coding, then it is acceptable by
+    // default unless specifically excluded by the Accept-Encoding field
+    // stating either "identity;q=0" or "*;q=0" without a more specific entry
+    // for "identity".
+    // Reference: https://tools.ietf.org/html/rfc7231#section-5.3.4
+    return equals_ignore_case(offer, "identity") ? kQualityMax : 0;
+  }
+  return preference.quality;
+}
+
+template <typename Visit>
+quality_t LanguageQuality(Visit visit, const std::string_view offer) {
+  size_t count = 0;
+  const auto preference = FindPreference(visit,
+      [offer](const WeightedElement& range) {
+        return MatchLanguageRange(range, offer);
+      }, count);
+  if (!count) {
+    return kQualityMax;  // no preference
+  }
+  return preference.quality;
+}
+
+// Returns the index of the first offer with the highest non-zero quality.
+// The list is rescanned for every offer instead of being copied, so nothing is
+// allocated for any number of elements or offers.
+template <typename Offers, typename Quality>
+std::optional<size_t> SelectOffer(const Offers& offers, Quality quality) {
+  std::optional<size_t> best;
+  quality_t best_quality = 0;
+  size_t index = 0;
+  for (const auto& offer : offers) {
+    const quality_t q = quality(std::string_view{offer});
+    if (q > best_quality) {
+      best = index;
+      best_quality = q;
+      if (q == kQualityMax) {
+        break;  // later offers can only tie
+      }
+    }
+    ++index;
+  }
+  return best;
+}
+
+template <typename HeaderFieldsT>
+using enable_if_header_fields_t =
+    std::enable_if_t<!std::is_convertible_v<HeaderFieldsT, std::string_view>>;
+
+}  // namespace detail
+
+// The quality functions take the value of a single field, and return the
+// quality of an offer between 0 (not acceptable) and kQualityMax.
+
+inline quality_t MediaTypeQuality(const std::string_view accept,
+                                  const std::string_view offer) {
+  return detail::MediaTypeQuality(
+      [accept](auto function) { detail::ForEachElement(accept, function); },
+      offer);
+}
+
+inline quality_t EncodingQuality(const std::string_view accept_encoding,
+                                 const std::string_view offer) {
+  return detail::EncodingQuality(
+      [accept_encoding](auto function) {
+        detail::ForEachElement(accept_encoding, function);
+      },
+      offer);
+}
+
+inline quality_t LanguageQuality(const std::string_view accept_language,
+                                 const std::string_view offer) {
+  return detail::LanguageQuality(
+      [accept_language](auto function) {
+        detail::ForEachElement(accept_language, function);
+      },
+      offer);
+}
+
+// The negotiation functions return the index of the best offer, or nothing if
+// no offer is acceptable. Offers are given in order of preference, so that the
+// first of equally acceptable offers is chosen. `offers` can be any range of
+// values that are convertible to std::string_view.
+//
+// Given a list of header fields, all fields of the same name are combined, and
+// every offer is acceptable if there are none.
+
+// Accept = #( media-range [ accept-params ] )
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.2
+template <typename Offers>
+std::optional<size_t> NegotiateMediaType(const std::string_view accept,
+                                         const Offers& offers) {
+  return detail::SelectOffer(offers, [accept](const std::string_view offer) {
+    return MediaTypeQuality(accept, offer);
+  });
+}
+
+template <typename HeaderFieldsT, typename Offers,
+          typename = detail::enable_if_header_fields_t<HeaderFieldsT>>
+std::optional<size_t> NegotiateMediaType(const HeaderFieldsT& header_fields,
+                                         const Offers& offers) {
+  return detail::SelectOffer(offers,
+      [&header_fields](const std::string_view offer) {
+        return detail::MediaTypeQuality(
+            [&header_fields](auto function) {
+              detail::ForEachElement(header_fields, header::kAccept, function);
+            },
+            offer);
+      });
+}
+
+// Accept-Encoding = #( codings [ weight ] )
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.4
+template <typename Offers>
+std::optional<size_t> NegotiateEncoding(const std::string_view accept_encoding,
+                                        const Offers& offers) {
+  return detail::SelectOffer(offers,
+      [accept_encoding](const std::string_view offer) {
+        return EncodingQuality(accept_encoding, offer);
+      });
+}
+
+template <typename HeaderFieldsT, typename Offers,
+          typename = detail::enable_if_header_fields_t<HeaderFieldsT>>
+std::optional<size_t> NegotiateEncoding(const HeaderFieldsT& header_fields,
+                                        const Offers& offers) {
+  // > If no Accept-Encoding field is in the request, any content-coding is
+  // considered acceptable by the user agent.
+  if (!detail::HasField(header_fields, header::kAccept_Encoding)) {
+    return detail::SelectOffer(offers,
+        [](const std::string_view) { return kQualityMax; });
+  }
+  return detail::SelectOffer(offers,
+      [&header_fields](const std::string_view offer) {
+        return detail::EncodingQuality(
+            [&header_fields](auto function) {
+              detail::ForEachElement(header_fields, header::kAccept_Encoding,
+                                     function);
+            },
+            offer);
+      });
+}
+
+// Accept-Language = 1#( language-range [ weight ] )
+// Reference: https://tools.ietf.org/html/rfc7231#section-5.3.5
+template <typename Offers>
+std::optional<size_t> NegotiateLanguage(const std::string_view accept_language,
+                                        const Offers& offers) {
+  return detail::SelectOffer(offers,
+      [accept_language](const std::string_view offer) {
+        return LanguageQuality(accept_language, offer);
+      });
+}
+
+template <typename HeaderFieldsT, typename Offers,
+          typename = detail::enable_if_header_fields_t<HeaderFieldsT>>
+std::optional<size_t> NegotiateLanguage(const HeaderFieldsT& header_fields,
+                                        const Offers& offers) {
+  return detail::SelectOffer(offers,
+      [&header_fields](const std::string_view offer) {
+        return detail::LanguageQuality(
+            [&header_fields](auto function) {
+              detail::ForEachElement(header_fields, header::kAccept_Language,
+                                     function);
+            },
+            offer);
+      });
+}
+
+}  // namespace hypp
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <hypp/detail/simd.hpp>
+#include <hypp/detail/uri.hpp>
+
+namespace hypp {
+
+// > The query component is often used to carry identifying information in the
+// form of "key=value" pairs (...)
+// Reference: https://tools.ietf.org/html/rfc3986#section-3.4
+//
+// There is no standard syntax for these pairs. We follow the
+// application/x-www-form-urlencoded parser, which splits on "&" and "=".
+// Reference: https://url.spec.whatwg.org/#urlencoded-parsing
+
+enum class QueryFormat {
+  Query,  // "+" is a literal character
+  Form,   // "+" is decoded as SP (application/x-www-form-urlencoded)
+};
+
+// Name and value are views into the original string, and are not decoded.
+struct QueryParameter {
+  std::string_view name;
+  std::string_view value;  // empty if there is no "=" delimiter
+  QueryFormat format = QueryFormat::Query;
+
+  DecodeView decoded_name() const {
+    return DecodeView{name, format == QueryFormat::Form};
+  }
+  DecodeView decoded_value() const {
+    return DecodeView{value, format == QueryFormat::Form};
+  }
+};
+
+// A zero-copy range over the parameters of a query or a form-urlencoded body.
+// Empty sequences between "&" delimiters are skipped.
+class QueryParameters {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = QueryParameter;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const QueryParameter*;
+    using reference = const QueryParameter&;
+
+    iterator() = default;
+    iterator(const std::string_view query, const QueryFormat format)
+        : query_{query}, pos_{0} {
+      parameter_.format = format;
+      next();
+    }
+
+    reference operator*() const {
+      return parameter_;
+    }
+    pointer operator->() const {
+      return &parameter_;
+    }
+
+    iterator& operator++() {
+      next();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it{*this};
+      next();
+      return it;
+    }
+
+    bool operator==(const iterator& rhs) const {
+      return end() == rhs.end() && (end() || position() == rhs.position());
+    }
+    bool operator!=(const iterator& rhs) const {
+      return !(*this == rhs);
+    }
+
+  private:
+    bool end() const {
+      return pos_ == std::string_view::npos;
+    }
+    const char* position() const {
+      return parameter_.name.data();
+    }
+
+    void next() {
+      const char* const first = query_.data();
+      const char* const last = first + query_.size();
+
+      while (!end() && pos_ < query_.size()) {
+        const char* const begin = first + pos_;
+        const char* delim = detail::simd::find_first_of(begin, last, '&', '=');
+        parameter_.name = {begin, static_cast<size_t>(delim - begin)};
+        parameter_.value = {};
+        if (delim != last && *delim == '=') {
+          const char* const value = delim + 1;
+          delim = static_cast<const char*>(
+              std::memchr(value, '&', last - value));
+          delim = delim ? delim : last;
+          parameter_.value = {value, static_cast<size_t>(delim - value)};
+        }
+        pos_ = delim != last ? (delim - first) + 1 : query_.size();
+        if (delim != begin) {
+          return;
+        }
+      }
+
+      pos_ = std::string_view::npos;
+    }
+
+    std::string_view query_;
+    size_t pos_ = std::string_view::npos;
+    QueryParameter parameter_;
+  };
+
+  QueryParameters() = default;
+  explicit QueryParameters(const std::string_view query,
+                           const QueryFormat format = QueryFormat::Query)
+      : query_{query}, format_{format} {}
+
+  iterator begin() const {
+    return {query_, format_};
+  }
+  iterator end() const {
+    return {};
+  }
+
+  // Returns the first parameter whose decoded name is `name`.
+  std::optional<QueryParameter> get(const std::string_view name) const {
+    for (const auto& parameter : *this) {
+      if (parameter.decoded_name() == name) return parameter;
+    }
+    return std::nullopt;
+  }
+
+private:
+  std::string_view query_;
+  QueryFormat format_ = QueryFormat::Query;
+};
+
+// An open-addressing hash index over QueryParameters, for repeated lookups.
+// Names are hashed in their decoded form, so "%61" and "a" are the same key.
+class QueryIndex {
+public:
+  explicit QueryIndex(const QueryParameters& parameters) {
+    for (const auto& parameter : parameters) {
+      parameters_.push_back(parameter);
+    }
+
+    size_t capacity = 8;
+    while (capacity < parameters_.size() * 2) {
+      capacity *= 2;
+    }
+    slots_.resize(capacity);
+
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+      const auto hash = hash_name(parameters_[i].decoded_name());
+      for (size_t j = hash & (capacity - 1); ; j = (j + 1) & (capacity - 1)) {
+        auto& slot = slots_[j];
+        if (!slot.index) {
+          slot = {hash, static_cast<std::uint32_t>(i + 1)};
+          break;
+        }
+        // Keep the first occurrence of duplicate names
+        if (slot.hash == hash) {
+          const auto lhs = parameters_[slot.index - 1].decoded_name();
+          const auto rhs = parameters_[i].decoded_name();
+          if (std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end())) {
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  size_t size() const {
+    return parameters_.size();
+  }
+
+  std::optional<QueryParameter> get(const std::string_view name) const {
+    const auto hash = hash_name(name);
+    const size_t mask = slots_.size() - 1;
+    for (size_t j = hash & mask; slots_[j].index; j = (j + 1) & mask) {
+      const auto& slot = slots_[j];
+      if (slot.hash == hash &&
+          parameters_[slot.index - 1].decoded_name() == name) {
+        return parameters_[slot.index - 1];
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  struct Slot {
+    std::uint32_t hash = 0;
+    std::uint32_t index = 0;  // 1-based, 0 for empty slots
+  };
+
+  // FNV-1a
+  template <typename Range>
+  static std::uint32_t hash_name(const Range& name) {
+    std::uint32_t hash = 2166136261u;
+    for (const char c : name) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+  }
+
+  std::vector<QueryParameter> parameters_;
+  std::vector<Slot> slots_;
+};
+
+}  // namespace hypp
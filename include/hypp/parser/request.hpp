@@ -1,5 +1,8 @@
 #pragma once
 
+#include <limits>
+
+#include <hypp/detail/limits.hpp>
 #include <hypp/detail/parser.hpp>
 #include <hypp/detail/syntax.hpp>
 #include <hypp/parser/message.hpp>
@@ -7,60 +10,98 @@
 #include <hypp/parser/uri.hpp>
 #include <hypp/parser/version.hpp>
 #include <hypp/error.hpp>
+#include <hypp/observer.hpp>
 #include <hypp/request.hpp>
 
 namespace hypp {
 
+namespace detail {
+
 // request-target = origin-form
 //                / absolute-form
 //                / authority-form
 //                / asterisk-form
-inline Expected<RequestTarget> ParseRequestTarget(Parser& parser) {
-  RequestTarget request_target;
+//
+// Parses into `uri`, which is a Uri or a UriView, and returns the form of the
+// request-target. The asterisk-form leaves `uri` empty.
+template <typename UriT, typename Limits>
+hypp::Expected<RequestTarget::Form> ParseRequestTarget(Parser& parser,
+                                                       UriT& uri) {
+  // > A server that receives a request-target longer than any URI it wishes
+  // to parse MUST respond with a 414 (URI Too Long) status code.
+  // Reference: https://tools.ietf.org/html/rfc7230#section-3.1.1
+  //
+  // The components are bounded on their own, so the whole request-target is
+  // measured first, up to the next SP or control character. The limit
+  // saturates, so that there is still one if kURI is the largest size.
+  constexpr size_t kLimit =
+      Limits::kURI + (Limits::kURI < std::numeric_limits<size_t>::max());
+  if (Parser target_parser{parser};
+      target_parser.match<kLimit>([](const char c) {
+        return is_vchar(c) || is_obs_text(c);
+      }).size() > Limits::kURI) {
+    return hypp::Unexpected{Error::URI_Too_Long};
+  }
 
   // origin-form = absolute-path [ "?" query ]
   if (parser.peek('/')) {
-    request_target.form = RequestTarget::Form::Origin;
-    if (const auto expected = detail::ParseUriPath(parser, detail::kUriAbsolutePath)) {
-      request_target.uri.path = expected.value();
+    if (const auto expected = ParseUriPath<Limits>(parser, kUriAbsolutePath)) {
+      uri.path = expected.value();
     } else {
-      return Unexpected{Error::Invalid_Request_Target};
+      return hypp::Unexpected{Error::Invalid_Request_Target};
     }
     if (parser.skip('?')) {
-      if (const auto expected = detail::ParseUriQuery(parser)) {
-        request_target.uri.query = expected.value();
+      if (const auto expected = ParseUriQuery<Limits>(parser)) {
+        uri.query = expected.value();
       } else {
-        return Unexpected{Error::Invalid_Request_Target};
+        return hypp::Unexpected{Error::Invalid_Request_Target};
       }
     }
-    return request_target;
+    return RequestTarget::Form::Origin;
   }
 
   // absolute-form = absolute-URI
-  if (const auto expected = detail::ParseAbsoluteUri(parser)) {
-    request_target.form = RequestTarget::Form::Absolute;
-    request_target.uri = expected.value();
-    return request_target;
+  if (const auto expected = ParseAbsoluteUri<UriT, Limits>(parser)) {
+    uri = expected.value();
+    return RequestTarget::Form::Absolute;
   }
 
   // asterisk-form = "*"
   if (parser.skip('*')) {
-    request_target.form = RequestTarget::Form::Asterisk;
-    return request_target;
+    return RequestTarget::Form::Asterisk;
   }
 
   // authority-form = authority
-  if (const auto expected = detail::ParseUriAuthority(parser)) {
-    request_target.form = RequestTarget::Form::Authority;
-    request_target.uri.authority = expected.value();
-    return request_target;
+  if (const auto expected =
+          ParseUriAuthority<typename UriT::Authority, Limits>(parser)) {
+    uri.authority = expected.value();
+    return RequestTarget::Form::Authority;
   }
 
-  return Unexpected{Error::Invalid_Request_Target};
+  return hypp::Unexpected{Error::Invalid_Request_Target};
+}
+
+}  // namespace detail
+
+// The observer receives the parsed URI (see observer.hpp).
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<RequestTarget> ParseRequestTarget(Parser& parser,
+                                           Observer&& observer = {}) {
+  RequestTarget request_target;
+  if (const auto expected = detail::ParseRequestTarget<Uri, Limits>(
+          parser, request_target.uri)) {
+    request_target.form = expected.value();
+  } else {
+    return Unexpected{expected.error()};
+  }
+  detail::ObserveUri(observer, request_target.uri);
+  return request_target;
 }
 
 // request-line = method SP request-target SP HTTP-version CRLF
-inline Expected<RequestLine> ParseRequestLine(Parser& parser) {
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<RequestLine> ParseRequestLine(Parser& parser,
+                                       Observer&& observer = {}) {
   RequestLine request_line;
 
   // > In the interest of robustness, a server that is expecting to receive
@@ -68,9 +109,12 @@ inline Expected<RequestLine> ParseRequestLine(Parser& parser) {
   // received prior to the request-line.
   // Reference: https://tools.ietf.org/html/rfc7230#section-3.5
   parser.skip(detail::syntax::kCRLF);
+  const auto line_size = parser.size();
 
   // method SP
-  if (const auto expected = ParseMethod(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::Method, parser};
+      const auto expected = ParseMethod<Limits>(parser)) {
     request_line.method = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -80,7 +124,9 @@ inline Expected<RequestLine> ParseRequestLine(Parser& parser) {
   }
 
   // request-target SP
-  if (const auto expected = ParseRequestTarget(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::RequestTarget, parser};
+      const auto expected = ParseRequestTarget<Limits>(parser, observer)) {
     request_line.target = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -90,11 +136,16 @@ inline Expected<RequestLine> ParseRequestLine(Parser& parser) {
   }
 
   // HTTP-version CRLF
-  if (const auto expected = ParseVersion(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::Version, parser};
+      const auto expected = ParseVersion(parser)) {
     request_line.version = expected.value();
   } else {
     return Unexpected{expected.error()};
   }
+  if (line_size - parser.size() > Limits::kRequestLine) {
+    return Unexpected{Error::URI_Too_Long};
+  }
   if (!parser.skip(detail::syntax::kCRLF)) {
     return Unexpected{Error::Bad_Request};
   }
@@ -102,12 +153,16 @@ inline Expected<RequestLine> ParseRequestLine(Parser& parser) {
   return request_line;
 }
 
-inline Expected<RequestLine> ParseStartLine(Parser& parser, const Request&) {
-  return ParseRequestLine(parser);
+template <typename Limits, typename Observer>
+Expected<RequestLine> ParseStartLine(Parser& parser, const Request&,
+                                     Observer&& observer) {
+  return ParseRequestLine<Limits>(parser, observer);
 }
 
-inline Expected<Request> ParseRequest(const std::string_view view) {
-  return ParseMessage<Request>(view);
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<Request> ParseRequest(const std::string_view view,
+                               Observer&& observer = {}) {
+  return ParseMessage<Request, Limits>(view, observer);
 }
 
 }  // namespace hypp
@@ -1,21 +1,28 @@
 #pragma once
 
+#include <hypp/detail/limits.hpp>
 #include <hypp/detail/parser.hpp>
 #include <hypp/detail/syntax.hpp>
 #include <hypp/parser/message.hpp>
 #include <hypp/parser/status.hpp>
 #include <hypp/parser/version.hpp>
 #include <hypp/error.hpp>
+#include <hypp/observer.hpp>
 #include <hypp/response.hpp>
 
 namespace hypp {
 
 // status-line = HTTP-version SP status-code SP reason-phrase CRLF
-inline Expected<StatusLine> ParseStatusLine(Parser& parser) {
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<StatusLine> ParseStatusLine(Parser& parser,
+                                     Observer&& observer = {}) {
   StatusLine status_line;
+  const auto line_size = parser.size();
 
   // HTTP-version SP
-  if (const auto expected = ParseVersion(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::Version, parser};
+      const auto expected = ParseVersion(parser)) {
     status_line.version = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -25,7 +32,9 @@ inline Expected<StatusLine> ParseStatusLine(Parser& parser) {
   }
 
   // status-code SP
-  if (const auto expected = ParseStatusCode(parser)) {
+  if (const detail::ObservedPhase<Observer> phase{
+          observer, ParsePhase::StatusCode, parser};
+      const auto expected = ParseStatusCode(parser)) {
     status_line.code = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -38,7 +47,14 @@ inline Expected<StatusLine> ParseStatusLine(Parser& parser) {
   //
   // > A client SHOULD ignore the reason-phrase content.
   // Reference: https://tools.ietf.org/html/rfc7230#section-3.1.2
-  ParseReasonPhrase(parser);
+  {
+    const detail::ObservedPhase<Observer> phase{
+        observer, ParsePhase::ReasonPhrase, parser};
+    ParseReasonPhrase<Limits>(parser);
+  }
+  if (line_size - parser.size() > Limits::kStatusLine) {
+    return Unexpected{Error::Bad_Response};
+  }
   if (!parser.skip(detail::syntax::kCRLF)) {
     return Unexpected{Error::Bad_Response};
   }
@@ -46,12 +62,16 @@ inline Expected<StatusLine> ParseStatusLine(Parser& parser) {
   return status_line;
 }
 
-inline Expected<StatusLine> ParseStartLine(Parser& parser, const Response&) {
-  return ParseStatusLine(parser);
+template <typename Limits, typename Observer>
+Expected<StatusLine> ParseStartLine(Parser& parser, const Response&,
+                                    Observer&& observer) {
+  return ParseStatusLine<Limits>(parser, observer);
 }
 
-inline Expected<Response> ParseResponse(const std::string_view view) {
-  return ParseMessage<Response>(view);
+template <typename Limits = DefaultLimits, typename Observer = NullObserver>
+Expected<Response> ParseResponse(const std::string_view view,
+                                 Observer&& observer = {}) {
+  return ParseMessage<Response, Limits>(view, observer);
 }
 
 }  // namespace hypp
@@ -11,9 +11,9 @@ namespace hypp {
 
 // status-code = 3DIGIT
 inline Expected<status::code_t> ParseStatusCode(Parser& parser) {
-  const auto view = parser.match(detail::limits::kStatusCode, detail::is_digit);
+  const auto view = parser.match<DefaultLimits::kStatusCode>(detail::is_digit);
 
-  if (view.size() != detail::limits::kStatusCode) {
+  if (view.size() != DefaultLimits::kStatusCode) {
     return Unexpected{Error::Invalid_Status_Code};
   }
 
@@ -21,8 +21,9 @@ inline Expected<status::code_t> ParseStatusCode(Parser& parser) {
 }
 
 // reason-phrase = *( HTAB / SP / VCHAR / obs-text )
-inline Expected<std::string_view> ParseReasonPhrase(Parser& parser) {
-  return parser.match(detail::limits::kReasonPhrase,
+template <typename Limits = DefaultLimits>
+Expected<std::string_view> ParseReasonPhrase(Parser& parser) {
+  return parser.match<Limits::kReasonPhrase>(
       [](const char c) {
         switch (c) {
           case detail::syntax::kHTAB:
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+#include <hypp/detail/parser.hpp>
+#include <hypp/detail/syntax.hpp>
+#include <hypp/parser/request.hpp>
+#include <hypp/parser/response.hpp>
+#include <hypp/parser/version.hpp>
+#include <hypp/error.hpp>
+#include <hypp/header.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+#include <hypp/uri.hpp>
+
+namespace hypp {
+
+// Messages that have already been validated (e.g. by an edge proxy) can be
+// parsed in trusted mode, which only looks for delimiters and does not check
+// the characters in between. The output is the same as in strict mode for
+// valid input; for invalid input it is unspecified, but always within bounds.
+enum class Validation {
+  Strict,
+  Trusted,
+};
+
+namespace detail {
+
+// Returns the part of `view` before `c`, and removes it from `view` along with
+// `c`. If there is no `c`, returns the whole view.
+inline std::string_view TrustedSplit(std::string_view& view, const char c) {
+  const auto pos = view.find(c);
+  const auto part = view.substr(0, pos);
+  view.remove_prefix(pos != view.npos ? pos + 1 : view.size());
+  return part;
+}
+
+inline std::string_view TrustedTrimWhitespace(std::string_view view) {
+  while (!view.empty() && (view.front() == detail::syntax::kSP ||
+                           view.front() == detail::syntax::kHTAB)) {
+    view.remove_prefix(1);
+  }
+  while (!view.empty() && (view.back() == detail::syntax::kSP ||
+                           view.back() == detail::syntax::kHTAB)) {
+    view.remove_suffix(1);
+  }
+  return view;
+}
+
+// Reads up to the next CRLF, and removes the line along with the CRLF.
+inline bool TrustedReadLine(Parser& parser, std::string_view& line) {
+  Parser line_parser{parser};
+  auto view = line_parser.read_all();
+  const auto pos = view.find(detail::syntax::kCRLF);
+  if (pos == view.npos) {
+    return false;
+  }
+  line = parser.read(pos);
+  parser.remove(2);
+  return true;
+}
+
+// authority = [ userinfo "@" ] host [ ":" port ]
+inline Uri::Authority TrustedSplitAuthority(std::string_view view) {
+  Uri::Authority authority;
+
+  if (const auto pos = view.find('@'); pos != view.npos) {
+    authority.user_info = view.substr(0, pos);
+    view.remove_prefix(pos + 1);
+  }
+
+  // IP-literal = "[" ( IPv6address / IPvFuture  ) "]"
+  const auto host_end = view.find(']');
+  const auto colon = view.find(':', host_end != view.npos ? host_end : 0);
+  if (colon != view.npos) {
+    authority.port = view.substr(colon + 1);
+    view = view.substr(0, colon);
+  }
+  if (view.size() >= 2 && view.front() == '[' && view.back() == ']') {
+    view = view.substr(1, view.size() - 2);
+  }
+  authority.host = view;
+
+  return authority;
+}
+
+// path [ "?" query ] [ "#" fragment ]
+inline void TrustedSplitPath(std::string_view view, Uri& uri) {
+  if (const auto pos = view.find('#'); pos != view.npos) {
+    uri.fragment = view.substr(pos + 1);
+    view = view.substr(0, pos);
+  }
+  if (const auto pos = view.find('?'); pos != view.npos) {
+    uri.query = view.substr(pos + 1);
+    view = view.substr(0, pos);
+  }
+  uri.path = view;
+}
+
+}  // namespace detail
+
+namespace trusted {
+
+// request-target = origin-form / absolute-form / authority-form / asterisk-form
+inline Expected<RequestTarget> ParseRequestTarget(std::string_view view) {
+  RequestTarget request_target;
+
+  if (view.empty()) {
+    return Unexpected{Error::Invalid_Request_Target};
+  }
+
+  // origin-form = absolute-path [ "?" query ]
+  if (view.front() == '/') {
+    request_target.form = RequestTarget::Form::Origin;
+    detail::TrustedSplitPath(view, request_target.uri);
+    return request_target;
+  }
+
+  // asterisk-form = "*"
+  if (view == "*") {
+    request_target.form = RequestTarget::Form::Asterisk;
+    return request_target;
+  }
+
+  // absolute-form = scheme ":" hier-part [ "?" query ]
+  //
+  // authority-form is distinguished by the lack of "//" after the first colon.
+  // Reference: https://tools.ietf.org/html/rfc7230#section-5.3
+  const auto colon = view.find(':');
+  if (colon != view.npos && view.substr(colon + 1, 2) == "//") {
+    request_target.form = RequestTarget::Form::Absolute;
+    request_target.uri.scheme = view.substr(0, colon);
+    view.remove_prefix(colon + 3);
+    const auto authority_end = view.find_first_of("/?#");
+    request_target.uri.authority =
+        detail::TrustedSplitAuthority(view.substr(0, authority_end));
+    detail::TrustedSplitPath(authority_end != view.npos ?
+                             view.substr(authority_end) : std::string_view{},
+                             request_target.uri);
+    return request_target;
+  }
+
+  // authority-form = authority
+  request_target.form = RequestTarget::Form::Authority;
+  request_target.uri.authority = detail::TrustedSplitAuthority(view);
+  return request_target;
+}
+
+// request-line = method SP request-target SP HTTP-version CRLF
+inline Expected<RequestLine> ParseRequestLine(Parser& parser) {
+  RequestLine request_line;
+
+  parser.skip(detail::syntax::kCRLF);
+
+  std::string_view line;
+  if (!detail::TrustedReadLine(parser, line)) {
+    return Unexpected{Error::Bad_Request};
+  }
+
+  // method SP
+  const auto method_end = line.find(detail::syntax::kSP);
+  // SP HTTP-version
+  const auto version_begin = line.rfind(detail::syntax::kSP);
+  if (method_end == line.npos || method_end == version_begin) {
+    return Unexpected{Error::Bad_Request};
+  }
+  request_line.method = line.substr(0, method_end);
+
+  // request-target
+  const auto target = line.substr(method_end + 1,
+                                  version_begin - method_end - 1);
+  if (auto expected = ParseRequestTarget(target)) {
+    request_line.target = std::move(expected.value());
+  } else {
+    return Unexpected{expected.error()};
+  }
+
+  // HTTP-version
+  Parser version_parser{line.substr(version_begin + 1)};
+  if (const auto expected = ParseVersion(version_parser)) {
+    request_line.version = expected.value();
+  } else {
+    return Unexpected{expected.error()};
+  }
+
+  return request_line;
+}
+
+// status-line = HTTP-version SP status-code SP reason-phrase CRLF
+inline Expected<StatusLine> ParseStatusLine(Parser& parser) {
+  StatusLine status_line;
+
+  std::string_view line;
+  if (!detail::TrustedReadLine(parser, line)) {
+    return Unexpected{Error::Bad_Response};
+  }
+
+  // HTTP-version SP
+  Parser version_parser{detail::TrustedSplit(line, detail::syntax::kSP)};
+  if (const auto expected = ParseVersion(version_parser)) {
+    status_line.version = expected.value();
+  } else {
+    return Unexpected{expected.error()};
+  }
+
+  // status-code
+  if (line.size() < 3) {
+    return Unexpected{Error::Invalid_Status_Code};
+  }
+  status_line.code = (line[0] - '0') * 100 + (line[1] - '0') * 10 +
+                     (line[2] - '0');
+
+  // The reason-phrase is ignored, as in strict mode.
+
+  return status_line;
+}
+
+// *( header-field CRLF ) CRLF
+inline Expected<HeaderFields> ParseHeaderFields(Parser& parser) {
+  HeaderFields header_fields;
+
+  std::string_view line;
+  while (detail::TrustedReadLine(parser, line)) {
+    if (line.empty()) {
+      return header_fields;  // Empty line indicates the end of the header section
+    }
+
+    // header-field = field-name ":" OWS field-value OWS
+    const auto colon = line.find(':');
+    if (colon == line.npos || colon == 0) {
+      return Unexpected{Error::Invalid_Header_Format};
+    }
+    const auto name = line.substr(0, colon);
+    header_fields.push_back({
+        std::string{name},
+        std::string{detail::TrustedTrimWhitespace(line.substr(colon + 1))},
+        header::to_id(name)});
+  }
+
+  return Unexpected{Error::Invalid_Header_Format};
+}
+
+// HTTP-message = start-line *( header-field CRLF ) CRLF [ message-body ]
+template <typename MessageT>
+Expected<MessageT> ParseMessage(const std::string_view view) {
+  MessageT message;
+
+  Parser parser{view};
+
+  // start-line
+  if constexpr (std::is_same_v<MessageT, Request>) {
+    if (auto expected = ParseRequestLine(parser)) {
+      message.start_line = std::move(expected.value());
+    } else {
+      return Unexpected{expected.error()};
+    }
+  } else {
+    if (const auto expected = ParseStatusLine(parser)) {
+      message.start_line = expected.value();
+    } else {
+      return Unexpected{expected.error()};
+    }
+  }
+
+  // *( header-field CRLF ) CRLF
+  if (auto expected = ParseHeaderFields(parser)) {
+    message.header_fields = std::move(expected.value());
+  } else {
+    return Unexpected{expected.error()};
+  }
+
+  // [ message-body ]
+  message.body = parser.read_all();
+
+  return message;
+}
+
+inline Expected<Request> ParseRequest(const std::string_view view) {
+  return ParseMessage<Request>(view);
+}
+
+inline Expected<Response> ParseResponse(const std::string_view view) {
+  return ParseMessage<Response>(view);
+}
+
+}  // namespace trusted
+
+// Selects the validation mode at runtime, e.g. per connection.
+inline Expected<Request> ParseRequest(const std::string_view view,
+                                      const Validation validation) {
+  return validation == Validation::Trusted ? trusted::ParseRequest(view) :
+                                             ParseRequest(view);
+}
+
+inline Expected<Response> ParseResponse(const std::string_view view,
+                                        const Validation validation) {
+  return validation == Validation::Trusted ? trusted::ParseResponse(view) :
+                                             ParseResponse(view);
+}
+
+}  // namespace hypp
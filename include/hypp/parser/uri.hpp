@@ -11,11 +11,12 @@ namespace hypp {
 namespace detail {
 
 // scheme = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." )
-inline hypp::Expected<std::string_view> ParseUriScheme(Parser& parser) {
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriScheme(Parser& parser) {
   if (!parser.peek(is_alpha)) {
     return hypp::Unexpected{Error::Invalid_URI_Scheme};
   }
-  return parser.match(limits::kScheme,
+  return parser.match<Limits::kScheme>(
       [](const char c) {
         switch (c) {
           case '+': case '-': case '.':
@@ -29,8 +30,9 @@ inline hypp::Expected<std::string_view> ParseUriScheme(Parser& parser) {
 ////////////////////////////////////////////////////////////////////////////////
 
 // userinfo = *( unreserved / pct-encoded / sub-delims / ":" )
-inline hypp::Expected<std::string_view> ParseUriUserInfo(Parser& parser) {
-  return parser.match(limits::kURI,
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriUserInfo(Parser& parser) {
+  return parser.match<Limits::kURI>(
       [](const char c) {
         switch (c) {
           case ':':
@@ -45,7 +47,8 @@ inline hypp::Expected<std::string_view> ParseUriUserInfo(Parser& parser) {
 }
 
 // IP-literal = "[" ( IPv6address / IPvFuture  ) "]"
-inline hypp::Expected<std::string_view> ParseIpLiteral(Parser& parser) {
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseIpLiteral(Parser& parser) {
   // "["
   if (!parser.skip('[')) {
     return hypp::Unexpected{Error::Invalid_URI_Host};
@@ -78,7 +81,7 @@ inline hypp::Expected<std::string_view> ParseIpLiteral(Parser& parser) {
   //
   // h16         = 1*4HEXDIG
   //             ; 16 bits of address represented in hexadecimal
-  const auto view = parser.match(limits::kURI,
+  const auto view = parser.match<Limits::kURI>(
       [](const char c) {
         // @TODO: Parse properly
         switch (c) {
@@ -119,8 +122,9 @@ inline hypp::Expected<std::string_view> ParseIpV4Address(Parser& parser) {
 }
 
 // reg-name = *( unreserved / pct-encoded / sub-delims )
-inline hypp::Expected<std::string_view> ParseRegisteredName(Parser& parser) {
-  return parser.match(limits::kURI,
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseRegisteredName(Parser& parser) {
+  return parser.match<Limits::kURI>(
       [](const char c) {
         return is_unreserved(c) || is_sub_delim(c);
       },
@@ -130,7 +134,8 @@ inline hypp::Expected<std::string_view> ParseRegisteredName(Parser& parser) {
 }
 
 // host = IP-literal / IPv4address / reg-name
-inline hypp::Expected<std::string_view> ParseUriHost(Parser& parser) {
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriHost(Parser& parser) {
   std::string_view view;
 
   // > The syntax rule for host is ambiguous because it does not completely
@@ -139,11 +144,11 @@ inline hypp::Expected<std::string_view> ParseUriHost(Parser& parser) {
   // host matches the rule for IPv4address, then it should be considered an
   // IPv4 address literal and not a reg-name.
   // Reference: https://tools.ietf.org/html/rfc3986#section-3.2.2
-  if (auto expected = ParseIpLiteral(parser)) {
+  if (auto expected = ParseIpLiteral<Limits>(parser)) {
     view = expected.value();
   } else if (expected = ParseIpV4Address(parser)) {
     view = expected.value();
-  } else if (expected = ParseRegisteredName(parser)) {
+  } else if (expected = ParseRegisteredName<Limits>(parser)) {
     view = expected.value();
   }
 
@@ -158,17 +163,20 @@ inline hypp::Expected<std::string_view> ParseUriHost(Parser& parser) {
 }
 
 // port = *DIGIT
-inline hypp::Expected<std::string_view> ParseUriPort(Parser& parser) {
-  return parser.match(limits::kPort, is_digit);
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriPort(Parser& parser) {
+  return parser.match<Limits::kPort>(is_digit);
 }
 
 // authority = [ userinfo "@" ] host [ ":" port ]
-inline hypp::Expected<Uri::Authority> ParseUriAuthority(Parser& parser) {
-  Uri::Authority authority;
+template <typename AuthorityT = Uri::Authority,
+          typename Limits = DefaultLimits>
+hypp::Expected<AuthorityT> ParseUriAuthority(Parser& parser) {
+  AuthorityT authority;
 
   // [ userinfo "@" ]
   Parser user_info_parser{parser};
-  if (const auto expected = ParseUriUserInfo(user_info_parser)) {
+  if (const auto expected = ParseUriUserInfo<Limits>(user_info_parser)) {
     if (user_info_parser.skip('@')) {
       authority.user_info = expected.value();
       parser.remove(parser.size() - user_info_parser.size());
@@ -178,7 +186,7 @@ inline hypp::Expected<Uri::Authority> ParseUriAuthority(Parser& parser) {
   }
 
   // host
-  if (const auto expected = ParseUriHost(parser)) {
+  if (const auto expected = ParseUriHost<Limits>(parser)) {
     authority.host = expected.value();
   } else {
     return hypp::Unexpected{expected.error()};
@@ -186,7 +194,7 @@ inline hypp::Expected<Uri::Authority> ParseUriAuthority(Parser& parser) {
 
   // [ ":" port ]
   if (parser.skip(':')) {
-    if (const auto expected = ParseUriPort(parser)) {
+    if (const auto expected = ParseUriPort<Limits>(parser)) {
       authority.port = expected.value();
     } else {
       return hypp::Unexpected{expected.error()};
@@ -215,19 +223,19 @@ enum UriPathRules {
 //      / path-rootless  ; begins with a segment
 //      / path-empty     ; zero characters
 //      / absolute-path  ; begins with "/" (RFC 7230)
-inline hypp::Expected<std::string_view> ParseUriPath(Parser& parser,
-                                                     const int flags) {
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriPath(Parser& parser,
+                                              const int flags) {
   // segment       = *pchar
   // segment-nz    = 1*pchar
   // segment-nz-nc = 1*( unreserved / pct-encoded / sub-delims / "@" )
   //               ; non-zero-length segment without any colon ":"
   const auto parse_segment = [](Parser& parser) {
-    return parser.match(limits::kURI, is_pchar);
+    return parser.match<Limits::kURI>(is_pchar);
   };
   const auto parse_segment_nz_nc = [](Parser& parser) {
     Parser segment_parser{parser};
-    auto view = segment_parser.match(limits::kURI,
-                                     is_pchar);
+    auto view = segment_parser.match<Limits::kURI>(is_pchar);
     if (const auto pos = view.find(':'); pos != view.npos) {
       view = view.substr(0, pos);
     }
@@ -237,7 +245,7 @@ inline hypp::Expected<std::string_view> ParseUriPath(Parser& parser,
     if (!parser.peek('/')) {
       return std::string_view{};
     }
-    return parser.match(limits::kURI,
+    return parser.match<Limits::kURI>(
         [](const char c) {
           return c == '/';
         },
@@ -317,8 +325,9 @@ inline hypp::Expected<std::string_view> ParseUriPath(Parser& parser,
 ////////////////////////////////////////////////////////////////////////////////
 
 // query = *( pchar / "/" / "?" )
-inline hypp::Expected<std::string_view> ParseUriQuery(Parser& parser) {
-  return parser.match(limits::kURI,
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriQuery(Parser& parser) {
+  return parser.match<Limits::kURI>(
       [](const char c) {
         return c == '/' || c == '?';
       },
@@ -328,18 +337,20 @@ inline hypp::Expected<std::string_view> ParseUriQuery(Parser& parser) {
 }
 
 // fragment = *( pchar / "/" / "?" )
-inline hypp::Expected<std::string_view> ParseUriFragment(Parser& parser) {
-  return ParseUriQuery(parser);  // same ABNF rule
+template <typename Limits = DefaultLimits>
+hypp::Expected<std::string_view> ParseUriFragment(Parser& parser) {
+  return ParseUriQuery<Limits>(parser);  // same ABNF rule
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 // absolute-URI = scheme ":" hier-part [ "?" query ]
-inline hypp::Expected<Uri> ParseAbsoluteUri(Parser& parser) {
-  Uri uri;
+template <typename UriT = Uri, typename Limits = DefaultLimits>
+hypp::Expected<UriT> ParseAbsoluteUri(Parser& parser) {
+  UriT uri;
 
   // scheme ":"
-  if (const auto expected = ParseUriScheme(parser)) {
+  if (const auto expected = ParseUriScheme<Limits>(parser)) {
     uri.scheme = expected.value();
   } else {
     return hypp::Unexpected{expected.error()};
@@ -353,7 +364,8 @@ inline hypp::Expected<Uri> ParseAbsoluteUri(Parser& parser) {
   //           / path-rootless
   //           / path-empty
   if (parser.skip("//")) {
-    if (const auto expected = ParseUriAuthority(parser)) {
+    if (const auto expected =
+            ParseUriAuthority<typename UriT::Authority, Limits>(parser)) {
       uri.authority = expected.value();
     } else {
       return hypp::Unexpected{expected.error()};
@@ -361,7 +373,7 @@ inline hypp::Expected<Uri> ParseAbsoluteUri(Parser& parser) {
   }
   const auto kPathRules = uri.authority ? kUriPathAbEmpty :
       kUriPathAbsolute | kUriPathRootless | kUriPathEmpty;
-  if (const auto expected = ParseUriPath(parser, kPathRules)) {
+  if (const auto expected = ParseUriPath<Limits>(parser, kPathRules)) {
     uri.path = expected.value();
   } else {
     return hypp::Unexpected{expected.error()};
@@ -369,7 +381,7 @@ inline hypp::Expected<Uri> ParseAbsoluteUri(Parser& parser) {
 
   // [ "?" query ]
   if (parser.skip('?')) {
-    if (const auto expected = ParseUriQuery(parser)) {
+    if (const auto expected = ParseUriQuery<Limits>(parser)) {
       uri.query = expected.value();
     } else {
       return hypp::Unexpected{expected.error()};
@@ -380,15 +392,17 @@ inline hypp::Expected<Uri> ParseAbsoluteUri(Parser& parser) {
 }
 
 // partial-URI = relative-part [ "?" query ]
-inline hypp::Expected<Uri> ParsePartialUri(Parser& parser) {
-  Uri uri;
+template <typename UriT = Uri, typename Limits = DefaultLimits>
+hypp::Expected<UriT> ParsePartialUri(Parser& parser) {
+  UriT uri;
 
   // relative-part = "//" authority path-abempty
   //               / path-absolute
   //               / path-noscheme
   //               / path-empty
   if (parser.skip("//")) {
-    if (const auto expected = ParseUriAuthority(parser)) {
+    if (const auto expected =
+            ParseUriAuthority<typename UriT::Authority, Limits>(parser)) {
       uri.authority = expected.value();
     } else {
       return hypp::Unexpected{expected.error()};
@@ -396,7 +410,7 @@ inline hypp::Expected<Uri> ParsePartialUri(Parser& parser) {
   }
   const auto kPathRules = uri.authority ? kUriPathAbEmpty :
       kUriPathAbsolute | kUriPathNoScheme | kUriPathEmpty;
-  if (const auto expected = ParseUriPath(parser, kPathRules)) {
+  if (const auto expected = ParseUriPath<Limits>(parser, kPathRules)) {
     uri.path = expected.value();
   } else {
     return hypp::Unexpected{expected.error()};
@@ -404,7 +418,7 @@ inline hypp::Expected<Uri> ParsePartialUri(Parser& parser) {
 
   // [ "?" query ]
   if (parser.skip('?')) {
-    if (const auto expected = ParseUriQuery(parser)) {
+    if (const auto expected = ParseUriQuery<Limits>(parser)) {
       uri.query = expected.value();
     } else {
       return hypp::Unexpected{expected.error()};
@@ -415,11 +429,12 @@ inline hypp::Expected<Uri> ParsePartialUri(Parser& parser) {
 }
 
 // relative-ref = relative-part [ "?" query ] [ "#" fragment ]
-inline hypp::Expected<Uri> ParseRelativeReference(Parser& parser) {
-  Uri uri;
+template <typename UriT = Uri, typename Limits = DefaultLimits>
+hypp::Expected<UriT> ParseRelativeReference(Parser& parser) {
+  UriT uri;
 
   // Same components as partial-URI
-  if (const auto expected = ParsePartialUri(parser)) {
+  if (const auto expected = ParsePartialUri<UriT, Limits>(parser)) {
     uri = expected.value();
   } else {
     return hypp::Unexpected{expected.error()};
@@ -427,7 +442,7 @@ inline hypp::Expected<Uri> ParseRelativeReference(Parser& parser) {
 
   // [ "#" fragment ]
   if (parser.skip('#')) {
-    if (const auto expected = ParseUriFragment(parser)) {
+    if (const auto expected = ParseUriFragment<Limits>(parser)) {
       uri.fragment = expected.value();
     } else {
       return hypp::Unexpected{expected.error()};
@@ -440,11 +455,12 @@ inline hypp::Expected<Uri> ParseRelativeReference(Parser& parser) {
 }  // namespace detail
 
 // URI = scheme ":" hier-part [ "?" query ] [ "#" fragment ]
-inline Expected<Uri> ParseUri(Parser& parser) {
-  Uri uri;
+template <typename UriT = Uri, typename Limits = DefaultLimits>
+Expected<UriT> ParseUri(Parser& parser) {
+  UriT uri;
 
   // Same components as absolute-URI
-  if (const auto expected = detail::ParseAbsoluteUri(parser)) {
+  if (const auto expected = detail::ParseAbsoluteUri<UriT, Limits>(parser)) {
     uri = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -452,7 +468,7 @@ inline Expected<Uri> ParseUri(Parser& parser) {
 
   // [ "#" fragment ]
   if (parser.skip('#')) {
-    if (const auto expected = detail::ParseUriFragment(parser)) {
+    if (const auto expected = detail::ParseUriFragment<Limits>(parser)) {
       uri.fragment = expected.value();
     } else {
       return Unexpected{expected.error()};
@@ -463,16 +479,20 @@ inline Expected<Uri> ParseUri(Parser& parser) {
 }
 
 // URI-reference = URI / relative-ref
-inline Expected<Uri> ParseUriReference(Parser& parser) {
-  Uri uri;
+template <typename UriT = Uri, typename Limits = DefaultLimits>
+Expected<UriT> ParseUriReference(Parser& parser) {
+  UriT uri;
 
   // > If the URI-reference's prefix does not match the syntax of a scheme
   // followed by its colon separator, then the URI-reference is a relative
   // reference.
   // Reference: https://tools.ietf.org/html/rfc3986#section-4.1
-  if (auto expected = ParseUri(parser)) {
+  Parser uri_parser{parser};
+  if (auto expected = ParseUri<UriT, Limits>(uri_parser)) {
     uri = expected.value();
-  } else if (expected = detail::ParseRelativeReference(parser)) {
+    parser = uri_parser;
+  } else if ((expected =
+                  detail::ParseRelativeReference<UriT, Limits>(parser))) {
     uri = expected.value();
   } else {
     return Unexpected{expected.error()};
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hypp/detail/mmap.hpp>
+#include <hypp/parser/bulk.hpp>
+#include <hypp/compact.hpp>
+#include <hypp/request.hpp>
+#include <hypp/response.hpp>
+
+namespace hypp::snapshot {
+
+// A snapshot is laid out as:
+//
+//   Header
+//   messages, each a compact message padded to kAlignment bytes
+//   std::uint64_t index[count]  (offsets of the messages)
+//   Footer
+//
+// The footer is written last, so that snapshots can be written to streams
+// that cannot seek. Integers are in the byte order of the writer, which the
+// reader checks.
+constexpr char kMagic[8] = {'H', 'Y', 'P', 'P', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr size_t kAlignment = 8;
+
+struct Header {
+  char magic[8] = {};
+  std::uint32_t version = 0;
+  std::uint32_t byte_order = 0;
+};
+
+struct Footer {
+  std::uint64_t count = 0;
+  std::uint64_t index_offset = 0;
+  char magic[8] = {};
+};
+
+static_assert(sizeof(Header) == 16);
+static_assert(sizeof(Footer) == 24);
+
+}  // namespace hypp::snapshot
+
+namespace hypp {
+
+// A read-only view of a snapshot in memory. Opening it only checks the header,
+// the footer and the bounds of the index, so it takes constant time. Messages
+// can be checked with CompactMessageView::valid() before they are read, if
+// the snapshot is not trusted.
+class SnapshotView {
+public:
+  SnapshotView() = default;
+  explicit SnapshotView(const std::string_view data) {
+    if (data.size() < sizeof(snapshot::Header) + sizeof(snapshot::Footer)) {
+      return;
+    }
+    const auto header = detail::LoadUnaligned<snapshot::Header>(data.data());
+    const auto footer = detail::LoadUnaligned<snapshot::Footer>(
+        data.data() + data.size() - sizeof(snapshot::Footer));
+    if (std::memcmp(header.magic, snapshot::kMagic, 8) != 0 ||
+        std::memcmp(footer.magic, snapshot::kMagic, 8) != 0 ||
+        header.version != snapshot::kVersion ||
+        header.byte_order != snapshot::kByteOrder) {
+      return;
+    }
+    const std::uint64_t index_end = data.size() - sizeof(snapshot::Footer);
+    if (footer.index_offset < sizeof(snapshot::Header) ||
+        footer.index_offset > index_end ||
+        footer.count != (index_end - footer.index_offset) /
+                            sizeof(std::uint64_t) ||
+        (index_end - footer.index_offset) % sizeof(std::uint64_t)) {
+      return;
+    }
+    data_ = data;
+    count_ = static_cast<size_t>(footer.count);
+    index_offset_ = static_cast<size_t>(footer.index_offset);
+  }
+
+  bool valid() const {
+    return !data_.empty();
+  }
+
+  size_t size() const {
+    return count_;
+  }
+  bool empty() const {
+    return !count_;
+  }
+
+  // Returns an empty view if `index` is not less than size(), or if the
+  // message is out of the bounds of the snapshot.
+  CompactMessageView operator[](const size_t index) const {
+    if (index >= count_) {
+      return {};
+    }
+    const auto offset = detail::LoadUnaligned<std::uint64_t>(
+        data_.data() + index_offset_ + index * sizeof(std::uint64_t));
+    if (offset < sizeof(snapshot::Header) || offset > index_offset_ ||
+        index_offset_ - offset < sizeof(std::uint32_t)) {
+      return {};
+    }
+    // The size of a compact message is its first member
+    const auto size = detail::LoadUnaligned<std::uint32_t>(
+        data_.data() + offset);
+    if (size > index_offset_ - offset) {
+      return {};
+    }
+    return CompactMessageView{data_.substr(static_cast<size_t>(offset), size)};
+  }
+
+private:
+  std::string_view data_;
+  size_t count_ = 0;
+  size_t index_offset_ = 0;
+};
+
+// A memory-mapped snapshot file. Messages are read in place, without parsing
+// or copying.
+class Snapshot {
+public:
+  Snapshot() = default;
+  explicit Snapshot(const std::string& path) {
+    open(path);
+  }
+
+  bool open(const std::string& path) {
+    view_ = {};
+    if (file_.open(path)) {
+      view_ = SnapshotView{file_.view()};
+    }
+    if (!view_.valid()) {
+      file_.close();
+    }
+    return view_.valid();
+  }
+
+  bool is_open() const {
+    return view_.valid();
+  }
+
+  const SnapshotView& view() const {
+    return view_;
+  }
+  size_t size() const {
+    return view_.size();
+  }
+  CompactMessageView operator[](const size_t index) const {
+    return view_[index];
+  }
+
+private:
+  detail::MappedFile file_;
+  SnapshotView view_;  // the mapping does not move with the object
+};
+
+// Writes messages to a snapshot. The snapshot is complete once close() is
+// called.
+class SnapshotWriter {
+public:
+  explicit SnapshotWriter(std::ostream& output) : output_{&output} {
+    write_header();
+  }
+  explicit SnapshotWriter(const std::string& path)
+      : file_{path, std::ios::binary | std::ios::trunc}, output_{&file_} {
+    write_header();
+  }
+  ~SnapshotWriter() {
+    close();
+  }
+
+  SnapshotWriter(const SnapshotWriter&) = delete;
+  SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+  bool good() const {
+    return output_ && output_->good();
+  }
+
+  bool write(const CompactMessageView message) {
+    if (!output_) {
+      return false;
+    }
+    index_.push_back(offset_);
+    output_->write(message.data().data(), message.size());
+    offset_ += message.size();
+    pad();
+    return good();
+  }
+
+  bool write(const CompactMessage& message) {
+    return write(message.view());
+  }
+
+  template <typename MessageT>
+  bool write(const MessageT& message) {
+    const auto compact = Compact(message);
+    return compact && write(compact.value().view());
+  }
+
+  size_t size() const {
+    return index_.size();
+  }
+
+  // Writes the index and the footer. Returns false if anything could not be
+  // written.
+  bool close() {
+    if (!output_) {
+      return false;
+    }
+    snapshot::Footer footer;
+    footer.count = index_.size();
+    footer.index_offset = offset_;
+    std::memcpy(footer.magic, snapshot::kMagic, sizeof(footer.magic));
+    output_->write(reinterpret_cast<const char*>(index_.data()),
+                   index_.size() * sizeof(std::uint64_t));
+    output_->write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    output_->flush();
+    const bool result = output_->good();
+    if (file_.is_open()) {
+      file_.close();
+    }
+    output_ = nullptr;
+    return result;
+  }
+
+private:
+  void write_header() {
+    snapshot::Header header;
+    std::memcpy(header.magic, snapshot::kMagic, sizeof(header.magic));
+    header.version = snapshot::kVersion;
+    header.byte_order = snapshot::kByteOrder;
+    output_->write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset_ = sizeof(header);
+  }
+
+  void pad() {
+    constexpr char kPadding[snapshot::kAlignment] = {};
+    const auto padding = (snapshot::kAlignment -
+                          offset_ % snapshot::kAlignment) %
+                         snapshot::kAlignment;
+    output_->write(kPadding, padding);
+    offset_ += padding;
+  }
+
+  std::ofstream file_;
+  std::ostream* output_ = nullptr;
+  std::uint64_t offset_ = 0;
+  std::vector<std::uint64_t> index_;
+};
+
+// Parses a stream of concatenated messages like ParseBulk, and writes the
+// valid ones to `writer` in input order. Invalid messages are counted in the
+// returned statistics, and skipped.
+//
+// Partitions are parsed a few at a time and written as soon as they are
+// stitched, so only the messages of the partitions in flight are held in
+// memory, however large the input is.
+template <typename MessageT, typename Limits = DefaultLimits>
+BulkStatistics WriteSnapshot(const std::string_view data,
+                             SnapshotWriter& writer,
+                             const size_t threads = 0) {
+  constexpr size_t kMaxPartitionSize = 1 << 22;
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  BulkStatistics statistics;
+  const size_t partition_count =
+      std::max(detail::BulkPartitionCount(data.size(), threads),
+               data.size() / kMaxPartitionSize);
+  detail::ParseBulkPartitions<MessageT, Limits>(
+      data, threads, partition_count, detail::ThreadCount(threads),
+      [&](const Expected<MessageT>& expected, size_t) {
+        ++statistics.messages;
+        if (!expected || !writer.write(expected.value())) {
+          ++statistics.errors;
+        }
+      });
+
+  const auto end = std::chrono::steady_clock::now();
+  statistics.bytes = data.size();
+  statistics.seconds = std::chrono::duration<double>(end - begin).count();
+  return statistics;
+}
+
+}  // namespace hypp
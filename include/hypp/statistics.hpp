@@ -0,0 +1,311 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <hypp/error.hpp>
+#include <hypp/observer.hpp>
+#include <hypp/uri.hpp>
+
+namespace hypp::statistics {
+
+enum Histogram {
+  kStartLineSize,
+  kRequestTargetSize,
+  kHeaderCount,
+  kHeaderNameSize,
+  kHeaderValueSize,
+  kHeaderSectionSize,
+  kBodySize,
+  kUriSchemeSize,
+  kUriHostSize,
+  kUriPathSize,
+  kUriQuerySize,
+  kUriFragmentSize,
+  kHistogramCount
+};
+
+// Bucket 0 counts zeros, and bucket `n` counts values in [2^(n-1), 2^n).
+constexpr size_t kBucketCount = 65;
+
+constexpr size_t bucket(const std::uint64_t value) {
+  size_t n = 0;
+  for (auto v = value; v; v >>= 1) {
+    ++n;
+  }
+  return n;
+}
+
+struct Snapshot {
+  std::uint64_t messages = 0;
+  std::array<std::uint64_t, kErrorCount> errors{};
+  std::array<std::array<std::uint64_t, kBucketCount>, kHistogramCount>
+      histograms{};
+
+  std::uint64_t error_count() const {
+    std::uint64_t count = 0;
+    for (const auto n : errors) {
+      count += n;
+    }
+    return count;
+  }
+
+  std::uint64_t count(const Histogram histogram) const {
+    std::uint64_t count = 0;
+    for (const auto n : histograms[histogram]) {
+      count += n;
+    }
+    return count;
+  }
+
+  Snapshot& operator+=(const Snapshot& other) {
+    messages += other.messages;
+    for (size_t i = 0; i < kErrorCount; ++i) {
+      errors[i] += other.errors[i];
+    }
+    for (size_t i = 0; i < kHistogramCount; ++i) {
+      for (size_t j = 0; j < kBucketCount; ++j) {
+        histograms[i][j] += other.histograms[i][j];
+      }
+    }
+    return *this;
+  }
+};
+
+// Counters that are written by a single thread, and can be read by any thread
+// at any time. Writes are plain relaxed stores, so recording an event costs
+// about as much as incrementing an ordinary integer.
+class Collector {
+public:
+  Collector() = default;
+  Collector(const Collector&) = delete;
+  Collector& operator=(const Collector&) = delete;
+
+  void record_message() {
+    increment(messages_);
+  }
+  void record_error(const Error error) {
+    const auto i = static_cast<size_t>(error);
+    if (i < kErrorCount) {
+      increment(errors_[i]);
+    }
+  }
+  void record(const Histogram histogram, const std::uint64_t value) {
+    increment(histograms_[histogram][bucket(value)]);
+  }
+
+  // Counts may be slightly behind the writer, but are never torn.
+  Snapshot snapshot() const {
+    Snapshot snapshot;
+    add_to(snapshot);
+    return snapshot;
+  }
+
+  void add_to(Snapshot& snapshot) const {
+    snapshot.messages += messages_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kErrorCount; ++i) {
+      snapshot.errors[i] += errors_[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kHistogramCount; ++i) {
+      for (size_t j = 0; j < kBucketCount; ++j) {
+        snapshot.histograms[i][j] +=
+            histograms_[i][j].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+private:
+  using counter_t = std::atomic<std::uint64_t>;
+
+  static void increment(counter_t& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  friend class Registry;
+
+  counter_t messages_{0};
+  std::array<counter_t, kErrorCount> errors_{};
+  std::array<std::array<counter_t, kBucketCount>, kHistogramCount>
+      histograms_{};
+  Collector* next_ = nullptr;
+};
+
+// The collectors of all threads that have recorded anything. Collectors are
+// pushed onto a lock-free list and are never removed, so that the counts of
+// finished threads remain in the totals. When a thread exits, its collector is
+// handed to the next thread that needs one, along with its counts, so the
+// number of collectors is bounded by the number of threads that run at the
+// same time.
+class Registry {
+public:
+  static Registry& instance() {
+    static Registry registry;
+    return registry;
+  }
+
+  // Returns the collector of the calling thread.
+  Collector& local() {
+    thread_local const Lease lease{*this};
+    return *lease.collector;
+  }
+
+  // Returns the number of collectors, including the ones that are not in use.
+  size_t collector_count() const {
+    size_t count = 0;
+    for (auto collector = head_.load(std::memory_order_acquire); collector;
+         collector = collector->next_) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Merges the collectors of all threads.
+  Snapshot snapshot() const {
+    Snapshot snapshot;
+    for (auto collector = head_.load(std::memory_order_acquire); collector;
+         collector = collector->next_) {
+      collector->add_to(snapshot);
+    }
+    return snapshot;
+  }
+
+private:
+  // Holds a collector for the lifetime of a thread.
+  struct Lease {
+    explicit Lease(Registry& registry)
+        : registry{registry}, collector{registry.acquire()} {}
+    ~Lease() {
+      registry.release(collector);
+    }
+
+    Registry& registry;
+    Collector* const collector;
+  };
+
+  Registry() = default;
+
+  // The mutex also orders the writes of the previous thread before those of
+  // the next one, as each collector has a single writer at a time.
+  Collector* acquire() {
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      if (!free_.empty()) {
+        const auto collector = free_.back();
+        free_.pop_back();
+        return collector;
+      }
+    }
+    return add(new Collector);
+  }
+
+  void release(Collector* const collector) {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    free_.push_back(collector);
+  }
+
+  Collector* add(Collector* const collector) {
+    collector->next_ = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(collector->next_, collector,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+    return collector;
+  }
+
+  std::atomic<Collector*> head_{nullptr};
+  std::mutex mutex_;
+  std::vector<Collector*> free_;  // collectors of threads that have exited
+};
+
+inline Collector& local() {
+  return Registry::instance().local();
+}
+
+inline Snapshot snapshot() {
+  return Registry::instance().snapshot();
+}
+
+// Records the size of each defined URI component. Works with Uri and UriView.
+template <typename UriT>
+void RecordUri(Collector& collector, const UriT& uri) {
+  if (uri.scheme.has_value()) {
+    collector.record(kUriSchemeSize, uri.scheme->size());
+  }
+  if (uri.authority.has_value()) {
+    collector.record(kUriHostSize, uri.authority->host.size());
+  }
+  collector.record(kUriPathSize, uri.path.size());
+  if (uri.query.has_value()) {
+    collector.record(kUriQuerySize, uri.query->size());
+  }
+  if (uri.fragment.has_value()) {
+    collector.record(kUriFragmentSize, uri.fragment->size());
+  }
+}
+
+// Records message sizes, header counts, URI component sizes and errors.
+//
+// Usage: `ParseRequest(view, statistics::Observer{})`
+class Observer {
+public:
+  Observer() : collector_{local()} {}
+  explicit Observer(Collector& collector) : collector_{collector} {}
+
+  void begin(const ParsePhase phase, std::uint64_t) {
+    switch (phase) {
+      case ParsePhase::StartLine:
+        collector_.record_message();
+        break;
+      case ParsePhase::HeaderFields:
+        header_count_ = 0;
+        break;
+      default:
+        break;
+    }
+  }
+
+  void end(const ParsePhase phase, const size_t bytes, std::uint64_t) {
+    switch (phase) {
+      case ParsePhase::StartLine:
+        collector_.record(kStartLineSize, bytes);
+        break;
+      case ParsePhase::RequestTarget:
+        collector_.record(kRequestTargetSize, bytes);
+        break;
+      case ParsePhase::HeaderName:
+        ++header_count_;
+        collector_.record(kHeaderNameSize, bytes);
+        break;
+      case ParsePhase::HeaderValue:
+        collector_.record(kHeaderValueSize, bytes);
+        break;
+      case ParsePhase::HeaderFields:
+        collector_.record(kHeaderCount, header_count_);
+        collector_.record(kHeaderSectionSize, bytes);
+        break;
+      case ParsePhase::Body:
+        collector_.record(kBodySize, bytes);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void error(const Error error) {
+    collector_.record_error(error);
+  }
+
+  void uri(const Uri& uri) {
+    RecordUri(collector_, uri);
+  }
+
+private:
+  Collector& collector_;
+  size_t header_count_ = 0;
+};
+
+}  // namespace hypp::statistics
@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace hypp {
 
@@ -19,4 +20,19 @@ struct Uri {
   std::optional<std::string> fragment;
 };
 
+// Same as Uri, but the components are views into the parsed input.
+struct UriView {
+  struct Authority {
+    std::optional<std::string_view> user_info;
+    std::string_view host;
+    std::optional<std::string_view> port;
+  };
+
+  std::optional<std::string_view> scheme;
+  std::optional<Authority> authority;
+  std::string_view path;
+  std::optional<std::string_view> query;
+  std::optional<std::string_view> fragment;
+};
+
 }  // namespace hypp
@@ -1,6 +1,17 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <hypp.hpp>
 
@@ -86,11 +97,1719 @@ void test_response() {
   assert(hypp::to_string(r) == example);
 }
 
+void test_request_template() {
+  hypp::Request request;
+  request.start_line.method = hypp::method::kPost;
+  request.start_line.target.uri.path = "/users/{id}/items";
+  request.start_line.target.uri.query = "q={query}";
+  request.start_line.version = {'1', '1'};
+  request.header_fields = {
+      {"Host", "www.example.com"},
+      {"Authorization", "Bearer {token}"},
+      {"Content-Type", "application/json"},
+      {"Content-Length", "0"},
+    };
+
+  const hypp::RequestTemplate request_template{request};
+  assert(request_template.slot_count() == 3);
+  assert(request_template.find_slot("token") == 2);
+
+  const auto output = request_template.fill(
+      {"a/b", "x y", "t0k3n"}, "{\"k\":1}");
+  assert(output.value() ==
+      "POST /users/a%2Fb/items?q=x%20y HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "Authorization: Bearer t0k3n\r\n"
+      "Content-Type: application/json\r\n"
+      "Content-Length: 7\r\n"
+      "\r\n"
+      "{\"k\":1}");
+
+  // Values cannot inject header fields or requests
+  const auto injected = request_template.fill(
+      {"1\r\nX: y", "\r\n\r\nGET / HTTP/1.1", "t0k3n"});
+  assert(injected.value().find("\r\nX: y") == std::string::npos);
+  std::string buffer;
+  assert(request_template.fill(buffer, {"1", "q", "t\r\nX-Admin: 1"}) ==
+         hypp::Error::Invalid_Header_Format);
+  assert(buffer.empty());
+  assert(!request_template.fill({"1", "q", std::string_view{"t\0", 2}}));
+  assert(request_template.fill({"1", "q", "t\t\x80"}));
+
+  // Only the request-target has slots
+  request.start_line.method = "{M}";
+  request.start_line.target.uri.path = "/{p}";
+  request.start_line.target.uri.query.reset();
+  request.header_fields = {{"Transfer-Encoding", "chunked"}};
+  const hypp::RequestTemplate chunked{request};
+  assert(chunked.slot_count() == 1);
+  assert(chunked.fill({"a b"}, "0\r\n\r\n").value() ==
+      "{M} /a%20b HTTP/1.1\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "0\r\n\r\n");
+}
+
+void test_uri_encoding() {
+  using namespace hypp::detail;
+
+  const std::string_view raw = "a b/c~d\xE2\x82\xAC-0123456789abcdef.";
+  const std::string encoded = uri::encode(raw);
+  assert(encoded == "a%20b%2Fc~d%E2%82%AC-0123456789abcdef.");
+  assert(uri::encoded_size(raw) == encoded.size());
+  assert(uri::decode(encoded) == raw);
+
+  assert(uri::decode("%7e%7E%zz%4") == "~~%zz%4");
+  assert(uri::decoded_size("%7e%7E%zz%4") == 7);
+
+  std::string buffer{"q=%E2%82%ac%20x"};
+  uri::decode_in_place(buffer);
+  assert(buffer == "q=\xE2\x82\xAC x");
+
+  const uri::DecodeView view{"caf%C3%a9%"};
+  assert(view == "caf\xC3\xA9%");
+  assert(view != "caf");
+  assert(view.size() == 6);
+  assert(std::string(view.begin(), view.end()) == view.to_string());
+}
+
+void test_query_parameters() {
+  const hypp::QueryParameters parameters{"a=1&&b&c=x%20y&%61=2&d="};
+
+  std::vector<std::pair<std::string_view, std::string_view>> pairs;
+  for (const auto& parameter : parameters) {
+    pairs.emplace_back(parameter.name, parameter.value);
+  }
+  assert((pairs == decltype(pairs){
+      {"a", "1"}, {"b", ""}, {"c", "x%20y"}, {"%61", "2"}, {"d", ""}}));
+
+  assert(parameters.get("c")->decoded_value() == "x y");
+  assert(!parameters.get("e"));
+
+  const hypp::QueryIndex index{parameters};
+  assert(index.size() == 5);
+  assert(index.get("a")->value == "1");  // first occurrence
+  assert(index.get("b")->value.empty());
+  assert(!index.get("x"));
+
+  const hypp::QueryParameters form{"q=a+b%2B", hypp::QueryFormat::Form};
+  assert(form.get("q")->decoded_value() == "a b+");
+}
+
+hypp::Uri parse_uri_reference(const std::string_view view) {
+  hypp::Parser parser{view};
+  const auto expected = hypp::ParseUriReference(parser);
+  assert(expected && parser.empty());
+  return expected.value();
+}
+
+void test_uri_resolution() {
+  // RFC 3986 Section 5.4
+  const auto base = parse_uri_reference("http://a/b/c/d;p?q");
+  const auto resolve = [&base](const std::string_view reference) {
+    return hypp::Resolve(base, parse_uri_reference(reference));
+  };
+
+  assert(resolve("g:h") == "g:h");
+  assert(resolve("g") == "http://a/b/c/g");
+  assert(resolve("./g") == "http://a/b/c/g");
+  assert(resolve("g/") == "http://a/b/c/g/");
+  assert(resolve("/g") == "http://a/g");
+  assert(resolve("//g") == "http://g");
+  assert(resolve("?y") == "http://a/b/c/d;p?y");
+  assert(resolve("g?y") == "http://a/b/c/g?y");
+  assert(resolve("#s") == "http://a/b/c/d;p?q#s");
+  assert(resolve("g?y#s") == "http://a/b/c/g?y#s");
+  assert(resolve(";x") == "http://a/b/c/;x");
+  assert(resolve("") == "http://a/b/c/d;p?q");
+  assert(resolve(".") == "http://a/b/c/");
+  assert(resolve("./") == "http://a/b/c/");
+  assert(resolve("..") == "http://a/b/");
+  assert(resolve("../g") == "http://a/b/g");
+  assert(resolve("../..") == "http://a/");
+  assert(resolve("../../g") == "http://a/g");
+  assert(resolve("../../../g") == "http://a/g");
+  assert(resolve("/./g") == "http://a/g");
+  assert(resolve("/../g") == "http://a/g");
+  assert(resolve("g.") == "http://a/b/c/g.");
+  assert(resolve("..g") == "http://a/b/c/..g");
+  assert(resolve("./g/.") == "http://a/b/c/g/");
+  assert(resolve("g/../h") == "http://a/b/c/h");
+  assert(resolve("g;x=1/../y") == "http://a/b/c/y");
+  assert(resolve("g#s/../x") == "http://a/b/c/g#s/../x");
+
+  const auto normalize = [](const std::string_view uri) {
+    return hypp::Normalize(parse_uri_reference(uri));
+  };
+  assert(normalize("HTTP://www.Example.COM:80") == "http://www.example.com/");
+  assert(normalize("https://a:8443/%7euser/./x/../%2f%41?%7e#f") ==
+         "https://a:8443/~user/%2FA?~#f");
+  assert(normalize("http://[::1]:/a") == "http://[::1]/a");
+  assert(normalize("/../a/./b") == "/a/b");
+  assert(normalize("../a/./%62") == "../a/./b");
+
+  const auto relative = parse_uri_reference("../a/./b");
+  assert(hypp::HashNormalized(relative) ==
+         hypp::detail::Hash(hypp::Normalize(relative)));
+}
+
+void test_uri_hashing() {
+  const auto a = parse_uri_reference("HTTP://Example.com:80/a/%2e/b/../c?x=%7e");
+  const auto b = parse_uri_reference("http://example.com/a/c?x=~");
+  const auto c = parse_uri_reference("http://example.com/a/c?x=%7E#f");
+
+  assert(hypp::HashNormalized(a) == hypp::HashNormalized(b));
+  assert(hypp::HashNormalized(a) != hypp::HashNormalized(c));
+  assert(hypp::HashNormalized128(a) == hypp::HashNormalized128(b));
+
+  for (const auto& uri : {a, c}) {
+    const auto normalized = hypp::Normalize(uri);
+    assert(hypp::HashNormalized(uri) == hypp::detail::Hash(normalized));
+  }
+}
+
+void test_uri_batch() {
+  const std::vector<std::string_view> targets{
+      "/where?q=now",
+      "http://user@www.example.org:8080/pub/WWW/TheProject.html",
+      "192.0.2.1:443",
+      "*",
+      "/bad path",
+    };
+
+  std::string data;
+  std::vector<std::uint32_t> offsets{0};
+  for (const auto target : targets) {
+    data += target;
+    offsets.push_back(static_cast<std::uint32_t>(data.size()));
+  }
+
+  const auto columns = hypp::ParseUriBatch(
+      data, offsets, hypp::UriBatchRule::RequestTarget, 2);
+  assert(columns.size() == targets.size());
+
+  using Uri = hypp::UriColumns;
+  assert(columns.get(data, 0, Uri::kPath) == "/where");
+  assert(columns.get(data, 0, Uri::kQuery) == "q=now");
+  assert(!columns.get(data, 0, Uri::kHost));
+  assert(columns.get(data, 1, Uri::kScheme) == "http");
+  assert(columns.get(data, 1, Uri::kUserInfo) == "user");
+  assert(columns.get(data, 1, Uri::kHost) == "www.example.org");
+  assert(columns.get(data, 1, Uri::kPort) == "8080");
+  assert(columns.get(data, 2, Uri::kHost) == "192.0.2.1");
+  assert(columns.get(data, 3, Uri::kPath) == "*");
+  for (size_t i = 0; i < 4; ++i) {
+    assert(!columns.error(i));
+  }
+  assert(columns.error(4) == hypp::Error::Invalid_URI);
+
+  // Large batches are split between threads that are reused across calls
+  std::string paths;
+  std::vector<std::uint32_t> path_offsets{0};
+  for (size_t i = 0; i < 20000; ++i) {
+    paths += "/p?" + std::to_string(i);
+    path_offsets.push_back(static_cast<std::uint32_t>(paths.size()));
+  }
+  auto& pool = hypp::detail::ThreadPool::instance();
+  for (int i = 0; i < 3; ++i) {
+    const auto batch = hypp::ParseUriBatch(
+        paths, path_offsets, hypp::UriBatchRule::RequestTarget, 4);
+    assert(batch.size() == 20000);
+    assert(batch.get(paths, 12345, Uri::kQuery) == "12345");
+    assert(!batch.error(19999));
+    assert(pool.size() == 3);
+  }
+}
+
+void test_bulk_parsing() {
+  // Bodies that contain start lines must not be mistaken for messages
+  const std::string body =
+      "HTTP/1.1 404 Not Found\r\n"
+      "HTTP/1.1 404 Not Found\r\n"
+      "HTTP/1.1 404 Not Found\r\n";
+  const std::string response =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 72\r\n"
+      "\r\n" + body;
+  const std::string chunked =
+      "HTTP/1.1 200 OK\r\n"
+      "Transfer-Encoding: gzip, Chunked\r\n"
+      "\r\n"
+      "5\r\nHello\r\n0\r\nExpires: never\r\n\r\n";
+  const std::string no_content =
+      "HTTP/1.1 204 No Content\r\n"
+      "\r\n";
+  const std::string invalid =
+      "HTTP/1.1 200 OK\r\n"
+      "Invalid Header\r\n"
+      "\r\n";
+
+  std::string data;
+  std::vector<size_t> offsets;
+  for (size_t i = 0; i < 20000; ++i) {
+    offsets.push_back(data.size());
+    switch (i % 4) {
+      case 0: data += response; break;
+      case 1: data += chunked; break;
+      case 2: data += no_content; break;
+      case 3: data += invalid; break;
+    }
+  }
+
+  const auto result = hypp::ParseBulk<hypp::Response>(data, 4);
+  assert(result.messages.size() == offsets.size());
+  assert(result.offsets == offsets);
+  assert(result.statistics.messages == offsets.size());
+  assert(result.statistics.errors == offsets.size() / 4);
+  assert(result.statistics.bytes == data.size());
+
+  for (size_t i = 0; i < result.messages.size(); ++i) {
+    const auto& expected = result.messages[i];
+    assert(static_cast<bool>(expected) == (i % 4 != 3));
+    if (i % 4 == 0) {
+      assert(expected.value().body == body);
+    }
+  }
+
+  // Invalid chunk sizes are not framed, and do not wrap around
+  for (const auto* chunk : {"FFFFFFFFFFFFFFEC\r\nabc",
+                            "10000000000000000\r\nabc",
+                            "zz\r\n\r\n"}) {
+    const std::string smuggled =
+        "POST / HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n" + std::string{chunk} +
+        "GET /smuggled HTTP/1.1\r\n"
+        "\r\n";
+    const auto requests = hypp::ParseBulk<hypp::Request>(smuggled, 1);
+    assert(requests.messages.size() == 1);
+  }
+  assert(!hypp::ParseChunkSize("zz"));
+  assert(!hypp::ParseChunkSize("1x\r\n"));
+  assert(!hypp::ParseChunkSize("10000000000000000"));
+  assert(hypp::ParseChunkSize("FFFFFFFFFFFFFFFF").value() == ~0ull);
+  assert(hypp::ParseChunkSize("1a;name=value\r\n").value() == 0x1a);
+}
+
+struct PhaseRecorder {
+  static constexpr bool kTimestamps = true;
+
+  void begin(hypp::ParsePhase, std::uint64_t timestamp) {
+    assert(timestamp);
+    ++depth;
+  }
+  void end(hypp::ParsePhase phase, size_t bytes, std::uint64_t) {
+    --depth;
+    events.emplace_back(phase, bytes);
+  }
+
+  int depth = 0;
+  std::vector<std::pair<hypp::ParsePhase, size_t>> events;
+};
+
+void test_parse_observer() {
+  using Phase = hypp::ParsePhase;
+
+  PhaseRecorder recorder;
+  const auto expected = hypp::ParseRequest(
+      "GET /hello.txt HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "\r\n"
+      "body",
+      recorder);
+  assert(expected);
+  assert(recorder.depth == 0);
+  assert((recorder.events == decltype(recorder.events){
+      {Phase::Method, 3},
+      {Phase::RequestTarget, 10},
+      {Phase::Version, 8},
+      {Phase::StartLine, 25},
+      {Phase::HeaderName, 4},
+      {Phase::HeaderValue, 15},
+      {Phase::HeaderFields, 23},
+      {Phase::Body, 4},
+    }));
+}
+
+void test_parse_statistics() {
+  namespace statistics = hypp::statistics;
+
+  const auto before = statistics::snapshot();
+
+  std::thread thread{[] {
+    statistics::Observer observer;
+    for (int i = 0; i < 10; ++i) {
+      assert(hypp::ParseRequest(
+          "GET /index.html HTTP/1.1\r\n"
+          "Host: www.example.com\r\n"
+          "Accept: */*\r\n"
+          "\r\n", observer));
+    }
+    assert(!hypp::ParseRequest("GET / HTTP/1.1\r\n", observer));
+  }};
+  thread.join();
+
+  statistics::Observer observer;
+  assert(!hypp::ParseResponse("HTTP/1.1 20 OK\r\n\r\n", observer));
+
+  auto snapshot = statistics::snapshot();
+  assert(snapshot.messages - before.messages == 12);
+  assert(snapshot.error_count() - before.error_count() == 2);
+
+  // Each successful request has two header fields
+  const auto& counts = snapshot.histograms[statistics::kHeaderCount];
+  assert(counts[statistics::bucket(2)] -
+         before.histograms[statistics::kHeaderCount][statistics::bucket(2)] ==
+         10);
+
+  // Request-targets are recorded by component as they are parsed
+  const auto& paths = snapshot.histograms[statistics::kUriPathSize];
+  assert(paths[statistics::bucket(11)] -
+         before.histograms[statistics::kUriPathSize][statistics::bucket(11)] ==
+         10);
+  assert(snapshot.count(statistics::kUriHostSize) ==
+         before.count(statistics::kUriHostSize));
+
+  statistics::Collector collector;
+  hypp::Parser parser{"http://example.com/a?b"};
+  const auto uri = hypp::ParseUri(parser);
+  assert(uri);
+  statistics::RecordUri(collector, uri.value());
+  const auto uris = collector.snapshot();
+  assert(uris.histograms[statistics::kUriHostSize][statistics::bucket(11)] == 1);
+  assert(uris.count(statistics::kUriFragmentSize) == 0);
+
+  snapshot += uris;
+  assert(snapshot.count(statistics::kUriPathSize) ==
+         statistics::snapshot().count(statistics::kUriPathSize) + 1);
+
+  // Collectors of finished threads are reused, and keep their counts
+  auto& registry = statistics::Registry::instance();
+  const auto collectors = registry.collector_count();
+  const auto messages = statistics::snapshot().messages;
+  for (int i = 0; i < 100; ++i) {
+    std::thread{[] {
+      assert(hypp::ParseRequest("GET / HTTP/1.1\r\n\r\n",
+                                statistics::Observer{}));
+    }}.join();
+  }
+  assert(registry.collector_count() <= collectors + 1);
+  assert(statistics::snapshot().messages == messages + 100);
+}
+
+struct TightLimits : hypp::DefaultLimits {
+  static constexpr size_t kMethod = 4;
+  static constexpr size_t kFieldValue = 8;
+};
+
+struct ShortLineLimits : hypp::DefaultLimits {
+  static constexpr size_t kRequestLine = 20;
+  static constexpr size_t kStatusLine = 16;
+  static constexpr size_t kURI = 8;
+};
+
+struct UnboundedUriLimits : hypp::DefaultLimits {
+  static constexpr size_t kURI = std::numeric_limits<size_t>::max();
+};
+
+void test_parse_limits() {
+  using hypp::detail::limits::counter_t;
+  static_assert(std::is_same_v<counter_t<TightLimits::kFieldValue>, std::uint8_t>);
+  static_assert(std::is_same_v<counter_t<TightLimits::kURI>, std::uint16_t>);
+  static_assert(std::is_same_v<counter_t<size_t{1} << 20>, std::uint32_t>);
+
+  constexpr std::string_view view =
+      "GET / HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "\r\n";
+  assert(hypp::ParseRequest(view));
+  assert(hypp::ParseRequest<TightLimits>(view).error() ==
+         hypp::Error::Invalid_Header_Format);
+
+  assert(hypp::ParseRequest<TightLimits>(
+      "POST / HTTP/1.1\r\n"
+      "Host: a.b\r\n"
+      "\r\n"));
+  assert(hypp::ParseRequest<TightLimits>(
+      "DELETE / HTTP/1.1\r\n"
+      "\r\n").error() == hypp::Error::Not_Implemented);
+
+  // Start lines can be parsed on their own, with the default limits
+  hypp::Parser request_line{"GET /a HTTP/1.1\r\n"};
+  assert(hypp::ParseStartLine(request_line, hypp::Request{})
+             .value().target.uri.path == "/a");
+  hypp::Parser status_line{"HTTP/1.1 204 No Content\r\n"};
+  assert(hypp::ParseStartLine(status_line, hypp::Response{}).value().code ==
+         204);
+
+  // The request-target, request-line and status-line are bounded as a whole,
+  // not just by their components
+  assert(hypp::ParseRequest<ShortLineLimits>("GET /a/b/c HTTP/1.1\r\n\r\n"));
+  assert(hypp::ParseRequest<ShortLineLimits>(
+      "GET /a/b/c/d/e HTTP/1.1\r\n\r\n").error() ==
+         hypp::Error::URI_Too_Long);
+  assert(hypp::ParseRequest<ShortLineLimits>(
+      "OPTIONS /a/b/c HTTP/1.1\r\n\r\n").error() ==
+         hypp::Error::URI_Too_Long);
+  hypp::Parser target{"/a/b/c/d/e HTTP/1.1\r\n"};
+  assert(hypp::ParseRequestTarget<ShortLineLimits>(target).error() ==
+         hypp::Error::URI_Too_Long);
+  hypp::Parser short_target{"/a/b/c/d HTTP/1.1\r\n"};
+  assert(hypp::ParseRequestTarget<ShortLineLimits>(short_target)
+             .value().uri.path == "/a/b/c/d");
+  assert(short_target.size() == 11);
+  hypp::Parser unbounded{"/a/b/c/d/e HTTP/1.1\r\n"};
+  assert(hypp::ParseRequestTarget<UnboundedUriLimits>(unbounded)
+             .value().uri.path == "/a/b/c/d/e");
+  assert(hypp::ParseResponse<ShortLineLimits>("HTTP/1.1 200 OK\r\n\r\n"));
+  assert(hypp::ParseResponse<ShortLineLimits>(
+      "HTTP/1.1 200 Fine\r\n\r\n").error() == hypp::Error::Bad_Response);
+}
+
+void test_trusted_parsing() {
+  using hypp::Validation;
+
+  constexpr const char* requests[] = {
+      "GET /hello.txt?q=now HTTP/1.1\r\n"
+      "Host:www.example.com\r\n"
+      "Accept-Language: en, mi\r\n"
+      "\r\n",
+      "GET http://user@www.example.com:8080/a/b?c HTTP/1.1\r\n"
+      "\r\n"
+      "body",
+      "CONNECT 192.0.2.1:443 HTTP/1.1\r\n"
+      "\r\n",
+      "OPTIONS * HTTP/1.1\r\n"
+      "Empty:\r\n"
+      "\r\n",
+  };
+  for (const auto request : requests) {
+    const auto strict = hypp::ParseRequest(request, Validation::Strict);
+    const auto trusted = hypp::ParseRequest(request, Validation::Trusted);
+    assert(strict && trusted);
+    assert(strict.value().start_line.target.form ==
+           trusted.value().start_line.target.form);
+    assert(hypp::to_string(strict.value()) ==
+           hypp::to_string(trusted.value()));
+  }
+
+  constexpr auto response =
+      "HTTP/1.1 404 Not Found\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "Hello";
+  const auto strict = hypp::ParseResponse(response, Validation::Strict);
+  const auto trusted = hypp::ParseResponse(response, Validation::Trusted);
+  assert(strict && trusted);
+  assert(trusted.value().start_line.code == 404);
+  assert(hypp::to_string(strict.value()) == hypp::to_string(trusted.value()));
+
+  // Only delimiters are checked
+  assert(hypp::trusted::ParseRequest("GET /\x7f HTTP/1.1\r\n\r\n"));
+  assert(!hypp::ParseRequest("GET /\x7f HTTP/1.1\r\n\r\n"));
+  assert(!hypp::trusted::ParseRequest("GET / HTTP/1.1\r\nHost\r\n\r\n"));
+  assert(!hypp::trusted::ParseRequest("GET / HTTP/1.1\r\n"));
+}
+
+void test_header_ids() {
+  namespace header = hypp::header;
+
+  static_assert(header::to_id("Content-Length") == header::kContent_Length);
+  assert(header::to_id("content-length") == header::kContent_Length);
+  assert(header::to_id("WWW-AUTHENTICATE") == header::kWWW_Authenticate);
+  assert(header::to_id("Content-Lengths") == header::kUnknown);
+  assert(header::to_id("X-Request-ID") == header::kUnknown);
+  assert(header::to_id("") == header::kUnknown);
+  assert(header::to_name(header::kETag) == "ETag");
+
+  // Every name in the table can be found
+  for (header::id_t id = 1; !header::to_name(header::Id(id)).empty(); ++id) {
+    assert(header::to_id(header::to_name(header::Id(id))) == id);
+  }
+
+  const auto expected = hypp::ParseRequest(
+      "GET / HTTP/1.1\r\n"
+      "host: www.example.com\r\n"
+      "X-Request-ID: 1\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n");
+  assert(expected);
+  const auto& fields = expected.value().header_fields;
+  assert(fields[0].id == header::kHost && fields[0].name == "host");
+  assert(fields[1].id == header::kUnknown);
+  assert(fields[2].id == header::kTransfer_Encoding);
+
+  const auto trusted = hypp::trusted::ParseRequest(
+      "GET / HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "\r\n");
+  assert(trusted && trusted.value().header_fields[0].id == header::kHost);
+}
+
+void test_framing() {
+  namespace swar = hypp::detail::swar;
+  assert(swar::parse_digits("0") == 0u);
+  assert(swar::parse_digits("12345678") == 12345678u);
+  assert(swar::parse_digits("000000000000000000001234567890123") ==
+         1234567890123u);
+  assert(swar::parse_digits("9999999999999999999") == 9999999999999999999u);
+  assert(!swar::parse_digits("18446744073709551616"));
+  assert(!swar::parse_digits("1234567a"));
+  assert(!swar::parse_digits("123456789/"));
+  assert(!swar::parse_digits(""));
+
+  assert(hypp::ParseContentLength("42").value() == 42);
+  assert(hypp::ParseContentLength("42, 42").value() == 42);
+  assert(hypp::ParseContentLength("42, 43").error() ==
+         hypp::Error::Invalid_Content_Length);
+  assert(!hypp::ParseContentLength("-1"));
+  assert(!hypp::ParseContentLength(""));
+
+  const auto parse = [](const std::string_view view) {
+    return hypp::ParseFraming(hypp::ParseResponse(view).value().header_fields);
+  };
+
+  auto framing = parse(
+      "HTTP/1.1 200 OK\r\n"
+      "Transfer-Encoding: gzip\r\n"
+      "transfer-encoding: x-custom;q=1 , Chunked\r\n"
+      "Connection: Keep-Alive, Upgrade\r\n"
+      "\r\n");
+  assert(framing);
+  assert(framing.value().chunked);
+  assert(framing.value().transfer_codings ==
+         (hypp::kTransferCodingGzip | hypp::kTransferCodingOther |
+          hypp::kTransferCodingChunked));
+  assert(framing.value().connection ==
+         (hypp::kConnectionKeepAlive | hypp::kConnectionUpgrade));
+  assert(!framing.value().content_length);
+
+  framing = parse(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 5\r\n"
+      "Content-Length: 5\r\n"
+      "Transfer-Encoding: chunked, gzip\r\n"
+      "\r\n");
+  assert(framing && !framing.value().chunked && framing.value().ambiguous());
+  assert(*framing.value().content_length == 5);
+
+  assert(parse("HTTP/1.1 200 OK\r\n"
+               "Content-Length: 5\r\n"
+               "Content-Length: 6\r\n"
+               "\r\n").error() == hypp::Error::Invalid_Content_Length);
+  assert(parse("HTTP/1.1 200 OK\r\n"
+               "Transfer-Encoding: chunked, chunked\r\n"
+               "\r\n").error() == hypp::Error::Invalid_Transfer_Encoding);
+}
+
+void test_media_type() {
+  std::vector<std::string_view> elements;
+  for (const auto element :
+       hypp::ListElements{R"(, a ,, b;q="x,y" ,"c\",d", )"}) {
+    elements.push_back(element);
+  }
+  assert(elements.size() == 3);
+  assert(elements[0] == "a");
+  assert(elements[1] == R"(b;q="x,y")");
+  assert(elements[2] == R"("c\",d")");
+  assert(hypp::ListElements{" , ,"}.empty());
+
+  namespace media_type = hypp::media_type;
+  static_assert(media_type::to_id("Text", "HTML") == media_type::kText_Html);
+  static_assert(media_type::to_id("text", "x-unknown") == media_type::kUnknown);
+  assert(media_type::to_id("video", "webm") == media_type::kVideo_Webm);
+  assert(media_type::to_subtype(media_type::kImage_Svg_Xml) == "svg+xml");
+
+  auto expected = hypp::ParseMediaType(
+      R"(text/html ; charset=UTF-8;; format="a \"b\" ;c")");
+  assert(expected);
+  const auto& type = expected.value();
+  assert(type.type == "text" && type.subtype == "html");
+  assert(type.id == media_type::kText_Html);
+  assert(type.parameters.get("Charset")->value == "UTF-8");
+  const auto format = type.parameters.get("format");
+  assert(format && format->quoted);
+  assert(format->value == R"(a \"b\" ;c)");
+  assert(format->unquoted_value() == R"(a "b" ;c)");
+  assert(std::distance(type.parameters.begin(), type.parameters.end()) == 2);
+  assert(!type.parameters.get("q"));
+
+  assert(hypp::ParseMediaType("application/vnd.x+json").value().id ==
+         media_type::kUnknown);
+  assert(hypp::ParseMediaType("text/plain;").value().id ==
+         media_type::kText_Plain);
+  assert(hypp::ParseMediaType("text").error() ==
+         hypp::Error::Invalid_Media_Type);
+  assert(!hypp::ParseMediaType("text/"));
+  assert(!hypp::ParseMediaType("text/html; charset"));
+  assert(!hypp::ParseMediaType("text/html; charset="));
+  assert(!hypp::ParseMediaType("text/html; charset=\"utf-8"));
+  assert(!hypp::ParseMediaType("text/html charset=utf-8"));
+
+  // New errors do not renumber the existing ones
+  static_assert(static_cast<int>(hypp::Error::Invalid_HTTP_Version) == 19);
+  static_assert(static_cast<int>(hypp::Error::Invalid_Media_Type) == 22);
+}
+
+void test_negotiation() {
+  static_assert(hypp::ParseQuality("1") == 1000);
+  static_assert(hypp::ParseQuality("0.5") == 500);
+  static_assert(hypp::ParseQuality("0.125") == 125);
+  static_assert(hypp::ParseQuality("1.000") == 1000);
+  static_assert(hypp::ParseQuality("0.") == 0);
+  static_assert(!hypp::ParseQuality("1.001"));
+  static_assert(!hypp::ParseQuality("0.1234"));
+  static_assert(!hypp::ParseQuality(".5"));
+  static_assert(!hypp::ParseQuality("2"));
+
+  constexpr std::string_view accept =
+      "text/*;q=0.3, text/html;q=0.7, text/html;level=1, "
+      "text/html;level=2;q=0.4, */*;q=0.5";
+  assert(hypp::MediaTypeQuality(accept, "text/html;level=1") == 1000);
+  assert(hypp::MediaTypeQuality(accept, "text/html") == 700);
+  assert(hypp::MediaTypeQuality(accept, "text/plain") == 300);
+  assert(hypp::MediaTypeQuality(accept, "image/jpeg") == 500);
+  assert(hypp::MediaTypeQuality(accept, "text/html;level=2") == 400);
+  assert(hypp::MediaTypeQuality(accept, "text/html;level=3") == 700);
+  assert(hypp::MediaTypeQuality("", "text/html") == 1000);
+  assert(hypp::MediaTypeQuality("text/html", "invalid") == 0);
+
+  const std::array<std::string_view, 3> types{
+      "application/json", "text/html", "text/plain"};
+  assert(hypp::NegotiateMediaType(accept, types) == 1u);
+  assert(hypp::NegotiateMediaType("application/json;q=0.9, */*;q=0.9",
+                                  types) == 0u);
+  assert(hypp::NegotiateMediaType("*/*;q=0.1, TEXT/PLAIN", types) == 2u);
+  assert(!hypp::NegotiateMediaType("image/*", types));
+
+  const std::array<std::string_view, 3> codings{"br", "gzip", "identity"};
+  assert(hypp::NegotiateEncoding("gzip;q=1.0, identity; q=0.5, *;q=0",
+                                 codings) == 1u);
+  assert(hypp::NegotiateEncoding("", codings) == 2u);
+  assert(hypp::NegotiateEncoding("compress", codings) == 2u);
+  assert(!hypp::NegotiateEncoding("*;q=0", codings));
+  assert(hypp::EncodingQuality("*;q=0, identity;q=0.1", "identity") == 100);
+
+  const std::array<std::string_view, 3> languages{"en-GB", "fr", "de-CH"};
+  assert(hypp::NegotiateLanguage("da, en-gb;q=0.8, en;q=0.7", languages) ==
+         0u);
+  assert(hypp::NegotiateLanguage("de;q=0.9, fr;q=0.5", languages) == 2u);
+  assert(hypp::LanguageQuality("en", "english") == 0);
+  assert(hypp::LanguageQuality("*;q=0.1, en-US", "en") == 100);
+
+  const auto request = hypp::ParseRequest(
+      "GET / HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "Accept: text/plain;q=0.5\r\n"
+      "accept: text/html\r\n"
+      "Accept-Language: fr\r\n"
+      "\r\n");
+  assert(request);
+  const auto& header_fields = request.value().header_fields;
+  assert(hypp::NegotiateMediaType(header_fields, types) == 1u);
+  assert(hypp::NegotiateEncoding(header_fields, codings) == 0u);
+  assert(hypp::NegotiateLanguage(header_fields, languages) == 1u);
+}
+
+void test_cache() {
+  constexpr hypp::seconds_t kDate = 784111777;  // Sun, 06 Nov 1994 08:49:37
+  assert(hypp::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT") == kDate);
+  assert(hypp::ParseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT") == kDate);
+  assert(hypp::ParseHttpDate("Sun Nov  6 08:49:37 1994") == kDate);
+  assert(hypp::ParseHttpDate("Thu, 01 Jan 1970 00:00:00 GMT") == 0);
+  assert(!hypp::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 UTC"));
+  assert(!hypp::ParseHttpDate("Sun, 31 Nov 1994 08:49:37 GMT"));
+  assert(!hypp::ParseHttpDate("0"));
+
+  // February 29 only exists in leap years
+  static_assert(hypp::ParseHttpDate("Thu, 29 Feb 2024 00:00:00 GMT", kDate));
+  static_assert(hypp::ParseHttpDate("Tue, 29 Feb 2000 00:00:00 GMT", kDate));
+  static_assert(!hypp::ParseHttpDate("Sat, 29 Feb 2023 00:00:00 GMT", kDate));
+  static_assert(!hypp::ParseHttpDate("Thu, 29 Feb 1900 00:00:00 GMT", kDate));
+
+  // Two-digit years are within 50 years of the current time
+  constexpr hypp::seconds_t k2030 = 1893456000;  // Tue, 01 Jan 2030
+  static_assert(hypp::ParseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT",
+                                    kDate) == kDate);
+  static_assert(hypp::ParseHttpDate("Tuesday, 01-Jan-30 00:00:00 GMT",
+                                    k2030) == k2030);
+  static_assert(hypp::ParseHttpDate("Thursday, 01-Jan-81 00:00:00 GMT",
+                                    k2030) == 347155200);  // 1981
+  static_assert(hypp::ParseHttpDate("Saturday, 01-Jan-44 00:00:00 GMT",
+                                    kDate) == 2335219200);  // 2044
+  static_assert(hypp::ParseHttpDate("Tuesday, 01-Jan-45 00:00:00 GMT",
+                                    kDate) == -788918400);  // 1945
+
+  const auto cache_control = hypp::ParseCacheControl(
+      R"(max-age="60", No-Store, max-stale, x-ext=1, s-maxage=99999999999)");
+  assert(cache_control.max_age == 60u);
+  assert(cache_control.s_maxage == 2147483648u);
+  assert(cache_control.has(hypp::kCacheNoStore));
+  assert(!cache_control.has(hypp::kCacheNoCache));
+  assert(cache_control.any_stale && !cache_control.max_stale);
+
+  const auto request = [](const std::string_view view) {
+    return hypp::ParseRequest(view).value();
+  };
+  const auto response = [](const std::string_view view) {
+    return hypp::ParseResponse(view).value();
+  };
+
+  hypp::Cache cache{1 << 20, 4};
+  const hypp::seconds_t now = kDate;
+
+  const auto get = request(
+      "GET /index.html HTTP/1.1\r\n"
+      "Host: WWW.example.com:80\r\n"
+      "Accept-Encoding: gzip,  br\r\n"
+      "\r\n");
+  assert(cache.store(get, response(
+      "HTTP/1.1 200 OK\r\n"
+      "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+      "Cache-Control: max-age=60\r\n"
+      "ETag: \"v1\"\r\n"
+      "Vary: Accept-Encoding\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello"), now, now + 1));
+  assert(cache.size() == 1);
+
+  // Same resource in absolute-form, same selecting header fields
+  auto lookup = cache.lookup(request(
+      "GET http://www.example.com/index.html HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "accept-encoding: gzip\r\n"
+      "Accept-Encoding: br\r\n"
+      "\r\n"), now + 10);
+  assert(lookup && lookup.response->body == "hello");
+  assert(lookup.age == 10);
+  assert(!lookup.revalidation);
+
+  // Different selecting header fields
+  auto miss = get;
+  miss.header_fields.back().value = "br";
+  assert(cache.lookup(miss, now + 10).status ==
+         hypp::CacheLookup::Status::Miss);
+
+  // Stale, so it is revalidated with the validators of the stored response
+  lookup = cache.lookup(get, now + 100);
+  assert(!lookup && lookup.status == hypp::CacheLookup::Status::Stale);
+  assert(lookup.response->body == "hello");
+  const auto& revalidation = lookup.revalidation.value();
+  assert(revalidation.header_fields.back().name == "If-None-Match");
+  assert(revalidation.header_fields.back().value == "\"v1\"");
+
+  const auto updated = cache.update(get, response(
+      "HTTP/1.1 304 Not Modified\r\n"
+      "Cache-Control: max-age=3600\r\n"
+      "\r\n"), now + 100, now + 100);
+  assert(updated && updated->body == "hello");
+  assert(cache.lookup(get, now + 200));
+
+  // Request directives
+  auto no_cache = get;
+  no_cache.header_fields.push_back({"Pragma", "no-cache"});
+  assert(!cache.lookup(no_cache, now + 200));
+  auto max_age = get;
+  max_age.header_fields.push_back({"Cache-Control", "max-age=50"});
+  assert(!cache.lookup(max_age, now + 200));
+
+  // Heuristic freshness
+  const auto freshness = hypp::ComputeFreshness(response(
+      "HTTP/1.1 200 OK\r\n"
+      "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+      "Last-Modified: Sun, 06 Nov 1994 08:32:57 GMT\r\n"
+      "Age: 30\r\n"
+      "\r\n"), now, now);
+  assert(freshness.lifetime == 100);
+  assert(freshness.corrected_initial_age == 30);
+  assert(freshness.fresh(now + 69) && !freshness.fresh(now + 70));
+
+  // Not storable
+  const auto store = [&](const std::string_view view) {
+    return cache.store(get, response(view), now, now);
+  };
+  assert(!store("HTTP/1.1 200 OK\r\nCache-Control: no-store\r\n\r\n"));
+  assert(!store("HTTP/1.1 200 OK\r\nVary: *\r\n\r\n"));
+  assert(!store("HTTP/1.1 302 Found\r\n\r\n"));
+
+  cache.invalidate(get);
+  assert(cache.size() == 0 && cache.bytes() == 0);
+
+  // Least recently used entries are evicted first
+  hypp::Cache small{4096, 1};
+  const auto body = std::string(1500, 'x');
+  auto resource = [&](const int i) {
+    return request("GET /" + std::to_string(i) + " HTTP/1.1\r\n"
+                   "Host: a\r\n\r\n");
+  };
+  for (int i = 0; i < 3; ++i) {
+    auto stored = response("HTTP/1.1 200 OK\r\n"
+                           "Cache-Control: max-age=60\r\n\r\n");
+    stored.body = body;
+    assert(small.store(resource(i), std::move(stored), now, now));
+    assert(small.lookup(resource(0), now));
+  }
+  assert(small.size() == 2 && small.bytes() <= 4096);
+  assert(small.lookup(resource(0), now));
+  assert(small.lookup(resource(2), now));
+  assert(!small.lookup(resource(1), now));
+
+  // Revalidation updates the size of an entry, which may evict others
+  auto grown = response("HTTP/1.1 304 Not Modified\r\n\r\n");
+  grown.header_fields.push_back({"X-Padding", body});
+  assert(small.update(resource(0), grown, now, now));
+  assert(small.size() == 1 && small.bytes() <= 4096);
+  assert(small.bytes() > 2 * body.size());
+  assert(small.lookup(resource(0), now));
+
+  // The authority of origin-form requests is parsed from Host
+  assert(hypp::CacheKey(request("GET /a HTTP/1.1\r\n"
+                                "Host: [::1]:8080\r\n\r\n")) ==
+         "http://[::1]:8080/a");
+  assert(hypp::CacheKey(request("GET /a HTTP/1.1\r\n"
+                                "Host: Example.com\r\n\r\n")) ==
+         "http://example.com/a");
+
+  // Threads on different shards
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 100; ++i) {
+        const auto target = resource(t * 100 + i);
+        cache.store(target, response("HTTP/1.1 200 OK\r\n"
+                                     "Cache-Control: max-age=60\r\n\r\n"),
+                    now, now);
+        assert(cache.lookup(target, now));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  assert(cache.size() == 400);
+}
+
+void test_compact_message() {
+  const auto request = hypp::ParseRequest(
+      "POST http://user@www.example.com:8080/a/b?c=d HTTP/1.1\r\n"
+      "Host: www.example.com:8080\r\n"
+      "x-custom: 1\r\n"
+      "content-length: 4\r\n"
+      "Content-Length: 4\r\n"
+      "\r\n"
+      "body").value();
+
+  const auto compact = hypp::Compact(request);
+  assert(compact);
+
+  // Relocate to an unaligned address
+  std::vector<char> buffer(compact.value().size() + 1);
+  std::memcpy(buffer.data() + 1, compact.value().data().data(),
+              compact.value().size());
+  const hypp::CompactMessageView view{
+      std::string_view{buffer.data() + 1, compact.value().size()}};
+  assert(view.valid());
+  assert(view.kind() == hypp::compact::kRequest);
+  assert(view.method() == "POST");
+  assert(view.target_form() == hypp::RequestTarget::Form::Absolute);
+  assert(view.uri().authority->user_info == "user");
+  assert(view.uri().authority->port == "8080");
+  assert(view.uri().path == "/a/b" && view.uri().query == "c=d");
+  assert(!view.uri().fragment);
+  assert(view.version().major == '1' && view.version().minor == '1');
+  assert(view.header_count() == 4);
+  assert(view.header_field(1).name == "x-custom");
+  assert(view.header_field(2).name == "content-length");
+  assert(view.header_field(3).name == "Content-Length");
+  assert(view.header_value(hypp::header::kContent_Length) == "4");
+  assert(view.body() == "body");
+
+  const auto expanded = hypp::to_request(view);
+  assert(hypp::to_string(expanded) == hypp::to_string(request));
+  assert(expanded.header_fields[3].id == hypp::header::kContent_Length);
+
+  const auto response = hypp::ParseResponse(
+      "HTTP/1.1 404 Not Found\r\n"
+      "Content-Type: text/plain\r\n"
+      "\r\n").value();
+  const auto compact_response = hypp::Compact(response).value();
+  assert(compact_response.view().valid());
+  assert(compact_response.view().code() == 404);
+  assert(compact_response.view().uri().path.empty());
+  assert(hypp::to_string(hypp::to_response(compact_response.view())) ==
+         hypp::to_string(response));
+
+  // Registered names are not stored
+  assert(compact_response.size() == sizeof(hypp::compact::Header) +
+                                    sizeof(hypp::compact::Field) +
+                                    std::string_view{"text/plain"}.size());
+
+  auto corrupt = std::string{compact_response.data()};
+  corrupt[sizeof(hypp::compact::Header) + 12] = '\x7F';  // value length
+  assert(!hypp::CompactMessageView{corrupt}.valid());
+  assert(!hypp::CompactMessageView{corrupt.substr(0, 10)}.valid());
+}
+
+void test_snapshot() {
+  const std::string data =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello"
+      "HTTP/1.1 200 OK\r\n"
+      "Bad Header\r\n"
+      "\r\n"
+      "HTTP/1.1 999 \r\n"
+      "Content-Length: 0\r\n"
+      "\r\n"
+      "HTTP/1.1 404 Not Found\r\n"
+      "Content-Type: text/plain\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n";
+
+  std::ostringstream output;
+  {
+    hypp::SnapshotWriter writer{output};
+    const auto statistics = hypp::WriteSnapshot<hypp::Response>(data, writer);
+    assert(statistics.messages == 4 && statistics.errors == 1);
+    assert(writer.size() == 3);
+    assert(writer.close());
+  }
+  const auto bytes = output.str();
+
+  const hypp::SnapshotView snapshot{bytes};
+  assert(snapshot.valid() && snapshot.size() == 3);
+  for (size_t i = 0; i < snapshot.size(); ++i) {
+    assert(snapshot[i].valid());
+    assert(reinterpret_cast<std::uintptr_t>(snapshot[i].data().data()) %
+           hypp::snapshot::kAlignment ==
+           reinterpret_cast<std::uintptr_t>(bytes.data()) %
+           hypp::snapshot::kAlignment);
+  }
+  assert(snapshot[0].body() == "hello");
+  assert(snapshot[1].code() == 999);
+  assert(snapshot[2].header_value(hypp::header::kContent_Type) ==
+         "text/plain");
+  assert(!snapshot[3].valid() && !snapshot[size_t(-1)].valid());
+
+  assert(!hypp::SnapshotView{bytes.substr(0, bytes.size() - 1)}.valid());
+  assert(!hypp::SnapshotView{std::string_view{}}.valid());
+
+  // Inputs with more partitions than threads are written a window at a time
+  std::string requests;
+  while (requests.size() < (1 << 19)) {
+    requests += "POST /upload HTTP/1.1\r\n"
+                "Content-Length: 27\r\n"
+                "\r\n"
+                "GET /body HTTP/1.1\r\n\r\n.....";
+  }
+  std::ostringstream windowed;
+  {
+    hypp::SnapshotWriter writer{windowed};
+    const auto statistics =
+        hypp::WriteSnapshot<hypp::Request>(requests, writer, 2);
+    const auto bulk = hypp::ParseBulk<hypp::Request>(requests, 2);
+    assert(statistics.messages == bulk.statistics.messages);
+    assert(statistics.errors == 0 && writer.size() == bulk.messages.size());
+    assert(writer.close());
+  }
+  const auto windowed_bytes = windowed.str();
+  const hypp::SnapshotView windowed_snapshot{windowed_bytes};
+  assert(windowed_snapshot.size() * 72 == requests.size());
+  for (size_t i = 0; i < windowed_snapshot.size(); ++i) {
+    assert(windowed_snapshot[i].body() == "GET /body HTTP/1.1\r\n\r\n.....");
+  }
+
+  // Memory-mapped file
+  const std::string path = "hypp_test.snapshot";
+  {
+    hypp::SnapshotWriter writer{path};
+    assert(writer.write(hypp::ParseRequest(
+        "GET /index.html HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "\r\n").value()));
+  }
+  {
+    const hypp::Snapshot file{path};
+    assert(file.is_open() && file.size() == 1);
+    assert(file[0].valid() && file[0].uri().path == "/index.html");
+    assert(hypp::to_request(file[0]).header_fields[0].value ==
+           "www.example.com");
+  }
+  std::remove(path.c_str());
+  assert(!hypp::Snapshot{path}.is_open());
+}
+
+void test_message_editor() {
+  const std::string request =
+      "GET http://user@www.example.com:8080/a/b?q=1#top HTTP/1.1\r\n"
+      "Host: proxy.example.net\r\n"
+      "Connection: keep-alive, X-Hop\r\n"
+      "Keep-Alive: timeout=5\r\n"
+      "X-Hop: 1\r\n"
+      "Proxy-Connection: keep-alive\r\n"
+      "Accept: */*\r\n"
+      "X-Other: a, b\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello";
+
+  hypp::MessageEditor editor{request};
+  assert(editor.valid() && editor.is_request());
+  assert(editor.get("x-hop") == "1");
+  assert(editor.get("Accept") == "*/*");
+
+  // Without patches, the message is passed through as a single buffer
+  auto buffers = editor.buffers();
+  assert(buffers.size() == 1 && buffers[0].data == request.data());
+  assert(hypp::to_string(buffers) == request);
+
+  assert(editor.to_origin_form());
+  assert(editor.remove_hop_by_hop() == 4);
+  editor.add("Via", "1.1 hypp");
+  buffers = editor.buffers();
+  assert(hypp::BufferSize(buffers) == hypp::to_string(buffers).size());
+  assert(hypp::to_string(buffers) ==
+         "GET /a/b?q=1 HTTP/1.1\r\n"
+         "Host: www.example.com:8080\r\n"
+         "Accept: */*\r\n"
+         "X-Other: a, b\r\n"
+         "Content-Length: 5\r\n"
+         "Via: 1.1 hypp\r\n"
+         "\r\n"
+         "hello");
+  // Accept, X-Other and Content-Length are a single range of the original
+  const auto accept = request.find("Accept");
+  const auto it = std::find_if(buffers.begin(), buffers.end(),
+      [&](const auto& buffer) { return buffer.data == &request[accept]; });
+  assert(it != buffers.end() &&
+         it->view() == request.substr(accept, request.find("\r\n\r\n") -
+                                              accept + 2));
+  assert(hypp::ParseRequest(hypp::to_string(buffers)));
+
+  // Responses, and adding fields that are missing
+  const std::string response =
+      "HTTP/1.1 200 OK\r\n"
+      "Server: origin\r\n"
+      "Server: again\r\n"
+      "\r\n";
+  hypp::MessageEditor response_editor{response};
+  assert(response_editor.valid() && !response_editor.is_request());
+  assert(!response_editor.set_request_target("/"));
+  assert(!response_editor.to_origin_form());
+  response_editor.replace("Server", "proxy");
+  response_editor.replace("Age", "0");
+  assert(response_editor.patches().size() == 3);
+  assert(hypp::to_string(response_editor.buffers()) ==
+         "HTTP/1.1 200 OK\r\n"
+         "Server: proxy\r\n"
+         "Age: 0\r\n"
+         "\r\n");
+
+  // Fields and targets that would inject more fields or messages
+  assert(!response_editor.add("Age", "0\r\nSet-Cookie: a=b"));
+  assert(!response_editor.replace("Server", "a\nb"));
+  assert(!response_editor.add("Bad Name", "value"));
+  assert(!response_editor.add("", "value"));
+  assert(response_editor.patches().size() == 3);
+  hypp::MessageEditor target_editor{"GET / HTTP/1.1\r\nHost: a\r\n\r\n"};
+  assert(!target_editor.set_request_target("/ HTTP/1.1\r\nX: y\r\n\r\nGET /"));
+  assert(!target_editor.set_request_target(""));
+  assert(target_editor.patches().empty());
+
+  assert(!hypp::MessageEditor{"GET / HTTP/1.1\r\nHost: a\r\n"}.valid());
+  assert(!hypp::MessageEditor{"GET / HTTP/1.1\r\n: a\r\n\r\n"}.valid());
+  assert(!hypp::MessageEditor{"GET / HTTP/1.1\r\nA: a\r\n b\r\n\r\n"}
+              .valid());
+}
+
+struct SmallLimits : hypp::DefaultLimits {
+  static constexpr size_t kHeaderFields = 16;
+};
+
+void test_buffer_chain() {
+  const std::string request =
+      "GET /index.html?page=1 HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "Accept: text/html\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello";
+  const auto expected = hypp::to_string(hypp::ParseRequest(request).value());
+
+  // Every split into two and three buffers gives the same result
+  for (size_t i = 0; i <= request.size(); ++i) {
+    const std::string_view view{request};
+    const hypp::ConstBuffers two{{view.data(), i},
+                                 {view.data() + i, view.size() - i}};
+    const auto parsed = hypp::ParseRequest(two);
+    assert(parsed && hypp::to_string(parsed.value()) == expected);
+    for (size_t j = i; j <= request.size(); ++j) {
+      const hypp::ConstBuffers three{{view.data(), i},
+                                     {view.data() + i, j - i},
+                                     {view.data() + j, view.size() - j}};
+      const auto parsed = hypp::ParseRequest(three);
+      assert(parsed && hypp::to_string(parsed.value()) == expected);
+    }
+  }
+
+  // Only the line that crosses a boundary is copied
+  const auto host = request.find("Host");
+  const hypp::ConstBuffers slabs{{request.data(), host + 4},
+                                 {request.data() + host + 4,
+                                  request.size() - host - 4}};
+  hypp::detail::ChainReader reader{slabs.data(), slabs.size()};
+  assert(reader.read_line(1024) == "GET /index.html?page=1 HTTP/1.1\r\n");
+  assert(reader.read_line(1024) == "Host: www.example.com\r\n");
+  assert(reader.copied() == 23);
+  const auto accept = reader.read_line(1024);
+  assert(accept->data() == request.data() + request.find("Accept"));
+  assert(reader.copied() == 23);
+
+  // Errors are the same as for a contiguous message
+  for (const std::string invalid : {
+           "GET / HTTP/1.1\r\nHost: a\r\n",
+           "GET / HTTP/1.1\r\n Host: a\r\n\r\n",
+           "\r\nHTTP/1.1 200 OK\r\n\r\n",
+           "GET / HTTP/1.1\r\nHost a\r\n\r\n",
+           "GET /"}) {
+    const auto error = hypp::ParseMessage<hypp::Request>(invalid).error();
+    const std::string_view view{invalid};
+    for (size_t i = 0; i <= invalid.size(); ++i) {
+      const hypp::ConstBuffers two{{view.data(), i},
+                                   {view.data() + i, view.size() - i}};
+      const auto parsed = hypp::ParseMessage<hypp::Request>(two);
+      assert(!parsed && parsed.error() == error);
+    }
+  }
+  const hypp::ConstBuffers leading{{"\r\n", 2}, {"GET / HTTP/1.1\r\n", 16},
+                                   {"\r\n", 2}};
+  assert(hypp::ParseRequest(leading));
+  assert(!hypp::ParseResponse(hypp::ConstBuffers{{"\r\n", 2},
+                                                 {"HTTP/1.1 200 OK\r\n", 17},
+                                                 {"\r\n", 2}}));
+
+  // Lines that have to be copied are limited
+  const hypp::ConstBuffers large{{"GET / HTTP/1.1\r\nX-Large: ", 25},
+                                 {"0123456789abcdef\r\n\r\n", 20}};
+  assert(hypp::ParseRequest<SmallLimits>(large).error() ==
+         hypp::Error::Request_Header_Fields_Too_Large);
+}
+
+void test_input_buffer() {
+  const auto write = [](hypp::InputBuffer& input, std::string_view data) {
+    while (!data.empty()) {
+      const auto buffer = input.prepare();
+      const auto size = std::min(buffer.size, data.size());
+      std::memcpy(buffer.data, data.data(), size);
+      input.commit(size);
+      data.remove_prefix(size);
+    }
+  };
+
+  const std::string first =
+      "POST /upload HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello";
+  const std::string second =
+      "POST /upload HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "5\r\nhello\r\n"
+      "0\r\n"
+      "Trailer: value\r\n"
+      "\r\n";
+  const std::string third = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+  const auto stream = first + second + third;
+
+  // Messages are framed however the data arrives
+  for (const size_t slab_size : {size_t{7}, size_t{64}, size_t{1024}}) {
+    hypp::InputBuffer input{slab_size};
+    std::vector<hypp::InputLease> leases;
+    for (size_t i = 0; i < stream.size(); i += 5) {
+      write(input, std::string_view{stream}.substr(i, 5));
+      while (auto lease = input.next<hypp::Request>()) {
+        leases.push_back(std::move(*lease));
+      }
+    }
+    assert(input.empty());
+    assert(leases.size() == 3);
+    assert(hypp::to_string(leases[0].buffers()) == first);
+    assert(hypp::to_string(leases[1].buffers()) == second);
+    assert(hypp::to_string(leases[2].buffers()) == third);
+    assert(hypp::ParseRequest(leases[0].buffers()).value().body == "hello");
+    if (slab_size == 1024) {
+      assert(leases[0].contiguous() == first);
+    }
+
+    // Leased bytes stay valid after the buffer is reused
+    write(input, std::string(slab_size * 3, 'x'));
+    assert(hypp::to_string(leases[1].buffers()) == second);
+    input.clear();
+  }
+
+  // Slabs are reused once they are consumed and released
+  hypp::InputBuffer input{16};
+  write(input, third);
+  assert(input.slab_count() == 2);
+  auto lease = input.next<hypp::Request>();
+  assert(lease && input.empty() && input.spare_slab_count() == 0);
+  lease->release();
+  write(input, third);
+  input.clear();
+  assert(input.spare_slab_count() > 0);
+
+  // Incomplete messages, and responses delimited by the connection
+  write(input, "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nhello");
+  assert(!input.next<hypp::Response>());
+  write(input, "world");
+  assert(input.next<hypp::Response>()->size() == 49 && input.empty());
+  write(input, "HTTP/1.1 200 OK\r\n\r\nhello");
+  assert(!input.frame<hypp::Response>());
+  input.clear();
+  write(input, "HTTP/1.1 304 Not Modified\r\n\r\n");
+  assert(input.frame<hypp::Response>() == input.size());
+  input.clear();
+
+  // Responses to HEAD and CONNECT requests that have no body
+  const std::string head_response =
+      "HTTP/1.1 200 OK\r\nContent-Length: 1000000\r\n\r\n";
+  write(input, head_response + head_response);
+  assert(input.frame<hypp::Response>() == input.size());
+  lease = input.next<hypp::Response>(false, hypp::method::kHead);
+  assert(lease && lease->size() == head_response.size());
+  assert(hypp::ParseResponse(lease->buffers()));
+  input.clear();
+  write(input, "HTTP/1.1 200 Connection Established\r\n\r\n");
+  assert(!input.frame<hypp::Response>());
+  assert(input.frame<hypp::Response>(false, "CONNECT") == input.size());
+  input.clear();
+
+  // A header section that never ends is handed to the parser at the limit
+  write(input, "GET / HTTP/1.1\r\n");
+  write(input, std::string(70000, 'a'));
+  assert(!input.frame<hypp::Request>());
+  write(input, std::string(70000, 'a'));
+  assert(input.frame<hypp::Request>() == input.size());
+  input.clear();
+
+  // Bodies beyond the limit are handed to the parser instead of buffered
+  write(input, "POST / HTTP/1.1\r\nContent-Length: 999999999999\r\n\r\nab");
+  lease = input.next<hypp::Request>();
+  assert(lease && input.empty());
+  assert(hypp::ParseRequest(lease->buffers()).error() ==
+         hypp::Error::Payload_Too_Large);
+  write(input, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+               "8000\r\n" + std::string(0x8000, 'a') + "\r\n8000\r\n");
+  assert(input.frame<hypp::Request>() == input.size());
+  input.clear();
+  write(input, "HTTP/1.1 200 OK\r\n\r\n");
+  write(input, std::string(hypp::DefaultLimits::kBody, 'a'));
+  assert(!input.frame<hypp::Response>());
+  write(input, "a");
+  lease = input.next<hypp::Response>();
+  assert(lease && input.empty());
+  assert(hypp::ParseResponse(lease->buffers()).error() ==
+         hypp::Error::Payload_Too_Large);
+
+  // Framing resumes where the previous call stopped
+  const std::string chunked =
+      "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+      "3\r\nabc\r\n10\r\n0123456789abcdef\r\n0\r\nA: b\r\n\r\n";
+  for (const char c : chunked) {
+    assert(!input.frame<hypp::Request>());
+    write(input, std::string_view{&c, 1});
+  }
+  write(input, "GET / HTTP/1.1\r\n\r\n");
+  assert(input.frame<hypp::Request>() == chunked.size());
+  lease = input.next<hypp::Request>();
+  assert(lease && lease->size() == chunked.size());
+  assert(input.frame<hypp::Request>() == input.size());
+  input.clear();
+
+  // Invalid chunked bodies are not split into more messages
+  for (const auto* body : {"zz\r\n\r\n", "FFFFFFFFFFFFFFFFF\r\n",
+                           "2\r\nabcd\r\n0\r\n\r\n"}) {
+    write(input, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n" +
+                 std::string{body} + "GET /smuggled HTTP/1.1\r\n\r\n");
+    lease = input.next<hypp::Request>();
+    assert(lease && input.empty());
+    assert(hypp::ParseRequest(lease->buffers()).error() ==
+           hypp::Error::Invalid_Transfer_Encoding);
+  }
+}
+
+#if defined(__cpp_impl_coroutine)
+struct TrailerLimits : hypp::DefaultLimits {
+  static constexpr size_t kHeaderFields = 32;
+};
+
+hypp::Task<size_t> read_responses(hypp::MemorySource& source,
+                                  std::vector<hypp::Response>& responses) {
+  hypp::InputBuffer input{32};
+  while (true) {
+    auto expected = co_await hypp::AsyncReadResponse(source, input);
+    if (!expected) {
+      assert(expected.error() == hypp::Error::Connection_Closed);
+      co_return responses.size();
+    }
+    responses.push_back(std::move(expected.value()));
+  }
+}
+
+void test_async_read() {
+  const std::string stream =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello"
+      "HTTP/1.1 204 No Content\r\n"
+      "\r\n"
+      "HTTP/1.1 200 OK\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "5\r\nhello\r\n0\r\n\r\n"
+      "HTTP/1.1 200 OK\r\n"
+      "\r\n"
+      "until the end";
+
+#if defined(__cpp_concepts)
+  static_assert(hypp::ByteSource<hypp::MemorySource>);
+  static_assert(!hypp::ByteSource<std::string>);
+#endif
+
+  for (const size_t read_size : {size_t{1}, size_t{7}, stream.size()}) {
+    hypp::MemorySource source{stream, read_size};
+    std::vector<hypp::Response> responses;
+    auto task = read_responses(source, responses);
+    task.start();
+    assert(task.done() && task.get() == 4);
+    assert(source.empty());
+    assert(responses[0].body == "hello");
+    assert(responses[1].start_line.code == 204);
+    assert(responses[2].body == "5\r\nhello\r\n0\r\n\r\n");
+    assert(responses[3].body == "until the end");
+  }
+
+  // A connection that is closed in the middle of a message, and one that is
+  // closed between messages
+  hypp::MemorySource truncated{"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n"};
+  auto task = hypp::AsyncReadResponse(truncated);
+  task.start();
+  assert(task.done() && task.get().error() == hypp::Error::Bad_Response);
+  hypp::MemorySource closed{""};
+  task = hypp::AsyncReadResponse(closed);
+  task.start();
+  assert(task.done() && task.get().error() == hypp::Error::Connection_Closed);
+
+  // A response to HEAD does not wait for the body that it describes
+  hypp::MemorySource head{"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\n"};
+  task = hypp::AsyncReadResponse(head, hypp::method::kHead);
+  task.start();
+  assert(task.done() && task.get().value().body.empty());
+
+  // Bodies are passed to a sink as they arrive, with a bounded input buffer
+  const std::string large =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 100000\r\n"
+      "\r\n" + std::string(100000, 'x') +
+      "HTTP/1.1 200 OK\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "5;name=value\r\nhello\r\n0\r\nTrailer: value\r\n\r\n"
+      "HTTP/1.1 200 OK\r\n"
+      "\r\n" + std::string(1000, 'y');
+  hypp::MemorySource source{large, 100};
+  hypp::InputBuffer input{256};
+  std::vector<std::string> bodies;
+  for (int i = 0; i < 3; ++i) {
+    hypp::SpillSink sink{1024};
+    auto task = hypp::AsyncReadMessage<hypp::Response>(source, input, sink);
+    task.start();
+    assert(task.done() && task.get() && input.slab_count() <= 2);
+    bodies.emplace_back(sink.view());
+    assert(sink.spilled() == (i == 0));
+  }
+  assert(bodies[0] == std::string(100000, 'x'));
+  assert(bodies[1] == "hello");
+  assert(bodies[2] == std::string(1000, 'y'));
+
+  // Chunked bodies are decoded as they arrive, and invalid ones are rejected
+  const auto read_chunked = [](const std::string& body,
+                               hypp::StringSink& sink) {
+    const std::string response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n" + body;
+    hypp::MemorySource source{response, 3};
+    hypp::InputBuffer input{16};
+    auto task = hypp::AsyncReadMessage<hypp::Response, TrailerLimits>(
+        source, input, sink);
+    task.start();
+    assert(task.done());
+    return task.get();
+  };
+  hypp::StringSink decoded;
+  assert(read_chunked("3\r\nabc\r\n10\r\n0123456789abcdef\r\n0\r\n"
+                      "A: 1\r\nB: 2\r\n\r\n", decoded));
+  assert(decoded.body == "abc0123456789abcdef");
+  for (const auto* body : {"zz\r\n\r\n", "2\r\nabcd\r\n0\r\n\r\n",
+                           "FFFFFFFFFFFFFFFFF\r\n"}) {
+    hypp::StringSink sink;
+    assert(read_chunked(body, sink).error() ==
+           hypp::Error::Invalid_Transfer_Encoding);
+  }
+  hypp::StringSink sink;
+  assert(read_chunked("0\r\nA: 1\r\nB: 2\r\nC: 3\r\nD: 4\r\nE: 5\r\n"
+                      "F: 6\r\n\r\n", sink).error() ==
+         hypp::Error::Request_Header_Fields_Too_Large);
+}
+#endif
+
+void test_body_sink() {
+  // Small bodies stay in memory
+  hypp::SpillSink small{16};
+  assert(small.write("hello, ") && small.write("world"));
+  assert(small.finish() && !small.spilled());
+  assert(small.view() == "hello, world" && small.size() == 12);
+
+  // Large bodies are written to a file, and mapped once complete
+  std::string path;
+  {
+    hypp::SpillSink large{16};
+    assert(large.write("0123456789") && large.write("abcdefghij"));
+    assert(large.spilled() && !large.path().empty());
+    assert(large.write(std::string(100000, 'x')));
+    assert(large.finish());
+    assert(large.size() == 100020 && large.view().size() == 100020);
+    assert(large.view().substr(0, 20) == "0123456789abcdefghij");
+    assert(large.view().back() == 'x');
+    assert(!large.write("more"));
+    path = large.path();
+    assert(hypp::detail::MappedFile{path}.is_open());
+  }
+  assert(!hypp::detail::MappedFile{path}.is_open());
+
+  // Parsing with a sink
+  const std::string response =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 12\r\n"
+      "\r\n"
+      "hello, world";
+  const std::string_view view{response};
+  const hypp::ConstBuffers buffers{{view.data(), 30}, {view.data() + 30, 10},
+                                   {view.data() + 40, view.size() - 40}};
+  hypp::SpillSink sink{4};
+  const auto parsed = hypp::ParseMessage<hypp::Response>(buffers, sink);
+  assert(parsed && parsed.value().body.empty());
+  assert(sink.spilled() && sink.view() == "hello, world");
+
+  hypp::StringSink limited;
+  limited.limit = 4;
+  assert(hypp::ParseMessage<hypp::Response>(buffers, limited).error() ==
+         hypp::Error::Payload_Too_Large);
+
+  // The body ends at its Content-Length, and chunked bodies are decoded
+  const std::string pipelined = response + "HTTP/1.1 204 No Content\r\n\r\n";
+  hypp::StringSink exact;
+  assert(hypp::ParseMessage<hypp::Response>(
+      hypp::ConstBuffers{{pipelined.data(), pipelined.size()}}, exact));
+  assert(exact.body == "hello, world");
+
+  const std::string chunked =
+      "HTTP/1.1 200 OK\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "5;name=value\r\nhello\r\n"
+      "7\r\n, world\r\n"
+      "0\r\n"
+      "Expires: 0\r\n"
+      "\r\n"
+      "HTTP/1.1 204 No Content\r\n\r\n";
+  for (size_t split = 40; split < 80; ++split) {
+    const hypp::ConstBuffers parts{{chunked.data(), split},
+                                   {chunked.data() + split,
+                                    chunked.size() - split}};
+    hypp::StringSink decoded;
+    hypp::SpillSink spilled{4};
+    assert(hypp::ParseMessage<hypp::Response>(parts, decoded));
+    assert(hypp::ParseMessage<hypp::Response>(parts, spilled));
+    assert(decoded.body == "hello, world" && spilled.view() == "hello, world");
+  }
+  const auto truncated = chunked.substr(0, 60);
+  hypp::StringSink incomplete;
+  assert(hypp::ParseMessage<hypp::Response>(
+      hypp::ConstBuffers{{truncated.data(), truncated.size()}},
+      incomplete).error() == hypp::Error::Bad_Response);
+  const std::string bad = "HTTP/1.1 200 OK\r\n"
+                          "Transfer-Encoding: chunked\r\n"
+                          "\r\n"
+                          "5\r\nhello!!\r\n0\r\n\r\n";
+  hypp::StringSink invalid;
+  assert(hypp::ParseMessage<hypp::Response>(
+      hypp::ConstBuffers{{bad.data(), bad.size()}}, invalid).error() ==
+         hypp::Error::Invalid_Transfer_Encoding);
+}
+
+void test_chunked_encoder() {
+  // Small writes are batched into chunks of the chunk size
+  hypp::ChunkedEncoder encoder{8};
+  for (int i = 0; i < 10; ++i) {
+    encoder.write("abc");
+  }
+  assert(hypp::to_string(encoder.buffers()) ==
+         "8\r\nabcabcab\r\n"
+         "8\r\ncabcabca\r\n"
+         "8\r\nbcabcabc\r\n");
+  encoder.flush("name=value");
+  encoder.finish({{"Expires", "0", hypp::header::kExpires}});
+  assert(encoder.finished());
+  const auto body = hypp::to_string(encoder.buffers());
+  assert(body.size() == encoder.size());
+  assert(body.substr(body.size() - 39) ==
+         "6;name=value\r\nabcabc\r\n"
+         "0\r\nExpires: 0\r\n\r\n");
+  assert(hypp::detail::FrameChunkedBody(body, 0) == body.size());
+
+  // Chunk extensions cannot add lines
+  for (const auto* extension : {"a\r\n0\r\n\r\n", "a=", "=b", "a;", "a=\"b"}) {
+    hypp::ChunkedEncoder invalid{8};
+    invalid.write("abc");
+    assert(!invalid.flush(extension));
+    assert(!invalid.write_view("def", extension));
+    assert(!invalid.finish({}, extension));
+    assert(!invalid.finished() && invalid.size() == 0);
+  }
+  hypp::ChunkedEncoder extended{8};
+  extended.write("abc");
+  assert(extended.flush("a;b=c;d=\"e; f\""));
+  assert(extended.finish());
+  assert(hypp::to_string(extended.buffers()) ==
+         "3;a;b=c;d=\"e; f\"\r\nabc\r\n0\r\n\r\n");
+
+  // Large blocks are referenced, and output can be sent in parts
+  const std::string block(1000, 'x');
+  hypp::ChunkedEncoder streaming{16};
+  streaming.write("head");
+  streaming.write_view(block);
+  auto buffers = streaming.buffers();
+  assert(std::any_of(buffers.begin(), buffers.end(), [&](const auto& buffer) {
+    return buffer.data == block.data() && buffer.size == block.size();
+  }));
+  std::string sent = hypp::to_string(buffers);
+  streaming.clear();
+  streaming.write("tail");
+  assert(streaming.size() == 0);
+  streaming.finish();
+  sent += hypp::to_string(streaming.buffers());
+  assert(sent == "4\r\nhead\r\n3e8\r\n" + block +
+                 "\r\n4\r\ntail\r\n0\r\n\r\n");
+
+  // Nothing is added after the last chunk
+  const auto finished = streaming.size();
+  streaming.write("late");
+  streaming.write_view(block);
+  streaming.flush();
+  streaming.finish({{"Expires", "0", hypp::header::kExpires}});
+  assert(streaming.size() == finished);
+
+  // A message with a chunked body can be parsed back
+  const auto request = hypp::ParseRequest(
+      "POST /upload HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n" + sent);
+  assert(request && request.value().body == sent);
+}
+
+void test_message_batch() {
+  std::vector<hypp::Request> requests;
+  for (const auto* target : {"/a", "/b", "/c"}) {
+    const auto request = hypp::ParseRequest(
+        std::string{"GET "} + target + " HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "Accept: */*\r\n"
+        "\r\n");
+    assert(request);
+    requests.push_back(request.value());
+  }
+  auto post = requests.front();
+  post.start_line.method = "POST";
+  post.header_fields.push_back({"Content-Length", "5",
+                                hypp::header::kContent_Length});
+  post.body = "hello";
+  requests.push_back(post);
+
+  // The output is the same as serializing each request
+  hypp::RequestBatch batch;
+  std::string expected;
+  for (const auto& request : requests) {
+    batch.add(request);
+    expected += hypp::to_string(request);
+  }
+  assert(batch.size() == 4);
+  assert(batch.bytes() == expected.size());
+  assert(batch.to_string() == expected);
+  assert(hypp::to_string(batch.buffers()) == expected);
+
+  // Identical header sections are shared
+  assert(batch.header_block_count() == 2);
+  const auto buffers = batch.buffers();
+  assert(buffers[1].data == buffers[3].data);
+
+  // Bodies are referenced rather than copied
+  assert(buffers.back().data == requests.back().body.data());
+
+  // Requests can be parsed back in order
+  std::string_view view = expected;
+  for (const auto& request : requests) {
+    const auto size = hypp::detail::FrameMessage<hypp::Request>(view);
+    const auto parsed = hypp::ParseRequest(view.substr(0, size));
+    assert(parsed && parsed.value().body == request.body);
+    view.remove_prefix(size);
+  }
+  assert(view.empty());
+
+  batch.clear();
+  assert(batch.empty() && !batch.bytes() && batch.to_string().empty());
+}
+
 }  // namespace
 
 int main() {
   test_request();
   test_response();
+  test_request_template();
+  test_uri_encoding();
+  test_query_parameters();
+  test_uri_resolution();
+  test_uri_hashing();
+  test_uri_batch();
+  test_bulk_parsing();
+  test_parse_observer();
+  test_parse_statistics();
+  test_parse_limits();
+  test_trusted_parsing();
+  test_header_ids();
+  test_framing();
+  test_media_type();
+  test_negotiation();
+  test_cache();
+  test_compact_message();
+  test_snapshot();
+  test_message_editor();
+  test_buffer_chain();
+  test_input_buffer();
+#if defined(__cpp_impl_coroutine)
+  test_async_read();
+#endif
+  test_body_sink();
+  test_chunked_encoder();
+  test_message_batch();
   std::cout << "Passed all tests!\n";
   return 0;
 }
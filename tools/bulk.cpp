@@ -0,0 +1,70 @@
+// Parses a file of concatenated HTTP/1.1 messages on all cores, and reports
+// error counts and throughput.
+//
+// Usage: bulk [--requests] [--threads N] FILE
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include <hypp.hpp>
+
+namespace {
+
+template <typename MessageT>
+int run(const std::string& path, const size_t threads) {
+  const auto result = hypp::ParseBulkFile<MessageT>(path, threads);
+  if (!result) {
+    std::cerr << "Could not open file: " << path << '\n';
+    return 1;
+  }
+
+  std::map<std::string, size_t> errors;
+  for (const auto& expected : result->messages) {
+    if (!expected) {
+      ++errors[hypp::to_string(expected.error())];
+    }
+  }
+
+  const auto& statistics = result->statistics;
+  std::cout << "Messages:   " << statistics.messages << '\n'
+            << "Errors:     " << statistics.errors << '\n';
+  for (const auto& [error, count] : errors) {
+    std::cout << "  " << error << ": " << count << '\n';
+  }
+  std::cout << "Bytes:      " << statistics.bytes << '\n'
+            << "Time:       " << statistics.seconds * 1000 << " ms\n"
+            << "Throughput: " << statistics.throughput() / (1 << 20)
+            << " MiB/s\n";
+
+  return statistics.errors ? 2 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool requests = false;
+  size_t threads = 0;
+  std::string path;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--requests") {
+      requests = true;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::strtoul(argv[++i], nullptr, 10);
+    } else {
+      path = arg;
+    }
+  }
+
+  if (path.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [--requests] [--threads N] FILE\n";
+    return 1;
+  }
+
+  return requests ? run<hypp::Request>(path, threads) :
+                    run<hypp::Response>(path, threads);
+}
@@ -0,0 +1,79 @@
+// Converts a file of concatenated HTTP/1.1 messages into a snapshot that can be
+// memory-mapped with hypp::Snapshot, and reports how long it takes to open it
+// again.
+//
+// Usage: snapshot [--requests] [--threads N] INPUT OUTPUT
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <hypp.hpp>
+
+namespace {
+
+template <typename MessageT>
+int run(const std::string& input, const std::string& output,
+        const size_t threads) {
+  hypp::detail::MappedFile file;
+  if (!file.open(input)) {
+    std::cerr << "Could not open file: " << input << '\n';
+    return 1;
+  }
+
+  hypp::SnapshotWriter writer{output};
+  const auto statistics =
+      hypp::WriteSnapshot<MessageT>(file.view(), writer, threads);
+  const auto messages = writer.size();
+  if (!writer.close()) {
+    std::cerr << "Could not write file: " << output << '\n';
+    return 1;
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  const hypp::Snapshot snapshot{output};
+  const auto end = std::chrono::steady_clock::now();
+
+  std::cout << "Messages:   " << statistics.messages << '\n'
+            << "Errors:     " << statistics.errors << '\n'
+            << "Written:    " << messages << '\n'
+            << "Parse time: " << statistics.seconds * 1000 << " ms\n"
+            << "Open time:  "
+            << std::chrono::duration<double, std::milli>(end - begin).count()
+            << " ms\n";
+
+  return snapshot.is_open() && snapshot.size() == messages ? 0 : 2;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool requests = false;
+  size_t threads = 0;
+  std::string input;
+  std::string output;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--requests") {
+      requests = true;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (input.empty()) {
+      input = arg;
+    } else {
+      output = arg;
+    }
+  }
+
+  if (input.empty() || output.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--requests] [--threads N] INPUT OUTPUT\n";
+    return 1;
+  }
+
+  return requests ? run<hypp::Request>(input, output, threads) :
+                    run<hypp::Response>(input, output, threads);
+}
@@ -0,0 +1,138 @@
+import csv
+import os
+import re
+import requests
+
+csv_path = '../references/http-header-fields.csv'
+header_path = '../include/hypp/header.hpp'
+fields = []
+
+hash_table_size = 256
+hash_bucket_count = 32
+
+def slugify(name):
+	return name.replace('-', '_')
+
+def get_csv_file():
+	r = requests.get('https://www.iana.org/assignments/message-headers/perm-headers.csv')
+	if r.status_code == 200:
+		with open(csv_path, 'wb') as file:
+			file.write(r.content)
+
+def parse_csv_file():
+	with open(csv_path, 'r', encoding='utf-8', newline='') as file:
+		reader = csv.reader(file, delimiter=',', quotechar='"')
+		for row in reader:
+			if row[0] == 'Header Field Name':
+				continue # Ignore header
+			if row[2] != 'http':
+				continue # Ignore other protocols (mail, netnews, etc.)
+			if not re.fullmatch(r'[A-Za-z0-9-]+', row[0]):
+				continue # Ignore names that cannot be used as identifiers (e.g. "*")
+			field = {
+				'name': row[0],
+				'slug': slugify(row[0]),
+				'reference': row[4],
+			}
+			field['comment'] = field['reference'].replace('][', '] [')
+			fields.append(field)
+
+# Must match `detail::HashHeaderName` in header.hpp (FNV-1a of lowercase name)
+def hash_name(name):
+	value = 0x811c9dc5
+	for c in name.lower().encode('ascii'):
+		value = ((value ^ c) * 0x01000193) & 0xffffffff
+	return value
+
+# Must match `detail::MixHeaderHash` in header.hpp (MurmurHash3 finalizer)
+def mix_hash(value):
+	value ^= value >> 16
+	value = (value * 0x85ebca6b) & 0xffffffff
+	value ^= value >> 13
+	value = (value * 0xc2b2ae35) & 0xffffffff
+	value ^= value >> 16
+	return value
+
+def hash_slot(name, displacements):
+	value = hash_name(name)
+	return mix_hash((value + displacements[value % hash_bucket_count]) & 0xffffffff) % hash_table_size
+
+# Hash and displace: names are grouped into buckets, and each bucket gets a
+# displacement that moves all of its names into free slots.
+def find_hash_displacements():
+	buckets = [[] for _ in range(hash_bucket_count)]
+	for field in fields:
+		buckets[hash_name(field['name']) % hash_bucket_count].append(field['name'])
+	displacements = [0] * hash_bucket_count
+	used = set()
+	for b in sorted(range(hash_bucket_count), key=lambda b: -len(buckets[b])):
+		if not buckets[b]:
+			continue
+		for d in range(0, 1 << 16):
+			displacements[b] = d
+			slots = set(hash_slot(name, displacements) for name in buckets[b])
+			if len(slots) == len(buckets[b]) and not slots & used:
+				used |= slots
+				break
+		else:
+			raise Exception('Could not find a perfect hash function')
+	return displacements
+
+def generate_cpp_code():
+	for i, field in enumerate(fields):
+		field['id'] = i + 1
+		field['line'] = 'k{} = {},'.format(field['slug'], field['id'])
+
+	max_width = 0
+	for field in fields:
+		width = len(field['line'])
+		if width > max_width:
+			max_width = width
+
+	lines = {'ids': [], 'names': [], 'hash': []}
+	for field in fields:
+		lines['ids'].append('{}  // {}'.format(field['line'].ljust(max_width), field['comment']))
+		lines['names'].append('"{}",'.format(field['name']))
+
+	displacements = find_hash_displacements()
+	table = [0] * hash_table_size
+	for field in fields:
+		table[hash_slot(field['name'], displacements)] = field['id']
+	lines['hash'].append('constexpr size_t kHeaderHashSize = {};'.format(hash_table_size))
+	lines['hash'].append('constexpr size_t kHeaderHashBuckets = {};'.format(hash_bucket_count))
+	lines['hash'].append('constexpr std::uint16_t kHeaderHashDisplacements[kHeaderHashBuckets] = {')
+	for i in range(0, hash_bucket_count, 16):
+		lines['hash'].append('  ' + ' '.join('{:>3},'.format(d) for d in displacements[i:i + 16]))
+	lines['hash'].append('};')
+	lines['hash'].append('constexpr header::id_t kHeaderHashTable[kHeaderHashSize] = {')
+	for i in range(0, hash_table_size, 16):
+		lines['hash'].append('  ' + ' '.join('{:>3},'.format(id) for id in table[i:i + 16]))
+	lines['hash'].append('};')
+
+	return lines
+
+def sub_between(source, id, lines):
+	pattern = r'( *)(// @{0}-begin)([\r\n]+).*\1(// @{0}-end)'.format(id)
+	pattern = re.compile(pattern, flags=re.DOTALL)
+	m = pattern.search(source)
+	if m:
+		code = m.group(1) + '{}{}'.format(m.group(3), m.group(1)).join(lines) + m.group(3)
+		code = '{1}{2}{3}{0}{1}{4}'.format(code, m.group(1), m.group(2), m.group(3), m.group(4))
+		return pattern.sub(lambda _: code, source)
+	return source
+
+def write_to_header(lines):
+	with open(header_path, 'r', encoding='utf-8') as file:
+		source = file.read()
+	with open(header_path, 'w', encoding='utf-8') as file:
+		source = sub_between(source, 'http-header-fields', lines['ids'])
+		source = sub_between(source, 'http-header-names', lines['names'])
+		source = sub_between(source, 'http-header-hash', lines['hash'])
+		file.write(source)
+
+
+if not os.path.exists(csv_path) or not os.path.getsize(csv_path):
+	get_csv_file()
+parse_csv_file()
+
+write_to_header(generate_cpp_code())